@@ -1824,6 +1824,7 @@ static GtkWidget *cairo_dock_build_main_ihm (const gchar *cConfFilePath)  // 'cC
 	gchar *cActiveModules;
 	if (g_pPrimaryContainer == NULL)
 	{
+		cairo_dock_flush_keyfile (cConfFilePath);  // the file is read directly.
 		GKeyFile* pKeyFile = g_key_file_new();
 		g_key_file_load_from_file (pKeyFile, cConfFilePath, 0, NULL);  // inutile de garder les commentaires ici.
 		cActiveModules = g_key_file_get_string (pKeyFile, "System", "modules", NULL);
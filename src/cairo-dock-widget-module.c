@@ -65,6 +65,7 @@ static gchar *_get_valid_module_conf_file (GldiModule *pModule)
 		// if no conf-file, copy the default one into the folder and take this one.
 		if (cInstanceFilePath == NULL)  // no conf file present yet.
 		{
+			cairo_dock_flush_keyfile (pModule->cConfFilePath);  // the file is copied as it is.
 			gboolean r = cairo_dock_copy_file (pModule->cConfFilePath, cUserDataDirPath);
 			if (r)  // copy ok
 				cInstanceFilePath = g_strdup_printf ("%s/%s", cUserDataDirPath, pModule->pVisitCard->cConfFileName);
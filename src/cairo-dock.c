@@ -71,6 +71,7 @@
 #include "cairo-dock-opengl.h"
 #include "cairo-dock-packages.h"
 #include "cairo-dock-utils.h"  // cairo_dock_launch_command
+#include "cairo-dock-trace.h"
 #include "cairo-dock-core.h"
 
 #include "cairo-dock-gui-manager.h"
@@ -165,6 +166,11 @@ static gboolean _cairo_dock_first_launch_setup (G_GNUC_UNUSED gpointer data)
 	cairo_dock_launch_command (CAIRO_DOCK_SHARE_DATA_DIR"/scripts/initial-setup.sh");
 	return FALSE;
 }
+static gboolean _write_trace (G_GNUC_UNUSED gpointer data)
+{
+	gldi_trace_stop ();  // only the startup is traced, so don't keep recording (and piling up events) once it's written.
+	return FALSE;
+}
 static void _cairo_dock_quit (G_GNUC_UNUSED int signal)
 {
 	gtk_main_quit ();
@@ -320,14 +326,6 @@ int main (int argc, char** argv)
 	
 	
 	// init lib
-	#if !defined (GLIB_VERSION_2_36) // no longer needed now... (>= 2.35)
-	g_type_init (); // should initialise threads too on new versions of GLIB (>= 2.24)
-	#endif
-	#if (GLIB_MAJOR_VERSION == 2 && GLIB_MINOR_VERSION < 24)
-	if (!g_thread_supported ())
-		g_thread_init (NULL);
-	#endif
-
 	dbus_g_thread_init (); // it's a wrapper: it will use dbus_threads_init_default ();
 	
 	gtk_init (&argc, &argv);
@@ -341,7 +339,7 @@ int main (int argc, char** argv)
 	
 	//\___________________ get app's options.
 	gboolean bSafeMode = FALSE, bMaintenance = FALSE, bNoSticky = FALSE, bCappuccino = FALSE, bPrintVersion = FALSE, bTesting = FALSE, bForceOpenGL = FALSE, bToggleIndirectRendering = FALSE, bKeepAbove = FALSE, bForceColors = FALSE, bAskBackend = FALSE, bMetacityWorkaround = FALSE;
-	gchar *cEnvironment = NULL, *cUserDefinedDataDir = NULL, *cVerbosity = 0, *cUserDefinedModuleDir = NULL, *cExcludeModule = NULL, *cThemeServerAdress = NULL;
+	gchar *cEnvironment = NULL, *cUserDefinedDataDir = NULL, *cVerbosity = 0, *cUserDefinedModuleDir = NULL, *cExcludeModule = NULL, *cThemeServerAdress = NULL, *cTraceFile = NULL;
 	int iDelay = 0;
 	GOptionEntry pOptionsTable[] =
 	{
@@ -413,6 +411,9 @@ int main (int argc, char** argv)
 		{"easter-eggs", 'E', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
 			&g_bEasterEggs,
 			_("For debugging purpose only. Some hidden and still unstable options will be activated."), NULL},
+		{"trace", 0, G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_FILENAME,
+			&cTraceFile,
+			_("For debugging purpose only. Record the startup into this file, in the Chrome trace format (it can also be set with the GLDI_TRACE environment variable)."), NULL},
 		{NULL, 0, 0, 0,
 			NULL,
 			NULL, NULL}
@@ -445,6 +446,12 @@ int main (int argc, char** argv)
 	if (bForceColors)
 		cd_log_force_use_color ();
 	
+	if (cTraceFile != NULL)
+	{
+		gldi_trace_start (cTraceFile);
+		g_free (cTraceFile);
+	}
+	
 	CairoDockDesktopEnv iDesktopEnv = CAIRO_DOCK_UNKNOWN_ENV;
 	if (cEnvironment != NULL)
 	{
@@ -915,6 +922,9 @@ int main (int argc, char** argv)
 	
 	if (! bTesting)
 		g_timeout_add_seconds (5, _cairo_dock_successful_launch, GINT_TO_POINTER (bFirstLaunch));
+	
+	if (g_bTraceEnabled)  // write the startup as soon as the dock is idle, and stop tracing there.
+		g_idle_add_full (G_PRIORITY_LOW, _write_trace, NULL, NULL);
 
 	// Start Mainloop
 	gtk_main ();
@@ -927,6 +937,8 @@ int main (int argc, char** argv)
 	signal (SIGHUP, NULL);
 
 	gldi_free_all ();
+	
+	gldi_trace_stop ();  // in case we quit before the dock was idle.
 
 	#if (LIBRSVG_MAJOR_VERSION == 2 && LIBRSVG_MINOR_VERSION < 36)
 	rsvg_term ();
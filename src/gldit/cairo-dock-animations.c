@@ -135,17 +135,166 @@ gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex)  // merci a Robrob
 }
 
 
+  ///////////////////////
+ /// ANIMATION CLOCK ///
+///////////////////////
+
+// all the animated containers are driven by a single ticker, running at the pace of the fastest one; the slower ones skip the ticks until their own interval has elapsed.
+typedef struct {
+	GldiContainer *pContainer;  // NULL once the animation has been stopped during a tick; it's freed at the end of the tick.
+	gint64 iLastAnimationTime;  // monotonic time of the previous iteration of the animation loop, in us.
+} GldiAnimationState;
+static GList *s_pAnimations = NULL;  // list of GldiAnimationState
+static guint s_iSidAnimationTicker = 0;
+static gint s_iTickerDeltaT = 0;
+static gboolean s_bInsideTicker = FALSE;
+static GldiFrameStats s_frameStats;
+
+static void _add_to_histogram (guint *pHistogram, gint64 iTime)
+{
+	int i = 0;
+	gint64 iLimit = 1000;  // 1ms
+	while (i < GLDI_FRAME_HISTOGRAM_SIZE - 1 && iTime >= iLimit)
+	{
+		i ++;
+		iLimit <<= 1;
+	}
+	pHistogram[i] ++;
+}
+
+static int _get_min_delta_t (void)
+{
+	int iMinDeltaT = 0;
+	GldiAnimationState *pState;
+	GList *a;
+	for (a = s_pAnimations; a != NULL; a = a->next)
+	{
+		pState = a->data;
+		if (pState->pContainer == NULL)
+			continue;
+		int iAnimationDeltaT = cairo_dock_get_animation_delta_t (pState->pContainer);
+		if (iMinDeltaT == 0 || iAnimationDeltaT < iMinDeltaT)
+			iMinDeltaT = iAnimationDeltaT;
+	}
+	return iMinDeltaT;
+}
+
+static gboolean _animation_ticker (G_GNUC_UNUSED gpointer data);
+static void _start_ticker (int iDeltaT)
+{
+	if (s_iSidAnimationTicker != 0)
+		g_source_remove (s_iSidAnimationTicker);
+	s_iTickerDeltaT = iDeltaT;
+	s_iSidAnimationTicker = g_timeout_add (iDeltaT, (GSourceFunc) _animation_ticker, NULL);
+}
+
+static gboolean _animation_ticker (G_GNUC_UNUSED gpointer data)
+{
+	gint64 iNow = g_get_monotonic_time ();
+	s_bInsideTicker = TRUE;
+	// during the tick, the states are not removed from the list (a container can be destroyed, or stop the animation of another one, inside its loop), and new ones are prepended, so they wait for the next tick.
+	GldiAnimationState *pState;
+	GldiContainer *pContainer;
+	GList *a, *next;
+	for (a = s_pAnimations; a != NULL; a = a->next)
+	{
+		pState = a->data;
+		pContainer = pState->pContainer;
+		if (pContainer == NULL)  // stopped by a previous loop.
+			continue;
+		
+		gint64 iElapsed = iNow - pState->iLastAnimationTime;
+		int iAnimationDeltaT = cairo_dock_get_animation_delta_t (pContainer);
+		if (iElapsed < (gint64)(iAnimationDeltaT - s_iTickerDeltaT / 2) * 1000)  // not yet time for this one, wait for the nearest tick.
+			continue;
+		pContainer->iAnimationElapsedT = iElapsed / 1000;
+		pState->iLastAnimationTime = iNow;
+		
+		s_frameStats.iNbFrames ++;
+		int iNbSteps = (pContainer->iAnimationElapsedT + iAnimationDeltaT / 2) / iAnimationDeltaT;
+		if (iNbSteps > 1)
+			s_frameStats.iNbMissedFrames += iNbSteps - 1;
+		
+		if (! pContainer->iface.animation_loop (pContainer)
+		&& pState->pContainer != NULL)  // else the animation has already been stopped inside the loop, maybe because the container has been destroyed.
+			cairo_dock_stop_animation (pContainer);
+	}
+	s_bInsideTicker = FALSE;
+	_add_to_histogram (s_frameStats.iUpdateTimeHistogram, g_get_monotonic_time () - iNow);
+	
+	// free the animations that have been stopped during the tick.
+	for (a = s_pAnimations; a != NULL; a = next)
+	{
+		next = a->next;
+		pState = a->data;
+		if (pState->pContainer == NULL)
+		{
+			g_free (pState);
+			s_pAnimations = g_list_delete_link (s_pAnimations, a);
+		}
+	}
+	
+	// stop the ticker or adapt its pace to the containers that are still animated.
+	int iMinDeltaT = _get_min_delta_t ();
+	if (iMinDeltaT == 0)
+	{
+		s_iSidAnimationTicker = 0;
+		s_iTickerDeltaT = 0;
+		return FALSE;
+	}
+	if (iMinDeltaT != s_iTickerDeltaT)
+	{
+		s_iTickerDeltaT = iMinDeltaT;
+		s_iSidAnimationTicker = g_timeout_add (iMinDeltaT, (GSourceFunc) _animation_ticker, NULL);
+		return FALSE;
+	}
+	return TRUE;
+}
+
 void cairo_dock_launch_animation (GldiContainer *pContainer)
 {
-	if (pContainer->iSidGLAnimation == 0 && pContainer->iface.animation_loop != NULL)
+	if (pContainer->pAnimationState == NULL && pContainer->iface.animation_loop != NULL)
 	{
 		int iAnimationDeltaT = cairo_dock_get_animation_delta_t (pContainer);
 		pContainer->bKeepSlowAnimation = TRUE;
+		pContainer->iAnimationElapsedT = iAnimationDeltaT;
 		
-		pContainer->iSidGLAnimation = g_timeout_add (iAnimationDeltaT, (GSourceFunc)pContainer->iface.animation_loop, pContainer);
+		GldiAnimationState *pState = g_new0 (GldiAnimationState, 1);  // the loop is driven by the ticker, it has no source of its own.
+		pState->pContainer = pContainer;
+		pState->iLastAnimationTime = g_get_monotonic_time ();
+		pContainer->pAnimationState = pState;
+		s_pAnimations = g_list_prepend (s_pAnimations, pState);
+		if (s_iSidAnimationTicker == 0 || (iAnimationDeltaT < s_iTickerDeltaT && ! s_bInsideTicker))  // if we're inside the ticker, it will adapt its pace by itself.
+			_start_ticker (iAnimationDeltaT);
 	}
 }
 
+void cairo_dock_stop_animation (GldiContainer *pContainer)
+{
+	GldiAnimationState *pState = pContainer->pAnimationState;
+	if (pState != NULL)
+	{
+		pContainer->pAnimationState = NULL;
+		pState->pContainer = NULL;  // the container may be destroyed right after, so the ticker must not use it any more.
+		if (! s_bInsideTicker)  // else the ticker is going through the list, it will free the state at the end of the tick.
+		{
+			s_pAnimations = g_list_remove (s_pAnimations, pState);
+			g_free (pState);
+		}
+	}  // the ticker will stop by itself if it has nothing more to animate.
+}
+
+void cairo_dock_get_frame_stats (GldiFrameStats *pStats)
+{
+	g_return_if_fail (pStats != NULL);
+	*pStats = s_frameStats;
+}
+
+void cairo_dock_record_render_time (gint64 iRenderTime)
+{
+	_add_to_histogram (s_frameStats.iRenderTimeHistogram, iRenderTime);
+}
+
 void cairo_dock_start_shrinking (CairoDock *pDock)
 {
 	if (! pDock->bIsShrinkingDown)  // on lance l'animation.
@@ -185,6 +334,7 @@ void cairo_dock_start_hiding (CairoDock *pDock)
 			cairo_dock_set_input_shape_hidden (pDock);
 			pDock->iInputState = CAIRO_DOCK_INPUT_HIDDEN;
 		}
+		gldi_dock_update_edge_trigger (pDock);  // watch the screen edge to reveal it.
 		
 		// init the animation
 		if (g_pHidingBackend != NULL && g_pHidingBackend->init)
@@ -224,6 +374,7 @@ void cairo_dock_start_showing (CairoDock *pDock)
 			
 			gldi_dialogs_replace_all ();
 		}
+		gldi_dock_update_edge_trigger (pDock);  // the edge is not watched anymore, so that it doesn't catch the pointer over the dock.
 		
 		// init the animation
 		if (g_pHidingBackend != NULL && g_pHidingBackend->init)
@@ -83,10 +83,25 @@ struct _CairoDockHidingEffect {
 	
 #define CAIRO_DOCK_MIN_SLOW_DELTA_T 90
 
+/// number of buckets of the frame time histograms; the bucket i counts the frames that took less than 2^i ms, the last one counts all the others.
+#define GLDI_FRAME_HISTOGRAM_SIZE 8
+
+/// Timing counters of the animation loops of all the containers.
+typedef struct {
+	/// number of iterations of the animation loops.
+	guint iNbFrames;
+	/// number of iterations that should have occurred but were skipped because the loops were late.
+	guint iNbMissedFrames;
+	/// histogram of the time spent in the animation loops, per tick of the animation clock.
+	guint iUpdateTimeHistogram[GLDI_FRAME_HISTOGRAM_SIZE];
+	/// histogram of the time spent to render the docks.
+	guint iRenderTimeHistogram[GLDI_FRAME_HISTOGRAM_SIZE];
+} GldiFrameStats;
+
 /** Say if a container is currently animated.
 *@param pContainer a Container
 */
-#define cairo_dock_container_is_animating(pContainer) (CAIRO_CONTAINER(pContainer)->iSidGLAnimation != 0)
+#define cairo_dock_container_is_animating(pContainer) (CAIRO_CONTAINER(pContainer)->pAnimationState != NULL)
 
 /** Say if it's usefull to launch an animation on a Dock (indeed, it's useless to launch it if it will be invisible).
 *@param pDock the Dock to animate.
@@ -110,11 +125,26 @@ void cairo_dock_pop_down (CairoDock *pDock);
 
 gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex);
 
-/** Launch the animation of a Container.
+/** Launch the animation of a Container. All the animated containers are driven by a single clock, so that they are updated together and in phase.
 *@param pContainer the container to animate.
 */
 void cairo_dock_launch_animation (GldiContainer *pContainer);
 
+/** Stop the animation of a Container. The animation loop is normally stopped when it returns FALSE, this is only needed to stop it from outside.
+*@param pContainer the container.
+*/
+void cairo_dock_stop_animation (GldiContainer *pContainer);
+
+/** Get the timing counters of the animation loops since the start.
+*@param pStats a structure to fill with the counters.
+*/
+void cairo_dock_get_frame_stats (GldiFrameStats *pStats);
+
+/** Add the time spent to render a container to the frame counters.
+*@param iRenderTime the time, in us.
+*/
+void cairo_dock_record_render_time (gint64 iRenderTime);
+
 void cairo_dock_start_shrinking (CairoDock *pDock);
 
 void cairo_dock_start_growing (CairoDock *pDock);
@@ -165,6 +195,14 @@ void cairo_dock_trigger_icon_removal_from_dock (Icon *pIcon);
 *@param pContainer the container.
 */
 #define cairo_dock_get_animation_delta_t(pContainer) CAIRO_CONTAINER(pContainer)->iAnimationDeltaT
+/** Get the real interval of time elapsed since the previous iteration of the fast loop (in ms). It's equal to the interval of the loop, unless some frames were late.
+*@param pContainer the container.
+*/
+#define cairo_dock_get_animation_elapsed_t(pContainer) CAIRO_CONTAINER(pContainer)->iAnimationElapsedT
+/** Get the number of steps of the fast loop that have elapsed since its previous iteration (1 if the frame is on time). Step-based animations can multiply their increment by it to stay on time.
+*@param pContainer the container.
+*/
+#define cairo_dock_get_animation_step_factor(pContainer) ((double) cairo_dock_get_animation_elapsed_t (pContainer) / cairo_dock_get_animation_delta_t (pContainer))
 /** Get the interval of time between 2 iterations of the slow loop (in ms).
 *@param pContainer the container.
 */
@@ -434,6 +434,7 @@ void cairo_dock_remove_all_icons_from_applet (GldiModuleInstance *pInstance)
 			cd_debug (" destroy sub-dock icons");
 			GList *icons = pIcon->pSubDock->icons;
 			pIcon->pSubDock->icons = NULL;
+			cairo_dock_invalidate_icons_layout (pIcon->pSubDock);
 			GList *ic;
 			Icon *icon;
 			for (ic = icons; ic != NULL; ic = ic->next)
@@ -264,10 +264,9 @@ void cairo_dock_set_renderer (CairoDock *pDock, const gchar *cRendererName)
 	pDock->container.iAnimationDeltaT = (g_bUseOpenGL && pDock->pRenderer->render_opengl != NULL ? myContainersParam.iGLAnimationDeltaT : myContainersParam.iCairoAnimationDeltaT);
 	if (pDock->container.iAnimationDeltaT == 0)
 		pDock->container.iAnimationDeltaT = 30;  // le main dock est cree avant meme qu'on ait recupere la valeur en conf. Lorsqu'une vue lui sera attribuee, la bonne valeur sera renseignee, en attendant on met un truc non nul.
-	if (iAnimationDeltaT != pDock->container.iAnimationDeltaT && pDock->container.iSidGLAnimation != 0)
+	if (iAnimationDeltaT != pDock->container.iAnimationDeltaT && cairo_dock_container_is_animating (pDock))
 	{
-		g_source_remove (pDock->container.iSidGLAnimation);
-		pDock->container.iSidGLAnimation = 0;
+		cairo_dock_stop_animation (CAIRO_CONTAINER (pDock));
 		cairo_dock_launch_animation (CAIRO_CONTAINER (pDock));
 	}
 	if (pDock->cRendererName != cRendererName)  // NULL ecrase le nom de l'ancienne vue.
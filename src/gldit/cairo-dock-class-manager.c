@@ -51,6 +51,8 @@
 #include "cairo-dock-keyfile-utilities.h"
 #include "cairo-dock-file-manager.h"
 #include "cairo-dock-windows-manager.h"
+#include "cairo-dock-task.h"
+#include "cairo-dock-trace.h"
 #include "cairo-dock-class-manager.h"
 
 extern CairoDock *g_pMainDock;
@@ -58,6 +60,18 @@ extern CairoDockDesktopEnv g_iDesktopEnv;
 
 static GHashTable *s_hClassTable = NULL;
 
+typedef struct {
+	GHashTable *pByName;  // lower-case file name -> path
+	GHashTable *pByClass;  // class guessed from StartupWMClass or Exec -> path
+	GList *pDirs;  // directories that have been indexed, by order of precedence; the top-level ones are listed even if they don't exist (yet).
+} CairoDockDesktopFilesIndex;
+static CairoDockDesktopFilesIndex *s_pDesktopFilesIndex = NULL;  // NULL until it has been built.
+static GldiTask *s_pIndexTask = NULL;
+static GList *s_pDesktopDirMonitors = NULL;
+
+static void _build_desktop_files_index (void);
+static void _free_desktop_files_index_and_monitors (void);
+
 
 static void cairo_dock_free_class_appli (CairoDockClassAppli *pClassAppli)
 {
@@ -115,6 +129,8 @@ void cairo_dock_initialize_class_manager (void)
 		NOTIFICATION_WINDOW_ACTIVATED,
 		(GldiNotificationFunc) _on_window_activated,
 		GLDI_RUN_AFTER, NULL);  // some applications don't open a new window, but rather take the focus; 
+	// index the .desktop files in the background
+	_build_desktop_files_index ();
 }
 
 
@@ -475,6 +491,7 @@ void cairo_dock_deinhibite_class (const gchar *cClass, Icon *pInhibitorIcon)
 		// we empty the sub-dock then destroy it, then re-insert the appli icons
 		GList *icons = pInhibitorIcon->pSubDock->icons;
 		pInhibitorIcon->pSubDock->icons = NULL;  // empty the sub-dock
+		cairo_dock_invalidate_icons_layout (pInhibitorIcon->pSubDock);
 		cairo_dock_destroy_class_subdock (cClass);  // destroy the sub-dock without destroying its icons
 		pInhibitorIcon->pSubDock = NULL;  // since the inhibitor can already be detached, the sub-dock can't find it
 
@@ -616,6 +633,8 @@ void cairo_dock_remove_all_applis_from_class_table (void)  // for the stop_appli
 void cairo_dock_reset_class_table (void)
 {
 	g_hash_table_remove_all (s_hClassTable);
+	
+	_free_desktop_files_index_and_monitors ();  // it will be built again when needed.
 }
 
 
@@ -1595,6 +1614,311 @@ const CairoDockImageBuffer *cairo_dock_get_class_image_buffer (const gchar *cCla
 }
 
 
+  ///////////////////////////
+ /// DESKTOP FILES INDEX ///
+///////////////////////////
+
+static void _index_desktop_file (CairoDockDesktopFilesIndex *pIndex, const gchar *cPath)
+{
+	// by file name; the directories are indexed by order of precedence, so the first one wins.
+	gchar *cBaseName = g_path_get_basename (cPath);
+	gchar *cName = g_ascii_strdown (cBaseName, -1);
+	g_free (cBaseName);
+	if (! g_hash_table_contains (pIndex->pByName, cName))
+		g_hash_table_insert (pIndex->pByName, cName, g_strdup (cPath));
+	else
+		g_free (cName);
+	
+	// by class, so that a window can be bound to a .desktop file that is named differently.
+	GKeyFile *pKeyFile = g_key_file_new ();
+	if (! g_key_file_load_from_file (pKeyFile, cPath, G_KEY_FILE_NONE, NULL))
+	{
+		g_key_file_free (pKeyFile);
+		return;
+	}
+	gchar *cStartupWMClass = g_key_file_get_string (pKeyFile, "Desktop Entry", "StartupWMClass", NULL);
+	gchar *cCommand = g_key_file_get_string (pKeyFile, "Desktop Entry", "Exec", NULL);
+	g_key_file_free (pKeyFile);
+	
+	gchar *cClass;
+	if (cStartupWMClass != NULL && *cStartupWMClass != '\0')
+	{
+		cClass = cairo_dock_guess_class (NULL, cStartupWMClass);
+		if (cClass != NULL && ! g_hash_table_contains (pIndex->pByClass, cClass))
+			g_hash_table_insert (pIndex->pByClass, cClass, g_strdup (cPath));
+		else
+			g_free (cClass);
+	}
+	if (cCommand != NULL)
+	{
+		cClass = cairo_dock_guess_class (cCommand, NULL);
+		if (cClass != NULL && ! g_hash_table_contains (pIndex->pByClass, cClass))
+			g_hash_table_insert (pIndex->pByClass, cClass, g_strdup (cPath));
+		else
+			g_free (cClass);
+	}
+	g_free (cStartupWMClass);
+	g_free (cCommand);
+}
+
+static gboolean _is_desktop_file_path (G_GNUC_UNUSED gchar *cKey, gchar *cPath, const gchar *cRemovedPath)
+{
+	return (strcmp (cPath, cRemovedPath) == 0);
+}
+static void _unindex_desktop_file (CairoDockDesktopFilesIndex *pIndex, const gchar *cPath)
+{
+	g_hash_table_foreach_remove (pIndex->pByName, (GHRFunc) _is_desktop_file_path, (gpointer) cPath);
+	g_hash_table_foreach_remove (pIndex->pByClass, (GHRFunc) _is_desktop_file_path, (gpointer) cPath);
+}
+
+// re-resolve a file name after a file with this name has appeared or disappeared somewhere: forget all the files with this name, and index again the ones that still exist, by order of precedence.
+static void _reindex_desktop_file (CairoDockDesktopFilesIndex *pIndex, const gchar *cPath)
+{
+	gchar *cBaseName = g_path_get_basename (cPath);
+	GList *pCandidates = NULL, *d;
+	gchar *cCandidate;
+	for (d = pIndex->pDirs; d != NULL; d = d->next)
+	{
+		cCandidate = g_strdup_printf ("%s/%s", (gchar*)d->data, cBaseName);
+		_unindex_desktop_file (pIndex, cCandidate);
+		pCandidates = g_list_append (pCandidates, cCandidate);
+	}
+	_unindex_desktop_file (pIndex, cPath);  // in case it's not in an indexed folder.
+	
+	for (d = pCandidates; d != NULL; d = d->next)
+	{
+		cCandidate = d->data;
+		if (g_file_test (cCandidate, G_FILE_TEST_IS_REGULAR))
+			_index_desktop_file (pIndex, cCandidate);
+	}
+	g_list_free_full (pCandidates, g_free);
+	g_free (cBaseName);
+}
+
+static void _index_desktop_dir (CairoDockDesktopFilesIndex *pIndex, const gchar *cDirPath, int iDepth)
+{
+	if (iDepth == 0)  // keep its rank even if it doesn't exist yet, it will be watched until it's created.
+		pIndex->pDirs = g_list_append (pIndex->pDirs, g_strdup (cDirPath));
+	GDir *dir = g_dir_open (cDirPath, 0, NULL);
+	if (dir == NULL)
+		return;
+	if (iDepth != 0)
+		pIndex->pDirs = g_list_append (pIndex->pDirs, g_strdup (cDirPath));
+	
+	const gchar *cFileName;
+	gchar *cPath;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		cPath = g_strdup_printf ("%s/%s", cDirPath, cFileName);
+		if (g_str_has_suffix (cFileName, ".desktop"))
+			_index_desktop_file (pIndex, cPath);
+		else if (iDepth < 3 && g_file_test (cPath, G_FILE_TEST_IS_DIR))  // sub-folders, like 'kde4' or 'xfce4'.
+			_index_desktop_dir (pIndex, cPath, iDepth + 1);
+		g_free (cPath);
+	}
+	g_dir_close (dir);
+}
+
+static void _free_desktop_files_index (CairoDockDesktopFilesIndex *pIndex)
+{
+	if (pIndex == NULL)
+		return;
+	if (pIndex->pByName != NULL)
+		g_hash_table_destroy (pIndex->pByName);
+	if (pIndex->pByClass != NULL)
+		g_hash_table_destroy (pIndex->pByClass);
+	g_list_free_full (pIndex->pDirs, g_free);
+	g_free (pIndex);
+}
+
+static void _scan_desktop_dirs (CairoDockDesktopFilesIndex *pIndex)  // threaded
+{
+	pIndex->pByName = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	pIndex->pByClass = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	
+	// XDG order: the user's folder first, then the system folders by order of preference.
+	gchar *cDirPath = g_strdup_printf ("%s/applications", g_get_user_data_dir ());
+	_index_desktop_dir (pIndex, cDirPath, 0);
+	g_free (cDirPath);
+	const gchar * const *pDataDirs = g_get_system_data_dirs ();
+	int i;
+	for (i = 0; pDataDirs[i] != NULL; i ++)
+	{
+		cDirPath = g_strdup_printf ("%s/applications", pDataDirs[i]);
+		_index_desktop_dir (pIndex, cDirPath, 0);
+		g_free (cDirPath);
+	}
+}
+
+static void _on_desktop_dir_changed (G_GNUC_UNUSED GFileMonitor *pMonitor, GFile *pFile, GFile *pOtherFile, GFileMonitorEvent iEventType, G_GNUC_UNUSED gpointer data)
+{
+	g_return_if_fail (s_pDesktopFilesIndex != NULL);
+	gchar *cPath = g_file_get_path (pFile);
+	if (cPath == NULL || ! g_str_has_suffix (cPath, ".desktop"))
+	{
+		g_free (cPath);
+		return;
+	}
+	switch (iEventType)
+	{
+		case G_FILE_MONITOR_EVENT_DELETED:
+		case G_FILE_MONITOR_EVENT_MOVED_OUT:
+		case G_FILE_MONITOR_EVENT_CREATED:
+		case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+		case G_FILE_MONITOR_EVENT_MOVED_IN:
+			cd_debug ("%s added, modified or removed", cPath);
+			_reindex_desktop_file (s_pDesktopFilesIndex, cPath);  // a file with the same name in another folder may win or lose.
+		break;
+		case G_FILE_MONITOR_EVENT_RENAMED:
+			_reindex_desktop_file (s_pDesktopFilesIndex, cPath);
+			if (pOtherFile != NULL)
+			{
+				gchar *cNewPath = g_file_get_path (pOtherFile);
+				if (cNewPath != NULL && g_str_has_suffix (cNewPath, ".desktop"))
+					_reindex_desktop_file (s_pDesktopFilesIndex, cNewPath);
+				g_free (cNewPath);
+			}
+		break;
+		default:
+			g_free (cPath);
+		return;
+	}
+	g_free (cPath);
+	
+	// an application comes with its icon, which may have been searched in vain before.
+	cairo_dock_forget_missing_icons ();
+}
+
+static void _monitor_desktop_dir (const gchar *cDirPath)
+{
+	GFile *pDir = g_file_new_for_path (cDirPath);
+	GFileMonitor *pMonitor = g_file_monitor_directory (pDir, G_FILE_MONITOR_WATCH_MOVES, NULL, NULL);
+	g_object_unref (pDir);
+	if (pMonitor == NULL)
+		return;
+	g_signal_connect (pMonitor, "changed", G_CALLBACK (_on_desktop_dir_changed), NULL);
+	s_pDesktopDirMonitors = g_list_prepend (s_pDesktopDirMonitors, pMonitor);
+}
+
+static void _on_desktop_parent_dir_changed (GFileMonitor *pMonitor, GFile *pFile, G_GNUC_UNUSED GFile *pOtherFile, GFileMonitorEvent iEventType, const gchar *cDirPath)
+{
+	g_return_if_fail (s_pDesktopFilesIndex != NULL);
+	if (iEventType != G_FILE_MONITOR_EVENT_CREATED && iEventType != G_FILE_MONITOR_EVENT_MOVED_IN)
+		return;
+	gchar *cPath = g_file_get_path (pFile);
+	gboolean bIsOurDir = (cPath != NULL && strcmp (cPath, cDirPath) == 0);
+	g_free (cPath);
+	if (! bIsOurDir)
+		return;
+	cd_debug ("%s has been created", cDirPath);
+	
+	// watch it from now on; this monitor is not needed any more, it will be freed with the others.
+	g_file_monitor_cancel (pMonitor);
+	_monitor_desktop_dir (cDirPath);
+	
+	// index the files it may already contain; it keeps its rank in the index.
+	GDir *dir = g_dir_open (cDirPath, 0, NULL);
+	if (dir == NULL)
+		return;
+	const gchar *cFileName;
+	gchar *cFilePath;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		if (! g_str_has_suffix (cFileName, ".desktop"))
+			continue;
+		cFilePath = g_strdup_printf ("%s/%s", cDirPath, cFileName);
+		_reindex_desktop_file (s_pDesktopFilesIndex, cFilePath);
+		g_free (cFilePath);
+	}
+	g_dir_close (dir);
+	cairo_dock_forget_missing_icons ();
+}
+
+static void _monitor_missing_desktop_dir (const gchar *cDirPath)
+{
+	// watch its parent until it's created (typically ~/.local/share/applications, which is created with the first user's launcher).
+	gchar *cParentPath = g_path_get_dirname (cDirPath);
+	GFile *pParentDir = g_file_new_for_path (cParentPath);
+	GFileMonitor *pMonitor = g_file_monitor_directory (pParentDir, G_FILE_MONITOR_NONE, NULL, NULL);
+	g_object_unref (pParentDir);
+	g_free (cParentPath);
+	if (pMonitor == NULL)
+		return;
+	g_signal_connect_data (pMonitor, "changed", G_CALLBACK (_on_desktop_parent_dir_changed), g_strdup (cDirPath), (GClosureNotify) g_free, 0);
+	s_pDesktopDirMonitors = g_list_prepend (s_pDesktopDirMonitors, pMonitor);
+}
+
+static gboolean _on_desktop_files_indexed (CairoDockDesktopFilesIndex *pIndex)
+{
+	// take the index
+	CairoDockDesktopFilesIndex *pNewIndex = g_new0 (CairoDockDesktopFilesIndex, 1);
+	*pNewIndex = *pIndex;
+	memset (pIndex, 0, sizeof (CairoDockDesktopFilesIndex));
+	_free_desktop_files_index (s_pDesktopFilesIndex);
+	s_pDesktopFilesIndex = pNewIndex;
+	cd_debug ("%d .desktop files indexed", g_hash_table_size (pNewIndex->pByName));
+	
+	// keep it up-to-date; the monitors are created here, so that they are dispatched in the main loop.
+	GList *d;
+	for (d = pNewIndex->pDirs; d != NULL; d = d->next)
+	{
+		if (g_file_test (d->data, G_FILE_TEST_IS_DIR))
+			_monitor_desktop_dir (d->data);
+		else
+			_monitor_missing_desktop_dir (d->data);
+	}
+	
+	gldi_task_discard (s_pIndexTask);
+	s_pIndexTask = NULL;
+	return FALSE;
+}
+
+static void _free_desktop_files_index_and_monitors (void)
+{
+	if (s_pIndexTask != NULL)
+	{
+		gldi_task_discard (s_pIndexTask);
+		s_pIndexTask = NULL;
+	}
+	GList *m;
+	for (m = s_pDesktopDirMonitors; m != NULL; m = m->next)
+	{
+		g_file_monitor_cancel (m->data);
+		g_object_unref (m->data);
+	}
+	g_list_free (s_pDesktopDirMonitors);
+	s_pDesktopDirMonitors = NULL;
+	_free_desktop_files_index (s_pDesktopFilesIndex);
+	s_pDesktopFilesIndex = NULL;
+}
+
+static void _build_desktop_files_index (void)
+{
+	if (s_pDesktopFilesIndex != NULL || s_pIndexTask != NULL)  // already built or being built.
+		return;
+	CairoDockDesktopFilesIndex *pIndex = g_new0 (CairoDockDesktopFilesIndex, 1);
+	s_pIndexTask = gldi_task_new_full (0,
+		(GldiGetDataAsyncFunc) _scan_desktop_dirs,
+		(GldiUpdateSyncFunc) _on_desktop_files_indexed,
+		(GFreeFunc) _free_desktop_files_index,
+		pIndex);
+	gldi_task_launch (s_pIndexTask);
+}
+
+static gchar *_lookup_desktop_file_in_index (const gchar *cDesktopFile, const gchar *cFileName)
+{
+	gchar *cName = g_ascii_strdown (cFileName, -1);
+	const gchar *cPath = g_hash_table_lookup (s_pDesktopFilesIndex->pByName, cName);
+	g_free (cName);
+	if (cPath == NULL && *cDesktopFile != '/' && ! g_str_has_suffix (cDesktopFile, ".desktop"))  // we were given a class, look for a .desktop file that defines this class.
+	{
+		cName = g_ascii_strdown (cDesktopFile, -1);
+		cPath = g_hash_table_lookup (s_pDesktopFilesIndex->pByClass, cName);
+		g_free (cName);
+	}
+	return g_strdup (cPath);
+}
+
 static gchar *_search_desktop_file (const gchar *cDesktopFile)  // file, path or even class
 {
 	if (cDesktopFile == NULL)
@@ -1611,6 +1935,15 @@ static gchar *_search_desktop_file (const gchar *cDesktopFile)  // file, path or
 		cDesktopFileName = g_strdup_printf ("%s.desktop", cDesktopFile);
 
 	const gchar *cFileName = (cDesktopFileName ? cDesktopFileName : cDesktopFile);
+	if (s_pDesktopFilesIndex != NULL)  // the index is ready, no need to probe the disk.
+	{
+		gchar *cResult = _lookup_desktop_file_in_index (cDesktopFile, cFileName);
+		g_free (cDesktopFileName);
+		return cResult;
+	}
+	_build_desktop_files_index ();  // in case it has been freed by a reset; does nothing if it's being built.
+	
+	// else look in the usual places.
 	gboolean bFound = TRUE;
 	GString *sDesktopFilePath = g_string_new ("");
 	g_string_printf (sDesktopFilePath, "/usr/share/applications/%s", cFileName);
@@ -1864,7 +2197,9 @@ gchar *cairo_dock_register_class_full (const gchar *cDesktopFile, const gchar *c
 	}
 
 	//\__________________ search the desktop file's path.
+	gldi_trace_begin_with_arg ("search desktop file", "desktop-file", cDesktopFile?cDesktopFile:cClass);
 	gchar *cDesktopFilePath = _search_desktop_file (cDesktopFile?cDesktopFile:cClass);
+	gldi_trace_end ("search desktop file", "desktop-file");
 	if (cDesktopFilePath == NULL)  // couldn't find the .desktop
 	{
 		if (cClass != NULL)  // make a class anyway to store the few info we have.
@@ -2035,6 +2370,9 @@ void gldi_class_startup_notify (Icon *pIcon)
 
 	// mark the class as launching and set a timeout
 	pClassAppli->bIsLaunching = TRUE;
+	pClassAppli->iStartupSerial ++;
+	if (pClassAppli->iStartupSerial == 0)  // 0 means "not launching".
+		pClassAppli->iStartupSerial = 1;
 	if (pClassAppli->iSidOpeningTimeout == 0)
 		pClassAppli->iSidOpeningTimeout = g_timeout_add_seconds (15,  // 15 seconds, for applications that take a really long time to start
 		(GSourceFunc) _stop_opening_timeout, g_strdup (cClass));  /// TODO: there is a memory leak here...
@@ -2082,6 +2420,18 @@ void gldi_class_startup_notify_end (const gchar *cClass)
 	}
 }
 
+guint gldi_class_get_startup_serial (const gchar *cClass)
+{
+	CairoDockClassAppli *pClassAppli = _cairo_dock_lookup_class_appli (cClass);
+	return (pClassAppli != NULL && pClassAppli->bIsLaunching ? pClassAppli->iStartupSerial : 0);
+}
+
+void gldi_class_startup_notify_end_serial (const gchar *cClass, guint iSerial)
+{
+	if (iSerial != 0 && gldi_class_get_startup_serial (cClass) == iSerial)  // else it has ended already, and the class may have been launched again since.
+		gldi_class_startup_notify_end (cClass);
+}
+
 gboolean gldi_class_is_starting (const gchar *cClass)
 {
 	CairoDockClassAppli *pClassAppli = _cairo_dock_lookup_class_appli (cClass);
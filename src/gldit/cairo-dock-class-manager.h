@@ -53,6 +53,7 @@ struct _CairoDockClassAppli {
 	guint iSidOpeningTimeout;  // timeout to stop the launching, if not stopped by the application before
 	gboolean bIsLaunching;  // flag to mark a class as being launched
 	gboolean bHasStartupNotify;  // TRUE if the application sends a "remove" event when its launch is complete (not used yet)
+	guint iStartupSerial;  // incremented on each new launching, to recognize it later
 };
 
 /*
@@ -232,6 +233,18 @@ void gldi_class_startup_notify (Icon *pIcon);
 
 void gldi_class_startup_notify_end (const gchar *cClass);
 
+/** Get the serial of the current launching of a class, to be able to end it later without ending a more recent one (see \ref gldi_class_startup_notify_end_serial).
+*@param cClass the class
+*@return the serial, or 0 if the class is not being launched.
+*/
+guint gldi_class_get_startup_serial (const gchar *cClass);
+
+/** Same as \ref gldi_class_startup_notify_end, but only if the class is still being launched by the given launching.
+*@param cClass the class
+*@param iSerial the serial of the launching, as returned by \ref gldi_class_get_startup_serial
+*/
+void gldi_class_startup_notify_end_serial (const gchar *cClass, guint iSerial);
+
 gboolean gldi_class_is_starting (const gchar *cClass);
 
 G_END_DECLS
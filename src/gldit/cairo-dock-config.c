@@ -49,6 +49,7 @@ static char DES_crypt_key[64] =
 #include "cairo-dock-file-manager.h"  // cairo_dock_get_file_size
 #include "cairo-dock-user-icon-manager.h"  // gldi_user_icons_new_from_directory
 #include "cairo-dock-core.h"  // gldi_free_all
+#include "cairo-dock-trace.h"
 #include "cairo-dock-config.h"
 
 gboolean g_bEasterEggs = FALSE;
@@ -448,11 +449,13 @@ void cairo_dock_load_current_theme (void)
 {
 	cd_message ("%s ()", __func__);
 	s_bLoading = TRUE;
+	gldi_trace_begin ("load theme", "startup");
 	
 	//\___________________ Free everything.
 	gldi_free_all ();  // do nothing if there is nothing to unload.
 		
 	//\___________________ Get all managers config.
+	gldi_trace_begin ("managers", "startup");
 	gldi_managers_get_config (g_cConfFile, GLDI_VERSION);  /// en fait, CAIRO_DOCK_VERSION ...
 	
 	//\___________________ Create the primary container (needed to have a cairo/opengl context).
@@ -461,18 +464,26 @@ void cairo_dock_load_current_theme (void)
 	//\___________________ Load all managers data.
 	gldi_managers_load ();
 	gldi_modules_activate_from_list (NULL);  // load auto-loaded modules before loading anything (views, etc)
+	gldi_trace_end ("managers", "startup");
 	
 	//\___________________ Now load the user icons (launchers, etc).
+	gldi_trace_begin ("launchers", "startup");
 	gldi_user_icons_new_from_directory (g_cCurrentLaunchersPath);
 	
 	cairo_dock_hide_show_launchers_on_other_desktops ();
+	gldi_trace_end ("launchers", "startup");
 	
 	//\___________________ Load the applets.
+	gldi_trace_begin ("applets", "startup");
 	gldi_modules_activate_from_list (myModulesParam.cActiveModuleList);
+	gldi_trace_end ("applets", "startup");
 	
 	//\___________________ Start the applications manager (will load the icons if the option is enabled).
+	gldi_trace_begin ("applications", "startup");
 	cairo_dock_start_applications_manager (pMainDock);
+	gldi_trace_end ("applications", "startup");
 	
+	gldi_trace_end ("load theme", "startup");
 	s_bLoading = FALSE;
 }
 
@@ -144,10 +144,7 @@ static gboolean _cairo_default_container_animation_loop (GldiContainer *pContain
 	gldi_object_notify (pContainer, NOTIFICATION_UPDATE, pContainer, &bContinue);
 	
 	if (! bContinue && ! pContainer->bKeepSlowAnimation)
-	{
-		pContainer->iSidGLAnimation = 0;
-		return FALSE;
-	}
+		return FALSE;  // the animation clock will stop the loop.
 	else
 		return TRUE;
 }
@@ -586,11 +583,7 @@ static void reset_object (GldiObject *obj)
 	pContainer->pWidget = NULL;
 	
 	// stop the animation loop
-	if (pContainer->iSidGLAnimation != 0)
-	{
-		g_source_remove (pContainer->iSidGLAnimation);
-		pContainer->iSidGLAnimation = 0;
-	}
+	cairo_dock_stop_animation (pContainer);
 	
 	if (g_pPrimaryContainer == pContainer)
 		g_pPrimaryContainer = NULL;
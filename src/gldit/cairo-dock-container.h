@@ -131,7 +131,7 @@ struct _GldiContainer {
 	CairoDockTypeHorizontality bIsHorizontal;
 	/// TRUE if the container is oriented upwards, FALSE if downwards.
 	gboolean bDirectionUp;
-	/// Source ID of the animation loop.
+	/// not used any more, always 0: the animation loops are driven by a shared clock (see \ref cairo_dock_container_is_animating).
 	guint iSidGLAnimation;
 	/// interval of time between 2 animation steps.
 	gint iAnimationDeltaT;
@@ -162,7 +162,12 @@ struct _GldiContainer {
 	GldiContainerInterface iface;
 	
 	gboolean bIgnoreNextReleaseEvent;
-	gpointer reserved[4];
+	// the fields below replace 'gpointer reserved[4]', so they must stay pointer-sized.
+	/// real interval of time elapsed since the previous iteration of the animation loop, in ms.
+	glong iAnimationElapsedT;
+	gpointer pAnimationState;  // state of the animation loop, private to cairo-dock-animations.c; NULL when the container is not animated.
+	gpointer pDamageHistory;  // areas redrawn in the previous frames, to redraw only what has changed (see gldi_gl_container_begin_draw_full).
+	gpointer reserved[1];
 };
 
 
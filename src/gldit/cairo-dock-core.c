@@ -52,10 +52,12 @@
 #include "cairo-dock-hiding-effect.h"
 #include "cairo-dock-icon-container.h"
 #include "cairo-dock-utils.h"  // cairo_dock_get_version_from_string
+#include "cairo-dock-keyfile-utilities.h"  // cairo_dock_flush_all_keyfiles
 #include "cairo-dock-file-manager.h"
 #include "cairo-dock-overlay.h"
 #include "cairo-dock-log.h"
 #include "cairo-dock-opengl.h"
+#include "cairo-dock-trace.h"
 #include "cairo-dock-core.h"
 
 extern GldiContainer *g_pPrimaryContainer;
@@ -101,6 +103,12 @@ void gldi_init (GldiRenderingMethod iRendering)
 	
 	cairo_dock_get_version_from_string (GLDI_VERSION, &g_iMajorVersion, &g_iMinorVersion, &g_iMicroVersion);
 	
+	// start the tracer if asked (the application may have started it already).
+	const gchar *cTraceFile = g_getenv ("GLDI_TRACE");
+	if (cTraceFile != NULL && *cTraceFile != '\0')
+		gldi_trace_start (cTraceFile);
+	gldi_trace_begin ("gldi_init", "startup");
+	
 	// register all managers
 	_gldi_register_core_managers ();
 	
@@ -120,6 +128,7 @@ void gldi_init (GldiRenderingMethod iRendering)
 	{
 		gldi_gl_backend_init (iRendering == GLDI_OPENGL);  // TRUE <=> force.
 	}
+	gldi_trace_end ("gldi_init", "startup");
 }
 
 void gldi_free_all (void)
@@ -134,4 +143,7 @@ void gldi_free_all (void)
 	gldi_modules_deactivate_all ();  /// TODO: try to do that in the unload of the manager...
 	
 	cairo_dock_reset_docks_table ();  // detruit tous les docks, vide la table, et met le main-dock a NULL.
+	
+	// write the conf files that are waiting to be updated.
+	cairo_dock_flush_all_keyfiles ();
 }
@@ -49,6 +49,7 @@
 #include "cairo-dock-launcher-manager.h"
 #include "cairo-dock-menu.h"
 #include "cairo-dock-desklet-manager.h"
+#include "cairo-dock-timer.h"
 #include "cairo-dock-desklet-factory.h"
 
 extern gboolean g_bUseOpenGL;
@@ -249,9 +250,9 @@ static gboolean on_configure_desklet (G_GNUC_UNUSED GtkWidget* pWidget,
 		
 		if (pDesklet->iSidWriteSize != 0)
 		{
-			g_source_remove (pDesklet->iSidWriteSize);
+			gldi_timer_remove (pDesklet->iSidWriteSize);
 		}
-		pDesklet->iSidWriteSize = g_timeout_add (CD_WRITE_DELAY, (GSourceFunc) _cairo_dock_write_desklet_size, (gpointer) pDesklet);
+		pDesklet->iSidWriteSize = gldi_timer_add (CD_WRITE_DELAY, (GSourceFunc) _cairo_dock_write_desklet_size, (gpointer) pDesklet);
 	}
 	
 	int x = pEvent->x, y = pEvent->y;
@@ -697,10 +698,7 @@ static gboolean _cairo_desklet_animation_loop (GldiContainer *pContainer)
 	gldi_object_notify (pDesklet, NOTIFICATION_UPDATE, pDesklet, &bContinue);
 	
 	if (! bContinue && ! pContainer->bKeepSlowAnimation)
-	{
-		pContainer->iSidGLAnimation = 0;
-		return FALSE;
-	}
+		return FALSE;  // the animation clock will stop the loop.
 	else
 		return TRUE;
 }
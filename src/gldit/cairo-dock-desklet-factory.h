@@ -172,7 +172,7 @@ struct _CairoDesklet {
 	
 	//\________________ internal
 	gint iSidWritePosition;  // un timer pour retarder l'ecriture dans le fichier lors des deplacements.
-	gint iSidWriteSize;  // un timer pour retarder l'ecriture dans le fichier lors des redimensionnements.
+	gint iSidWriteSize;  // un timer pour retarder l'ecriture dans le fichier lors des redimensionnements; c'est un timer de cairo-dock-timer.h, pas une GSource (gldi_timer_remove).
 	gint iDesiredWidth, iDesiredHeight;  // taille a atteindre (fixee par l'utilisateur dans le.conf)
 	gint iKnownWidth, iKnownHeight;  // taille connue par l'applet associee.
 	gboolean bSpaceReserved;  // l'espace est actuellement reserve.
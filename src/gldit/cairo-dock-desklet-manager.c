@@ -50,6 +50,7 @@
 #include "cairo-dock-opengl.h"
 #include "cairo-dock-opengl-path.h"
 #define _MANAGER_DEF_
+#include "cairo-dock-timer.h"
 #include "cairo-dock-desklet-manager.h"
 
 // public (manager, config, data)
@@ -997,7 +998,7 @@ static void reset_object (GldiObject *obj)
 	
 	// stop timers
 	if (pDesklet->iSidWriteSize != 0)
-		g_source_remove (pDesklet->iSidWriteSize);
+		gldi_timer_remove (pDesklet->iSidWriteSize);
 	if (pDesklet->iSidWritePosition != 0)
 		g_source_remove (pDesklet->iSidWritePosition);
 	
@@ -224,6 +224,24 @@ gboolean gldi_desktop_grab_shortkey (guint keycode, guint modifiers, gboolean gr
 	return FALSE;
 }
 
+gboolean gldi_desktop_can_watch_screen_edges (void)
+{
+	return (s_backend.add_screen_edge_trigger != NULL);
+}
+
+gpointer gldi_desktop_add_screen_edge_trigger (int x, int y, int w, int h, GldiContainer *pContainer, GldiScreenEdgeFunc pCallback, gpointer data)
+{
+	if (s_backend.add_screen_edge_trigger)
+		return s_backend.add_screen_edge_trigger (x, y, w, h, pContainer, pCallback, data);
+	return NULL;
+}
+
+void gldi_desktop_remove_screen_edge_trigger (gpointer pTrigger)
+{
+	if (pTrigger != NULL && s_backend.remove_screen_edge_trigger)
+		s_backend.remove_screen_edge_trigger (pTrigger);
+}
+
   //////////////////
  /// DESKTOP BG ///
 //////////////////
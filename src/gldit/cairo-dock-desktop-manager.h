@@ -70,6 +70,9 @@ struct _GldiDesktopGeometry {
 	int iCurrentViewportX, iCurrentViewportY;
 	};
 
+/// Function called when the pointer enters, moves inside, or leaves a screen edge trigger (see \ref gldi_desktop_add_screen_edge_trigger); x and y are the position of the pointer on the screen.
+typedef void (*GldiScreenEdgeFunc) (gboolean bInside, int x, int y, gpointer data);
+
 /// Definition of the Desktop Manager backend.
 struct _GldiDesktopManagerBackend {
 	gboolean (*present_class) (const gchar *cClass);
@@ -87,6 +90,8 @@ struct _GldiDesktopManagerBackend {
 	void (*refresh) (void);
 	void (*notify_startup) (const gchar *cClass);
 	gboolean (*grab_shortkey) (guint keycode, guint modifiers, gboolean grab);
+	gpointer (*add_screen_edge_trigger) (int x, int y, int w, int h, GldiContainer *pContainer, GldiScreenEdgeFunc pCallback, gpointer data);
+	void (*remove_screen_edge_trigger) (gpointer pTrigger);
 	};
 
 /// Definition of a Desktop Background Buffer. It has a reference count so that it can be shared across all the lib.
@@ -154,6 +159,28 @@ void gldi_desktop_notify_startup (const gchar *cClass);
 
 gboolean gldi_desktop_grab_shortkey (guint keycode, guint modifiers, gboolean grab);
 
+/** Say if the desktop can tell when the pointer reaches an area of the screen, without having to poll its position.
+*@return TRUE if screen edge triggers can be added.
+*/
+gboolean gldi_desktop_can_watch_screen_edges (void);
+
+/** Watch an area of the screen (usually a line along a screen edge), and be notified when the pointer enters, moves inside, or leaves it. The area may catch the clicks made on it, so it should be removed as soon as it is not needed anymore.
+*@param x horizontal position of the area on the screen.
+*@param y vertical position of the area on the screen.
+*@param w width of the area.
+*@param h height of the area.
+*@param pContainer the container that the area reveals, or NULL; the area is kept just above it, so that it doesn't cover the windows that are above the container.
+*@param pCallback function called on the events.
+*@param data data passed to the function.
+*@return the trigger, or NULL if the desktop doesn't support it.
+*/
+gpointer gldi_desktop_add_screen_edge_trigger (int x, int y, int w, int h, GldiContainer *pContainer, GldiScreenEdgeFunc pCallback, gpointer data);
+
+/** Stop watching an area of the screen. It can be called from the trigger's callback.
+*@param pTrigger the trigger, as returned by \ref gldi_desktop_add_screen_edge_trigger.
+*/
+void gldi_desktop_remove_screen_edge_trigger (gpointer pTrigger);
+
   ////////////////////
  // Desktop access //
 ////////////////////
@@ -356,10 +356,7 @@ static gboolean _animation_loop (GldiContainer *pContainer)
 	
 	cairo_dock_redraw_container (CAIRO_CONTAINER (pDialog));
 	if (! bContinue && ! pContainer->bKeepSlowAnimation)
-	{
-		pContainer->iSidGLAnimation = 0;
-		return FALSE;
-	}
+		return FALSE;  // the animation clock will stop the loop.
 	else
 		return TRUE;
 }
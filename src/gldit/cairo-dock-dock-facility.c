@@ -38,6 +38,7 @@
 #include "cairo-dock-opengl.h"  // gldi_gl_container_begin_draw
 
 extern CairoDockGLConfig g_openglConfig;
+#include "cairo-dock-timer.h"
 #include "cairo-dock-dock-facility.h"
 
 extern gboolean g_bUseOpenGL;  // for cairo_dock_make_preview()
@@ -149,6 +150,9 @@ void cairo_dock_update_dock_size (CairoDock *pDock)
 	//g_print (">>> iMaxIconHeight : %d, ratio : %.2f, fFlatDockWidth : %.2f\n", (int) pDock->iMaxIconHeight, pDock->container.fRatio, pDock->fFlatDockWidth);
 	
 	//\__________________________ Then take the necessary actions due to the new size.
+	// the icons' size and position at rest may have changed.
+	cairo_dock_invalidate_icons_layout (pDock);
+	
 	// calculate the position of icons in the new frame.
 	cairo_dock_calculate_dock_icons (pDock);
 	
@@ -281,7 +285,7 @@ static void cairo_dock_manage_mouse_position (CairoDock *pDock)
 						return;
 				}
 				//g_print ("on force a quitter (iRefCount:%d; bIsGrowingUp:%d; iMagnitudeIndex:%d)\n", pDock->iRefCount, pDock->bIsGrowingUp, pDock->iMagnitudeIndex);
-				pDock->iSidLeaveDemand = g_timeout_add (MAX (myDocksParam.iLeaveSubDockDelay, 300), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);
+				pDock->iSidLeaveDemand = gldi_timer_add (MAX (myDocksParam.iLeaveSubDockDelay, 300), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);
 			}
 		break ;
 	}
@@ -613,28 +617,24 @@ void cairo_dock_calculate_icons_positions_at_rest_linear (GList *pIconList, doub
 	}
 }
 
-double cairo_dock_calculate_max_dock_width (CairoDock *pDock, double fFlatDockWidth, double fWidthConstraintFactor, double fExtraWidth)
+// same computation of the phase as in 'cairo_dock_calculate_wave_with_position_linear', so that we get exactly the same scales.
+static inline double _get_wave_phase (float fXMiddle, int x_abs)
 {
-	double fMaxDockWidth = 0.;
-	//g_print ("%s (%d)\n", __func__, (int)fFlatDockWidth);
-	GList *pIconList = pDock->icons;
-	if (pIconList == NULL)
-		return 2 * myDocksParam.iDockRadius + myDocksParam.iDockLineWidth + 2 * myDocksParam.iFrameMargin;
-
-	// We reset extreme positions of the icons.
-	GList* ic;
-	Icon *icon;
-	for (ic = pIconList; ic != NULL; ic = ic->next)
-	{
-		icon = ic->data;
-		icon->fXMax = -1e4;
-		icon->fXMin = 1e4;
-	}
+	double fPhase = (fXMiddle - x_abs) / myIconsParam.iSinusoidWidth * G_PI + G_PI / 2;
+	if (fPhase < 0)
+		fPhase = 0;
+	else if (fPhase > G_PI)
+		fPhase = G_PI;
+	return fPhase;
+}
 
+static void _calculate_extreme_positions_by_simulation (CairoDock *pDock, GList *pIconList, double fFlatDockWidth)
+{
 	/* We simulate the move of the cursor in all the width of the dock and we
 	 * get the maximum width and the balance position for each icon.
 	 */
-	GList *ic2;
+	GList* ic, *ic2;
+	Icon *icon;
 	for (ic = pIconList; ic != NULL; ic = ic->next)
 	{
 		icon = ic->data;
@@ -651,6 +651,185 @@ double cairo_dock_calculate_max_dock_width (CairoDock *pDock, double fFlatDockWi
 				icon->fXMin = icon->fX;
 		}
 	}
+}
+
+/* Same as above, in linear time (plus the number of icons inside the sinusoid).
+ * For a given position of the cursor, only the icons inside the sinusoid are zoomed; the icons on its left and on its right are just translated from their position at rest.
+ * So for each position of the cursor, we compute the positions of the zoomed icons, and the shift of the icons on each side; the extreme positions of an icon on one side are then given by the extreme shifts over the positions of the cursor where it's on this side, which are a range of them.
+ * Returns FALSE if the icons are not placed as by 'cairo_dock_calculate_icons_positions_at_rest_linear', in which case nothing is done.
+ */
+static gboolean _calculate_extreme_positions_linear (CairoDock *pDock, GList *pIconList, double fFlatDockWidth)
+{
+	int n = g_list_length (pIconList);
+	double fMagnitude = pDock->fMagnitudeMax;
+	double fGap = myIconsParam.iIconGap;
+	double fScaleRight = 1 + fMagnitude * myIconsParam.fAmplitude * sin (G_PI);  // scale of the icons on the right of the sinusoid (sin(pi) is not exactly 0).
+	
+	Icon **pIcons = g_new (Icon*, n);
+	double *P = g_new (double, 2 * (n + 1));  // positions of the icons when not zoomed; they are the positions at rest.
+	double *Q = P + n + 1;  // positions of the icons when they're all on the right of the sinusoid.
+	GList *ic;
+	int i, k;
+	P[0] = Q[0] = 0;
+	for (ic = pIconList, i = 0; ic != NULL; ic = ic->next, i ++)
+	{
+		pIcons[i] = ic->data;
+		if (pIcons[i]->fXAtRest != P[i])
+		{
+			g_free (P);
+			g_free (pIcons);
+			return FALSE;
+		}
+		P[i+1] = P[i] + (pIcons[i]->fWidth + fGap);  // same sum as when placing the icons at rest.
+		Q[i+1] = Q[i] + (pIcons[i]->fWidth + fGap) * fScaleRight;
+	}
+	
+	// for each position of the cursor: range [a;b[ of the icons inside the sinusoid, and shift of the icons on its left (L) and on its right (R).
+	int *a = g_new (int, 2 * n);
+	int *b = a + n;
+	double *L = g_new (double, 2 * n);
+	double *R = L + n;
+	double *fScale = g_new (double, n);
+	Icon *icon;
+	int x_abs, p, ia = 0, ib = 0, ip = 0;
+	double fXPointed, S, Sb, fX;
+	for (k = 0; k < n; k ++)
+	{
+		x_abs = pIcons[k]->fXAtRest;
+		
+		// icons inside the sinusoid, and their scale.
+		while (ia < n && _get_wave_phase (pIcons[ia]->fXAtRest + pIcons[ia]->fWidth / 2, x_abs) == 0)
+			ia ++;
+		ib = MAX (ib, ia);
+		while (ib < n && _get_wave_phase (pIcons[ib]->fXAtRest + pIcons[ib]->fWidth / 2, x_abs) != G_PI)
+			ib ++;
+		for (i = ia; i < ib; i ++)
+			fScale[i] = 1 + fMagnitude * myIconsParam.fAmplitude * sin (_get_wave_phase (pIcons[i]->fXAtRest + pIcons[i]->fWidth / 2, x_abs));
+		#define _scale_at(i) ((i) < ia ? 1. : (i) < ib ? fScale[i] : fScaleRight)
+		
+		// pointed icon, and its position.
+		while (ip < n && (float)pIcons[ip]->fXAtRest + pIcons[ip]->fWidth + .5*myIconsParam.iIconGap < x_abs)
+			ip ++;
+		if (ip < n && (float)pIcons[ip]->fXAtRest - .5*myIconsParam.iIconGap <= x_abs)
+		{
+			p = ip;
+			float x_cumulated = pIcons[p]->fXAtRest;
+			fXPointed = x_cumulated - fFlatDockWidth / 2 + (1 - _scale_at (p)) * (x_abs - x_cumulated + .5*myIconsParam.iIconGap);
+		}
+		else  // we are at the right of icons.
+		{
+			p = n - 1;
+			float x_cumulated = pIcons[p]->fXAtRest;
+			fXPointed = x_cumulated - fFlatDockWidth / 2 + (1 - _scale_at (p)) * (pIcons[p]->fWidth + .5*myIconsParam.iIconGap);
+		}
+		
+		// cumulated widths up to the pointed icon, so that the positions are X(i) = X(p) + S(i) - S(p).
+		Sb = P[ia];
+		for (i = ia; i < ib; i ++)
+			Sb += (pIcons[i]->fWidth + fGap) * fScale[i];
+		if (p <= ia)
+			S = P[p];
+		else if (p >= ib)
+			S = Sb + Q[p] - Q[ib];
+		else
+		{
+			S = P[ia];
+			for (i = ia; i < p; i ++)
+				S += (pIcons[i]->fWidth + fGap) * fScale[i];
+		}
+		L[k] = fXPointed - S;
+		R[k] = fXPointed - S + Sb - Q[ib];
+		a[k] = ia;
+		b[k] = ib;
+		
+		// the icons inside the sinusoid are updated directly.
+		fX = fXPointed - S + P[ia];
+		for (i = ia; i < ib; i ++)
+		{
+			icon = pIcons[i];
+			if (fX + icon->fWidth * fScale[i] > icon->fXMax)
+				icon->fXMax = fX + icon->fWidth * fScale[i];
+			if (fX < icon->fXMin)
+				icon->fXMin = fX;
+			fX += (icon->fWidth + fGap) * fScale[i];
+		}
+		#undef _scale_at
+	}
+	
+	// extreme shifts: the icon i is on the left of the sinusoid for the positions k such that a[k] > i, which are a suffix of the positions since a[] is increasing; likewise, it is on the right for a prefix of the positions.
+	double *fMinL = g_new (double, 4 * (n + 1));
+	double *fMaxL = fMinL + n + 1;
+	double *fMinR = fMaxL + n + 1;
+	double *fMaxR = fMinR + n + 1;
+	fMinL[n] = G_MAXDOUBLE;
+	fMaxL[n] = -G_MAXDOUBLE;
+	for (k = n - 1; k >= 0; k --)
+	{
+		fMinL[k] = MIN (fMinL[k+1], L[k]);
+		fMaxL[k] = MAX (fMaxL[k+1], L[k]);
+	}
+	fMinR[0] = G_MAXDOUBLE;
+	fMaxR[0] = -G_MAXDOUBLE;
+	for (k = 0; k < n; k ++)
+	{
+		fMinR[k+1] = MIN (fMinR[k], R[k]);
+		fMaxR[k+1] = MAX (fMaxR[k], R[k]);
+	}
+	int kl = 0, kr = 0;
+	for (i = 0; i < n; i ++)
+	{
+		icon = pIcons[i];
+		while (kl < n && a[kl] <= i)
+			kl ++;
+		if (kl < n)  // on the left of the sinusoid for the positions [kl;n[
+		{
+			if (P[i] + fMinL[kl] < icon->fXMin)
+				icon->fXMin = P[i] + fMinL[kl];
+			if (P[i] + fMaxL[kl] + icon->fWidth > icon->fXMax)
+				icon->fXMax = P[i] + fMaxL[kl] + icon->fWidth;
+		}
+		while (kr < n && b[kr] <= i)
+			kr ++;
+		if (kr > 0)  // on the right of the sinusoid for the positions [0;kr[
+		{
+			if (Q[i] + fMinR[kr] < icon->fXMin)
+				icon->fXMin = Q[i] + fMinR[kr];
+			if (Q[i] + fMaxR[kr] + icon->fWidth * fScaleRight > icon->fXMax)
+				icon->fXMax = Q[i] + fMaxR[kr] + icon->fWidth * fScaleRight;
+		}
+	}
+	
+	g_free (fMinL);
+	g_free (fScale);
+	g_free (L);
+	g_free (a);
+	g_free (P);
+	g_free (pIcons);
+	return TRUE;
+}
+
+double cairo_dock_calculate_max_dock_width (CairoDock *pDock, double fFlatDockWidth, double fWidthConstraintFactor, double fExtraWidth)
+{
+	double fMaxDockWidth = 0.;
+	//g_print ("%s (%d)\n", __func__, (int)fFlatDockWidth);
+	GList *pIconList = pDock->icons;
+	if (pIconList == NULL)
+		return 2 * myDocksParam.iDockRadius + myDocksParam.iDockLineWidth + 2 * myDocksParam.iFrameMargin;
+
+	// We reset extreme positions of the icons.
+	GList* ic;
+	Icon *icon;
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		icon->fXMax = -1e4;
+		icon->fXMin = 1e4;
+	}
+
+	// We get the extreme positions of each icon when the cursor moves in all the width of the dock.
+	if (! _calculate_extreme_positions_linear (pDock, pIconList, fFlatDockWidth))
+		_calculate_extreme_positions_by_simulation (pDock, pIconList, fFlatDockWidth);
+	
 	cairo_dock_calculate_wave_with_position_linear (pIconList, fFlatDockWidth - 1, pDock->fMagnitudeMax, fFlatDockWidth, 0, 0, pDock->fAlign, 0, pDock->container.bDirectionUp);  // last calculation at the extreme right of the dock.
 	for (ic = pIconList; ic != NULL; ic = ic->next)
 	{
@@ -674,6 +853,7 @@ double cairo_dock_calculate_max_dock_width (CairoDock *pDock, double fFlatDockWi
 		icon->fX = icon->fXAtRest;
 		icon->fScale = 1;
 	}
+	cairo_dock_invalidate_icons_layout (pDock);  // the extreme positions have changed.
 
 	return fMaxDockWidth;
 }
@@ -832,6 +1012,246 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 	return (icon->bPointed ? icon : NULL);
 }
 
+/* Packed copy of the layout of the icons of a dock.
+ * The wave is computed on each motion of the mouse; rather than walking the list of icons and their large structures, we keep their parameters in contiguous arrays, rebuilt only when the icons change (see 'cairo_dock_invalidate_icons_layout').
+ * Some code empties or modifies the list of icons directly, so the icons of the layout are also checked against the list before it is used; it only compares pointers, and never reads an icon that may have been freed.
+ */
+struct _CairoDockIconsLayout {
+	gboolean bValid;
+	gint iNbIcons;
+	gint iSize;  // number of allocated slots
+	Icon **pIcons;
+	// inputs, copied from the icons.
+	gdouble *fXAtRest, *fWidth, *fHeight, *fXMin, *fXMax;
+	// outputs, copied back to the icons.
+	gdouble *fPhase, *fScale, *fX, *fY;
+};
+#define CAIRO_DOCK_LAYOUT_NB_ARRAYS 9
+
+void cairo_dock_invalidate_icons_layout (CairoDock *pDock)
+{
+	if (pDock->pIconsLayout != NULL)
+		pDock->pIconsLayout->bValid = FALSE;
+}
+
+void cairo_dock_free_icons_layout (CairoDock *pDock)
+{
+	CairoDockIconsLayout *pLayout = pDock->pIconsLayout;
+	if (pLayout == NULL)
+		return;
+	g_free (pLayout->pIcons);
+	g_free (pLayout->fXAtRest);  // all the arrays are in the same block.
+	g_free (pLayout);
+	pDock->pIconsLayout = NULL;
+}
+
+static gboolean _icons_layout_matches_list (CairoDockIconsLayout *pLayout, GList *pIconsList)
+{
+	GList *ic;
+	int i = 0;
+	for (ic = pIconsList; ic != NULL; ic = ic->next, i ++)
+	{
+		if (i >= pLayout->iNbIcons || pLayout->pIcons[i] != ic->data)
+			return FALSE;
+	}
+	return (i == pLayout->iNbIcons);
+}
+
+static CairoDockIconsLayout *_get_icons_layout (CairoDock *pDock)
+{
+	CairoDockIconsLayout *pLayout = pDock->pIconsLayout;
+	if (pLayout == NULL)
+	{
+		pLayout = g_new0 (CairoDockIconsLayout, 1);
+		pDock->pIconsLayout = pLayout;
+	}
+	if (pLayout->bValid && _icons_layout_matches_list (pLayout, pDock->icons))
+		return pLayout;
+	
+	int n = g_list_length (pDock->icons);
+	if (n > pLayout->iSize)
+	{
+		g_free (pLayout->pIcons);
+		g_free (pLayout->fXAtRest);
+		pLayout->iSize = MAX (n, 2 * pLayout->iSize);
+		int iSize = pLayout->iSize;
+		pLayout->pIcons = g_new (Icon*, iSize);
+		gdouble *pBuffer = g_new (gdouble, CAIRO_DOCK_LAYOUT_NB_ARRAYS * iSize);
+		pLayout->fXAtRest = pBuffer;
+		pLayout->fWidth   = pBuffer + iSize;
+		pLayout->fHeight  = pBuffer + 2 * iSize;
+		pLayout->fXMin    = pBuffer + 3 * iSize;
+		pLayout->fXMax    = pBuffer + 4 * iSize;
+		pLayout->fPhase   = pBuffer + 5 * iSize;
+		pLayout->fScale   = pBuffer + 6 * iSize;
+		pLayout->fX       = pBuffer + 7 * iSize;
+		pLayout->fY       = pBuffer + 8 * iSize;
+	}
+	
+	Icon *icon;
+	GList *ic;
+	int i = 0;
+	for (ic = pDock->icons; ic != NULL; ic = ic->next, i ++)
+	{
+		icon = ic->data;
+		pLayout->pIcons[i] = icon;
+		pLayout->fXAtRest[i] = icon->fXAtRest;
+		pLayout->fWidth[i] = icon->fWidth;
+		pLayout->fHeight[i] = icon->fHeight;
+		pLayout->fXMin[i] = icon->fXMin;
+		pLayout->fXMax[i] = icon->fXMax;
+	}
+	pLayout->iNbIcons = n;
+	pLayout->bValid = TRUE;
+	return pLayout;
+}
+
+// sin(x) for x in [0;pi], as x*(pi-x)*P((x-pi/2)^2); it is exact at 0 and pi (so that icons outside of the wave keep a scale of exactly 1), and the error is < 1e-7 elsewhere. Unlike sin(), it can be vectorized.
+static inline double _sin_0_pi (double x)
+{
+	double t = x - G_PI / 2;
+	double t2 = t * t;
+	return x * (G_PI - x) * (0.405284713535714 + t2 * (-0.0383862411579699 + t2 * (0.00132817275238115 + t2 * -2.31176315443810e-05)));
+}
+
+// same as 'cairo_dock_calculate_wave_with_position_linear', on the packed layout.
+static Icon *_calculate_wave_with_layout (CairoDockIconsLayout *pLayout, int x_abs, gdouble fMagnitude, double fFlatDockWidth, int iWidth, int iHeight, double fAlign, double fFoldingFactor, gboolean bDirectionUp)
+{
+	int n = pLayout->iNbIcons;
+	if (n == 0)
+		return NULL;
+	if (x_abs < 0 && iWidth > 0)
+		x_abs = 0;
+	else if (x_abs > fFlatDockWidth && iWidth > 0)
+		x_abs = (int) fFlatDockWidth;
+	
+	Icon **pIcons = pLayout->pIcons;
+	const gdouble *fXAtRest = pLayout->fXAtRest, *fWidth = pLayout->fWidth, *fHeight = pLayout->fHeight, *fXMin = pLayout->fXMin, *fXMax = pLayout->fXMax;
+	gdouble * restrict fPhase = pLayout->fPhase;
+	gdouble * restrict fScale = pLayout->fScale;
+	gdouble * restrict fX = pLayout->fX;
+	gdouble * restrict fY = pLayout->fY;
+	const int iSinusoidWidth = myIconsParam.iSinusoidWidth;
+	const int iIconGap = myIconsParam.iIconGap;
+	const double fAmplitude = myIconsParam.fAmplitude;
+	const double fWaveAmplitude = fMagnitude * fAmplitude;
+	int i;
+	
+	//\_______________ We compute the phase and the scale of each icon; there is no dependency between the icons here, so this loop is vectorized.
+	for (i = 0; i < n; i ++)
+	{
+		float fXMiddle = fXAtRest[i] + fWidth[i] / 2;
+		double fIconPhase = (fXMiddle - x_abs) / iSinusoidWidth * G_PI + G_PI / 2;
+		fIconPhase = (fIconPhase < 0 ? 0 : (fIconPhase > G_PI ? G_PI : fIconPhase));
+		fPhase[i] = fIconPhase;
+		fScale[i] = 1 + fWaveAmplitude * _sin_0_pi (fIconPhase);
+	}
+	
+	//\_______________ We place the icons from the left to the pointed icon.
+	float x_cumulated = 0, fXMiddle, fDeltaExtremum;
+	Icon *icon;
+	double fIconScale = 0.;
+	double offset = 0.;
+	int iPointed = (x_abs < 0 ? 0 : -1);
+	for (i = 0; i < n; i ++)
+	{
+		icon = pIcons[i];
+		x_cumulated = fXAtRest[i];
+		fXMiddle = fXAtRest[i] + fWidth[i] / 2;
+		if (iWidth > 0 && icon->fInsertRemoveFactor != 0)
+		{
+			fIconScale = fScale[i];
+			if (icon->fInsertRemoveFactor > 0)
+				fScale[i] *= icon->fInsertRemoveFactor;
+			else
+				fScale[i] *= (1 + icon->fInsertRemoveFactor);
+		}
+		
+		fY[i] = (bDirectionUp ? iHeight - myDocksParam.iDockLineWidth - myDocksParam.iFrameMargin - fScale[i] * fHeight[i] : myDocksParam.iDockLineWidth + myDocksParam.iFrameMargin);
+		
+		if (iPointed != -1)  // we move the icon compared to the previous one.
+		{
+			if (i == 0)
+			{
+				fX[i] = x_cumulated - 1. * (fFlatDockWidth - iWidth) / 2;
+			}
+			else
+			{
+				fX[i] = fX[i-1] + (fWidth[i-1] + iIconGap) * fScale[i-1];
+				if (fX[i] + fWidth[i] * fScale[i] > fXMax[i] - fAmplitude * fMagnitude * (fWidth[i] + 1.5*iIconGap) / 8 && iWidth != 0)
+				{
+					fDeltaExtremum = fX[i] + fWidth[i] * fScale[i] - (fXMax[i] - fAmplitude * fMagnitude * (fWidth[i] + 1.5*iIconGap) / 16);
+					if (fAmplitude != 0)
+						fX[i] -= fDeltaExtremum * (1 - (fScale[i] - 1) / fAmplitude) * fMagnitude;
+				}
+			}
+			fX[i] = fAlign * iWidth + (fX[i] - fAlign * iWidth) * (1. - fFoldingFactor);
+		}
+		
+		if (iPointed == -1
+		    && x_cumulated + fWidth[i] + .5*iIconGap >= x_abs
+		    && x_cumulated - .5*iIconGap <= x_abs)  // we found the pointed icon.
+		{
+			iPointed = i;
+			icon->bPointed = (x_abs != (int) fFlatDockWidth && x_abs != 0);
+			fX[i] = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - fScale[i]) * (x_abs - x_cumulated + .5*iIconGap);
+			fX[i] = fAlign * iWidth + (fX[i] - fAlign * iWidth) * (1. - fFoldingFactor);
+		}
+		else
+			icon->bPointed = FALSE;
+		
+		if (iWidth > 0 && icon->fInsertRemoveFactor != 0)
+		{
+			if (iPointed != i)
+				offset += (fWidth[i] * (fIconScale - fScale[i])) * (iPointed == -1 ? 1 : -1);
+			else
+				offset += (2*(fXMiddle - x_abs) * (fIconScale - fScale[i])) * (iPointed == -1 ? 1 : -1);
+		}
+	}
+	
+	if (iPointed == -1)  // We are at the right of icons.
+	{
+		iPointed = n - 1;
+		i = iPointed;
+		fX[i] = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - fScale[i]) * (fWidth[i] + .5*iIconGap);
+		fX[i] = fAlign * iWidth + (fX[i] - fAlign * iWidth) * (1 - fFoldingFactor);
+	}
+	
+	//\_______________ We place the icons before the pointed icon beside it.
+	for (i = iPointed - 1; i >= 0; i --)
+	{
+		fX[i] = fX[i+1] - (fWidth[i] + iIconGap) * fScale[i];
+		if (fX[i] < fXMin[i] + fAmplitude * fMagnitude * (fWidth[i] + 1.5*iIconGap) / 8
+		    && iWidth != 0 && x_abs < iWidth && fMagnitude > 0)
+		{
+			fDeltaExtremum = fX[i] - (fXMin[i] + fAmplitude * fMagnitude * (fWidth[i] + 1.5*iIconGap) / 16);
+			if (fAmplitude != 0)
+				fX[i] -= fDeltaExtremum * (1 - (fScale[i] - 1) / fAmplitude) * fMagnitude;
+		}
+		fX[i] = fAlign * iWidth + (fX[i] - fAlign * iWidth) * (1. - fFoldingFactor);
+	}
+	
+	if (offset != 0)
+	{
+		offset /= 2;
+		for (i = 0; i < n; i ++)
+			fX[i] -= offset;
+	}
+	
+	//\_______________ We copy the result into the icons.
+	for (i = 0; i < n; i ++)
+	{
+		icon = pIcons[i];
+		icon->fPhase = fPhase[i];
+		icon->fScale = fScale[i];
+		icon->fX = fX[i];
+		icon->fY = fY[i];
+	}
+	
+	icon = pIcons[iPointed];
+	return (icon->bPointed ? icon : NULL);
+}
+
 Icon *cairo_dock_apply_wave_effect_linear (CairoDock *pDock)
 {
 	//\_______________ We compute the cursor's position in the container of the flat dock
@@ -843,7 +1263,8 @@ Icon *cairo_dock_apply_wave_effect_linear (CairoDock *pDock)
 
 	//\_______________ We compute all parameters for the icons.
 	double fMagnitude = cairo_dock_calculate_magnitude (pDock->iMagnitudeIndex);  // * pDock->fMagnitudeMax
-	Icon *pPointedIcon = cairo_dock_calculate_wave_with_position_linear (pDock->icons, x_abs, fMagnitude, pDock->fFlatDockWidth, pDock->container.iWidth, pDock->container.iHeight, pDock->fAlign, pDock->fFoldingFactor, pDock->container.bDirectionUp);  // iMaxDockWidth
+	CairoDockIconsLayout *pLayout = _get_icons_layout (pDock);
+	Icon *pPointedIcon = _calculate_wave_with_layout (pLayout, x_abs, fMagnitude, pDock->fFlatDockWidth, pDock->container.iWidth, pDock->container.iHeight, pDock->fAlign, pDock->fFoldingFactor, pDock->container.bDirectionUp);  // iMaxDockWidth
 	return pPointedIcon;
 }
 
@@ -1438,6 +1859,7 @@ void cairo_dock_make_preview (CairoDock *pDock, const gchar *cPreviewPath)
 			glbuffer = (GLubyte *) g_malloc (w * h * s);
 
 			glReadPixels(0, 0, w, h, GL_BGRA, GL_UNSIGNED_BYTE, (GLvoid *)buffer);
+			gldi_gl_container_reset_damage_history (CAIRO_CONTAINER (pDock));  // the back buffer is not swapped, it now contains this frame.
 
 			// make upside down
 			int x, y;
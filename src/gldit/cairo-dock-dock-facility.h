@@ -139,6 +139,13 @@ double cairo_dock_calculate_max_dock_width (CairoDock *pDock, double fFlatDockWi
 
 Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_abs, gdouble fMagnitude, double fFlatDockWidth, int iWidth, int iHeight, double fAlign, double fLateralFactor, gboolean bDirectionUp);
 
+/** Invalidate the packed copy of the icons' layout of a dock, used to compute the wave effect. It must be called whenever the list of icons changes; it is already done when the size of the dock is updated.
+*@param pDock a dock.
+*/
+void cairo_dock_invalidate_icons_layout (CairoDock *pDock);
+
+void cairo_dock_free_icons_layout (CairoDock *pDock);
+
 /** Apply a wave effect on the icons of a linear dock. It is the famous zoom when the mouse hovers an icon.
 *@param pDock a linear dock.
 *@return the pointed icon, or NULL if none is pointed.
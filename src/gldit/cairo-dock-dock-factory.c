@@ -51,6 +51,7 @@
 #include "cairo-dock-class-manager.h"  // cairo_dock_check_class_subdock_is_empty
 #include "cairo-dock-desktop-manager.h"
 #include "cairo-dock-windows-manager.h"  // gldi_windows_get_active
+#include "cairo-dock-timer.h"
 #include "cairo-dock-dock-factory.h"
 
 // dependencies
@@ -130,6 +131,7 @@ void cairo_dock_freeze_docks (gboolean bFreeze)
 
 static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoContext, CairoDock *pDock)
 {
+	gint64 iStartTime = g_get_monotonic_time ();
 	if (g_bUseOpenGL && pDock->pRenderer->render_opengl != NULL)  // OpenGL rendering
 	{
 		GdkRectangle area;
@@ -140,7 +142,7 @@ static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoCon
 		area.width = x2 - x1;
 		area.height = y2 - y1;
 		
-		if (! gldi_gl_container_begin_draw_full (CAIRO_CONTAINER (pDock), area.x + area.y != 0 ? &area : NULL, TRUE))
+		if (! gldi_gl_container_begin_draw_full (CAIRO_CONTAINER (pDock), &area, TRUE))  // only the invalidated area is redrawn if possible.
 			return FALSE;
 		
 		if (cairo_dock_is_loading ())
@@ -175,6 +177,7 @@ static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoCon
 			gldi_object_notify (pDock, NOTIFICATION_RENDER, pDock, pCairoContext);
 		}
 	}
+	cairo_dock_record_render_time (g_get_monotonic_time () - iStartTime);
 	return FALSE;
 }
 
@@ -252,7 +255,7 @@ static void _on_change_icon (Icon *pLastPointedIcon, Icon *pPointedIcon, CairoDo
 			if (pSubDock->iSidLeaveDemand == 0)
 			{
 				//g_print (" on retarde le cachage du dock de %dms\n", MAX (myDocksParam.iLeaveSubDockDelay, 300));
-				pSubDock->iSidLeaveDemand = g_timeout_add (MAX (myDocksParam.iLeaveSubDockDelay, 300), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pSubDock);  // on force le retard meme si iLeaveSubDockDelay est a 0, car lorsqu'on entre dans un sous-dock, il arrive frequemment qu'on glisse hors de l'icone qui pointe dessus, et c'est tres desagreable d'avoir le dock qui se ferme avant d'avoir pu entre dedans.
+				pSubDock->iSidLeaveDemand = gldi_timer_add (MAX (myDocksParam.iLeaveSubDockDelay, 300), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pSubDock);  // on force le retard meme si iLeaveSubDockDelay est a 0, car lorsqu'on entre dans un sous-dock, il arrive frequemment qu'on glisse hors de l'icone qui pointe dessus, et c'est tres desagreable d'avoir le dock qui se ferme avant d'avoir pu entre dedans.
 			}
 		}
 	}
@@ -263,7 +266,7 @@ static void _on_change_icon (Icon *pLastPointedIcon, Icon *pPointedIcon, CairoDo
 		// if we were leaving the sub-dock, cancel that.
 		if (pPointedIcon->pSubDock->iSidLeaveDemand != 0)
 		{
-			g_source_remove (pPointedIcon->pSubDock->iSidLeaveDemand);
+			gldi_timer_remove (pPointedIcon->pSubDock->iSidLeaveDemand);
 			pPointedIcon->pSubDock->iSidLeaveDemand = 0;
 		}
 		// and show the sub-dock, possibly with a delay.
@@ -552,7 +555,7 @@ static gboolean _on_leave_notify (G_GNUC_UNUSED GtkWidget* pWidget, GdkEventCros
 				if (pPointedIcon != NULL && pPointedIcon->pSubDock != NULL && gldi_container_is_visible (CAIRO_CONTAINER (pPointedIcon->pSubDock)))
 				{
 					//g_print (" on retarde la sortie du dock de %dms\n", MAX (myDocksParam.iLeaveSubDockDelay, 330));
-					pDock->iSidLeaveDemand = g_timeout_add (MAX (myDocksParam.iLeaveSubDockDelay, 250), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);
+					pDock->iSidLeaveDemand = gldi_timer_add (MAX (myDocksParam.iLeaveSubDockDelay, 250), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);
 					return TRUE;
 				}
 				else if (pDock->bAutoHide)
@@ -561,7 +564,7 @@ static gboolean _on_leave_notify (G_GNUC_UNUSED GtkWidget* pWidget, GdkEventCros
 					if (delay != 0)  /// maybe try to see if we left the dock frankly, or just by a few pixels...
 					{
 						//g_print (" delay the leave event by %dms\n", delay);
-						pDock->iSidLeaveDemand = g_timeout_add (250, (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);
+						pDock->iSidLeaveDemand = gldi_timer_add (250, (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);
 						return TRUE;
 					}
 				}
@@ -569,7 +572,7 @@ static gboolean _on_leave_notify (G_GNUC_UNUSED GtkWidget* pWidget, GdkEventCros
 			else/** if (myDocksParam.iLeaveSubDockDelay != 0)*/  // cas d'un sous-dock : on retarde le cachage.
 			{
 				//g_print (" on retarde la sortie du sous-dock de %dms\n", myDocksParam.iLeaveSubDockDelay);
-				pDock->iSidLeaveDemand = g_timeout_add (MAX (myDocksParam.iLeaveSubDockDelay, 50), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);
+				pDock->iSidLeaveDemand = gldi_timer_add (MAX (myDocksParam.iLeaveSubDockDelay, 50), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);
 				//g_print (" -> pDock->iSidLeaveDemand = %d\n", pDock->iSidLeaveDemand);
 				return TRUE;
 			}
@@ -686,7 +689,7 @@ static gboolean _on_enter_notify (G_GNUC_UNUSED GtkWidget* pWidget, GdkEventCros
 	// stop les timers.
 	if (pDock->iSidLeaveDemand != 0)
 	{
-		g_source_remove (pDock->iSidLeaveDemand);
+		gldi_timer_remove (pDock->iSidLeaveDemand);
 		pDock->iSidLeaveDemand = 0;
 	}
 	if (s_iSidShowSubDockDemand != 0)  // gere un cas tordu mais bien reel.
@@ -697,7 +700,7 @@ static gboolean _on_enter_notify (G_GNUC_UNUSED GtkWidget* pWidget, GdkEventCros
 	if (pDock->iSidHideBack != 0)
 	{
 		//g_print ("remove hide back timeout\n");
-		g_source_remove (pDock->iSidHideBack);
+		gldi_timer_remove (pDock->iSidHideBack);
 		pDock->iSidHideBack = 0;
 	}
 	if (pDock->iSidTestMouseOutside != 0)
@@ -1471,7 +1474,7 @@ void _on_drag_leave (GtkWidget *pWidget, G_GNUC_UNUSED GdkDragContext *dc, G_GNU
 	// emit a leave-event signal, since we don't get one if we leave the window too quickly (!)
 	if (pDock->iSidLeaveDemand == 0)
 	{
-		pDock->iSidLeaveDemand = g_timeout_add (MAX (myDocksParam.iLeaveSubDockDelay, 330), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);  // emit with a delay, so that we can leave and enter the dock for a few ms without making it hide.
+		pDock->iSidLeaveDemand = gldi_timer_add (MAX (myDocksParam.iLeaveSubDockDelay, 330), (GSourceFunc) _emit_leave_signal_delayed, (gpointer) pDock);  // emit with a delay, so that we can leave and enter the dock for a few ms without making it hide.
 	}
 	// emulate a motion event so that the mouse position is up-to-date (which is not the case if we leave the window too quickly).
 	_on_motion_notify (pWidget, NULL, pDock);
@@ -1486,14 +1489,14 @@ static gboolean _cairo_dock_grow_up (CairoDock *pDock)
 {
 	//g_print ("%s (%d ; %2f ; bInside:%d)\n", __func__, pDock->iMagnitudeIndex, pDock->fFoldingFactor, pDock->container.bInside);
 	
-	pDock->iMagnitudeIndex += myBackendsParam.iGrowUpInterval;
+	pDock->iMagnitudeIndex += round (myBackendsParam.iGrowUpInterval * cairo_dock_get_animation_step_factor (pDock));
 	if (pDock->iMagnitudeIndex > CAIRO_DOCK_NB_MAX_ITERATIONS)
 		pDock->iMagnitudeIndex = CAIRO_DOCK_NB_MAX_ITERATIONS;
 
 	if (pDock->fFoldingFactor != 0)
 	{
-		int iAnimationDeltaT = cairo_dock_get_animation_delta_t (pDock);
-		pDock->fFoldingFactor -= (double) iAnimationDeltaT / myBackendsParam.iUnfoldingDuration;
+		int iAnimationElapsedT = cairo_dock_get_animation_elapsed_t (pDock);
+		pDock->fFoldingFactor -= (double) iAnimationElapsedT / myBackendsParam.iUnfoldingDuration;
 		if (pDock->fFoldingFactor < 0)
 			pDock->fFoldingFactor = 0;
 	}
@@ -1540,15 +1543,15 @@ static gboolean _cairo_dock_shrink_down (CairoDock *pDock)
 {
 	//g_print ("%s (%d, %f, %f)\n", __func__, pDock->iMagnitudeIndex, pDock->fFoldingFactor, pDock->fDecorationsOffsetX);
 	//\_________________ On fait decroitre la magnitude du dock.
-	pDock->iMagnitudeIndex -= myBackendsParam.iShrinkDownInterval;
+	pDock->iMagnitudeIndex -= round (myBackendsParam.iShrinkDownInterval * cairo_dock_get_animation_step_factor (pDock));
 	if (pDock->iMagnitudeIndex < 0)
 		pDock->iMagnitudeIndex = 0;
 	
 	//\_________________ On replie le dock.
 	if (pDock->fFoldingFactor != 0 && pDock->fFoldingFactor != 1)
 	{
-		int iAnimationDeltaT = cairo_dock_get_animation_delta_t (pDock);
-		pDock->fFoldingFactor += (double) iAnimationDeltaT / myBackendsParam.iUnfoldingDuration;
+		int iAnimationElapsedT = cairo_dock_get_animation_elapsed_t (pDock);
+		pDock->fFoldingFactor += (double) iAnimationElapsedT / myBackendsParam.iUnfoldingDuration;
 		if (pDock->fFoldingFactor > 1)
 			pDock->fFoldingFactor = 1;
 	}
@@ -1625,7 +1628,7 @@ static gboolean _cairo_dock_hide (CairoDock *pDock)
 	
 	if (pDock->fHideOffset < 1)  // the hiding animation is running.
 	{
-		pDock->fHideOffset += 1./myBackendsParam.iHideNbSteps;
+		pDock->fHideOffset += cairo_dock_get_animation_step_factor (pDock) / myBackendsParam.iHideNbSteps;
 		if (pDock->fHideOffset > .99)  // fin d'anim.
 		{
 			pDock->fHideOffset = 1;
@@ -1671,7 +1674,7 @@ static gboolean _cairo_dock_hide (CairoDock *pDock)
 	}
 	else if (pDock->fPostHideOffset > 0 && pDock->fPostHideOffset < 1)  // the post-hiding animation is running.
 	{
-		pDock->fPostHideOffset += 1./myBackendsParam.iHideNbSteps;
+		pDock->fPostHideOffset += cairo_dock_get_animation_step_factor (pDock) / myBackendsParam.iHideNbSteps;
 		if (pDock->fPostHideOffset > .99)
 		{
 			pDock->fPostHideOffset = 1.;
@@ -1685,7 +1688,7 @@ static gboolean _cairo_dock_hide (CairoDock *pDock)
 
 static gboolean _cairo_dock_show (CairoDock *pDock)
 {
-	pDock->fHideOffset -= 1./myBackendsParam.iUnhideNbSteps;
+	pDock->fHideOffset -= cairo_dock_get_animation_step_factor (pDock) / myBackendsParam.iUnhideNbSteps;
 	if (pDock->fHideOffset < 0.01)
 	{
 		pDock->fHideOffset = 0;
@@ -1862,10 +1865,7 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 	gldi_object_notify (pDock, NOTIFICATION_UPDATE, pDock, &bContinue);
 	
 	if (! bContinue && ! pContainer->bKeepSlowAnimation)
-	{
-		pContainer->iSidGLAnimation = 0;
-		return FALSE;
-	}
+		return FALSE;  // the animation clock will stop the loop.
 	else
 		return TRUE;
 }
@@ -1990,6 +1990,7 @@ static void _detach_icon (GldiContainer *pContainer, Icon *icon)
 	//\___________________ On l'enleve de la liste.
 	pDock->icons = g_list_delete_link (pDock->icons, ic);
 	ic = NULL;
+	cairo_dock_invalidate_icons_layout (pDock);
 	pDock->fFlatDockWidth -= icon->fWidth + myIconsParam.iIconGap;
 	
 	//\___________________ On enleve le separateur si c'est la derniere icone de son type.
@@ -2095,6 +2096,7 @@ static void _insert_icon (GldiContainer *pContainer, Icon *icon, gboolean bAnima
 	pDock->icons = g_list_insert_sorted (pDock->icons,
 		icon,
 		(GCompareFunc)cairo_dock_compare_icons_order);
+	cairo_dock_invalidate_icons_layout (pDock);
 	
 	//\______________ set the icon size, now that it's inside a container.
 	int wi = icon->image.iWidth, hi = icon->image.iHeight;
@@ -2263,6 +2265,7 @@ void cairo_dock_remove_icons_from_dock (CairoDock *pDock, CairoDock *pReceivingD
 	g_return_if_fail (pReceivingDock != NULL);
 	GList *pIconsList = pDock->icons;
 	pDock->icons = NULL;
+	cairo_dock_invalidate_icons_layout (pDock);
 	Icon *icon;
 	GList *ic;
 	for (ic = pIconsList; ic != NULL; ic = ic->next)
@@ -231,11 +231,11 @@ struct _CairoDock {
 	guint iSidMoveResize;
 	/// Source ID for window popping down to the bottom layer.
 	guint iSidUnhideDelayed;
-	/// Source ID of the timer that delays the "leave" event.
+	/// ID of the timer that delays the "leave" event. It's a timer of cairo-dock-timer.h, not a GSource: remove it with \ref gldi_timer_remove, not g_source_remove.
 	guint iSidLeaveDemand;
 	/// Source ID for pending update of WM icons geometry.
 	guint iSidUpdateWMIcons;
-	/// Source ID for hiding back the dock.
+	/// ID of the timer for hiding back the dock. It's a timer of cairo-dock-timer.h, not a GSource: remove it with \ref gldi_timer_remove, not g_source_remove.
 	guint iSidHideBack;
 	/// Source ID for loading the background.
 	guint iSidLoadBg;
@@ -290,7 +290,11 @@ struct _CairoDock {
 	GLuint iRedirectedTexture;
 	GLuint iFboId;
 	
-	gpointer reserved[4];
+	/// packed copy of the layout of the icons, used to compute the wave effect (private).
+	CairoDockIconsLayout *pIconsLayout;
+	/// trigger on the screen edge, that reveals the dock when it's hidden (private).
+	gpointer pEdgeTrigger;
+	gpointer reserved[2];
 };
 
 
@@ -54,6 +54,7 @@
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-opengl.h"
 #include "cairo-dock-dock-visibility.h"
+#include "cairo-dock-timer.h"
 #include "cairo-dock-dock-manager.h"
 #include "cairo-dock-windows-manager.h"
 
@@ -78,6 +79,9 @@ static GHashTable *s_hDocksTable = NULL;  // table des docks existant.
 static GList *s_pRootDockList = NULL;
 static guint s_iSidPollScreenEdge = 0;
 static int s_iNbPolls = 0;
+static gboolean s_bUseEdgeTriggers = FALSE;
+static gint64 s_iEdgeHitTime = 0;  // time when the last edge hit was detected
+static GldiScreenEdgeStats s_edgeStats;
 static gboolean s_bQuickHide = FALSE;
 static gboolean s_bKeepAbove = FALSE;
 static GldiShortkey *s_pPopupBinding = NULL;  // option 'pop up on shortkey'
@@ -101,6 +105,13 @@ typedef struct {
 	gdouble dy;
 } CDMousePolling;
 
+typedef struct {
+	gpointer pTrigger;  // trigger of the desktop backend
+	int x, y, w, h;  // its position on the screen
+	gboolean bHasPosition;  // whether the pointer has been seen on it
+	int x_prev, y_prev;  // last position of the pointer on it
+} CDEdgeTrigger;
+
   /////////////
  // MANAGER //
 /////////////
@@ -905,6 +916,13 @@ static gboolean _cairo_dock_unhide_dock_delayed (CairoDock *pDock)
 		return FALSE;
 	}
 	
+	if (s_iEdgeHitTime != 0)
+	{
+		s_edgeStats.iNbReveals ++;
+		s_edgeStats.fLastRevealDelay = (g_get_monotonic_time () - s_iEdgeHitTime) / 1000.;
+		s_iEdgeHitTime = 0;
+	}
+	
 	//g_print ("let's show this dock (%d)\n", pDock->bIsMainDock);
 	if (pDock->bAutoHide)
 		cairo_dock_start_showing (pDock);
@@ -912,7 +930,7 @@ static gboolean _cairo_dock_unhide_dock_delayed (CairoDock *pDock)
 		cairo_dock_pop_up (pDock);
 	
 	if (pDock->iSidHideBack == 0)  // on se recachera dans 2s si on n'est pas entre dans le dock entre-temps.
-		pDock->iSidHideBack = g_timeout_add (2000, (GSourceFunc) _cairo_dock_hide_back_dock, (gpointer) pDock);
+		pDock->iSidHideBack = gldi_timer_add (2000, (GSourceFunc) _cairo_dock_hide_back_dock, (gpointer) pDock);
 	pDock->iSidUnhideDelayed = 0;
 	return FALSE;
 }
@@ -1040,6 +1058,8 @@ static void _cairo_dock_unhide_root_dock_on_mouse_hit (CairoDock *pDock, CDMouse
 	
 	int iDelay = f * myDocksParam.iUnhideDockDelay;
 	//g_print (" dock will be shown in %dms (%.2f, %d)\n", iDelay, f, pDock->bIsMainDock);
+	if (pDock->iSidUnhideDelayed == 0)
+		s_iEdgeHitTime = g_get_monotonic_time ();
 	if (iDelay != 0)  // on programme une apparition.
 	{
 		if (pDock->iSidUnhideDelayed == 0)
@@ -1054,6 +1074,7 @@ static void _cairo_dock_unhide_root_dock_on_mouse_hit (CairoDock *pDock, CDMouse
 static gboolean _cairo_dock_poll_screen_edge (G_GNUC_UNUSED gpointer data)  // thanks to Smidgey for the pop-up patch !
 {
 	static CDMousePolling mouse;
+	s_edgeStats.iNbPollWakeups ++;
 	
 	// if the active window is full screen, avoid showing the docks on edge hit
 	// some WM will show the dock on top of fullscreen windows, and it's a problem in case of games, for instance
@@ -1066,22 +1087,157 @@ static gboolean _cairo_dock_poll_screen_edge (G_GNUC_UNUSED gpointer data)  // t
 	
 	return TRUE;
 }
-static void _start_polling_screen_edge (void)
+
+static void _on_screen_edge_event (gboolean bInside, int x, int y, CairoDock *pDock)
 {
-	s_iNbPolls ++;
-	cd_debug ("%s (%d)", __func__, s_iNbPolls);
-	if (s_iSidPollScreenEdge == 0)
-		s_iSidPollScreenEdge = g_timeout_add (MOUSE_POLLING_DT, (GSourceFunc) _cairo_dock_poll_screen_edge, NULL);
+	CDEdgeTrigger *pEdge = pDock->pEdgeTrigger;
+	s_edgeStats.iNbEdgeEvents ++;
+	if (! bInside)  // the pointer left the edge before the dock was shown.
+	{
+		pEdge->bHasPosition = FALSE;
+		if (pDock->iSidUnhideDelayed != 0)
+		{
+			g_source_remove (pDock->iSidUnhideDelayed);
+			pDock->iSidUnhideDelayed = 0;
+		}
+		return;
+	}
+	
+	// if the active window is full screen, avoid showing the docks on edge hit (same as when polling).
+	GldiWindowActor *actor = gldi_windows_get_active();
+	if (actor && actor->bIsFullScreen)
+		return;
+	
+	// the pointer is on the edge: we already know its position, so just compute its direction.
+	CDMousePolling mouse;
+	mouse.bUpToDate = TRUE;
+	mouse.bNoMove = FALSE;
+	mouse.x = x;
+	mouse.y = y;
+	if (pEdge->bHasPosition && (x != pEdge->x_prev || y != pEdge->y_prev))
+	{
+		mouse.dx = x - pEdge->x_prev;
+		mouse.dy = y - pEdge->y_prev;
+		double d = sqrt (mouse.dx * mouse.dx + mouse.dy * mouse.dy);
+		mouse.dx /= d;
+		mouse.dy /= d;
+	}
+	else  // first event on the edge: we don't know where the pointer comes from, consider it comes straight onto the edge.
+	{
+		mouse.dx = (pDock->container.bIsHorizontal ? 0 : (pDock->container.bDirectionUp ? 1 : -1));
+		mouse.dy = (pDock->container.bIsHorizontal ? (pDock->container.bDirectionUp ? 1 : -1) : 0);
+	}
+	pEdge->bHasPosition = TRUE;
+	pEdge->x_prev = x;
+	pEdge->y_prev = y;
+	
+	_cairo_dock_unhide_root_dock_on_mouse_hit (pDock, &mouse);  // may disarm the trigger, if the dock is shown immediately.
 }
 
-static void _stop_polling_screen_edge_now (void)
+static void _remove_edge_trigger (CairoDock *pDock)
+{
+	CDEdgeTrigger *pEdge = pDock->pEdgeTrigger;
+	if (pEdge == NULL)
+		return;
+	gldi_desktop_remove_screen_edge_trigger (pEdge->pTrigger);
+	g_free (pEdge);
+	pDock->pEdgeTrigger = NULL;
+}
+
+void gldi_dock_update_edge_trigger (CairoDock *pDock)
+{
+	if (! s_bUseEdgeTriggers
+	|| pDock->iRefCount != 0
+	|| ! pDock->bAutoHide
+	|| pDock->iInputState != CAIRO_DOCK_INPUT_HIDDEN)  // the trigger is only needed while the dock is hidden; otherwise it would catch the pointer over the dock.
+	{
+		_remove_edge_trigger (pDock);
+		return;
+	}
+	
+	// the trigger is a line along the screen edge, on the dock's screen.
+	int iScreenWidth = gldi_dock_get_screen_width (pDock);
+	int iScreenHeight = gldi_dock_get_screen_height (pDock);
+	int iScreenX = gldi_dock_get_screen_offset_x (pDock);
+	int iScreenY = gldi_dock_get_screen_offset_y (pDock);
+	int x = iScreenX, y = iScreenY + (pDock->container.bDirectionUp ? iScreenHeight - 1 : 0);
+	int w = iScreenWidth, h = 1;
+	if (! pDock->container.bIsHorizontal)
+	{
+		int tmp = x; x = y; y = tmp;
+		w = 1; h = iScreenWidth;
+	}
+	
+	CDEdgeTrigger *pEdge = pDock->pEdgeTrigger;
+	if (pEdge != NULL)
+	{
+		if (pEdge->x == x && pEdge->y == y && pEdge->w == w && pEdge->h == h)  // already in place.
+			return;
+		_remove_edge_trigger (pDock);
+	}
+	
+	gpointer pTrigger = gldi_desktop_add_screen_edge_trigger (x, y, w, h, CAIRO_CONTAINER (pDock), (GldiScreenEdgeFunc) _on_screen_edge_event, pDock);
+	if (pTrigger == NULL)
+	{
+		cd_warning ("couldn't watch the screen edge of the dock '%s'", pDock->cDockName);
+		return;
+	}
+	pEdge = g_new0 (CDEdgeTrigger, 1);
+	pEdge->pTrigger = pTrigger;
+	pEdge->x = x;
+	pEdge->y = y;
+	pEdge->w = w;
+	pEdge->h = h;
+	pDock->pEdgeTrigger = pEdge;
+}
+
+static gboolean _can_use_edge_triggers (void)
 {
-	if (s_iSidPollScreenEdge != 0)
+	if (s_iNbPolls <= 0)
+		return FALSE;
+	if (myDocksParam.iCallbackMethod != CAIRO_HIT_SCREEN_BORDER
+	&& myDocksParam.iCallbackMethod != CAIRO_HIT_DOCK_PLACE)  // the corners and the zone are not a line along the edge, keep polling for them.
+		return FALSE;
+	if (! gldi_desktop_can_watch_screen_edges ())
+		return FALSE;
+	GList *d;
+	for (d = s_pRootDockList; d != NULL; d = d->next)
+	{
+		CairoDock *pDock = d->data;
+		if (pDock->iVisibility == CAIRO_DOCK_VISI_KEEP_BELOW)  // such docks are never hidden, they are popped up when the pointer hits the edge.
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static void _update_screen_edge_watch (void)
+{
+	s_bUseEdgeTriggers = _can_use_edge_triggers ();
+	s_edgeStats.bEventDriven = s_bUseEdgeTriggers;
+	if (s_iNbPolls > 0 && ! s_bUseEdgeTriggers)
+	{
+		if (s_iSidPollScreenEdge == 0)
+			s_iSidPollScreenEdge = g_timeout_add (MOUSE_POLLING_DT, (GSourceFunc) _cairo_dock_poll_screen_edge, NULL);
+	}
+	else if (s_iSidPollScreenEdge != 0)
 	{
 		g_source_remove (s_iSidPollScreenEdge);
 		s_iSidPollScreenEdge = 0;
 	}
+	g_list_foreach (s_pRootDockList, (GFunc) gldi_dock_update_edge_trigger, NULL);
+}
+
+static void _start_polling_screen_edge (void)
+{
+	s_iNbPolls ++;
+	cd_debug ("%s (%d)", __func__, s_iNbPolls);
+	_update_screen_edge_watch ();
+}
+
+static void _stop_polling_screen_edge_now (void)
+{
 	s_iNbPolls = 0;
+	_update_screen_edge_watch ();
 }
 static void _stop_polling_screen_edge (void)
 {
@@ -1091,6 +1247,13 @@ static void _stop_polling_screen_edge (void)
 	{
 		_stop_polling_screen_edge_now ();  // remet tout a 0.
 	}
+	else
+		_update_screen_edge_watch ();  // a keep-below dock may be gone.
+}
+
+void gldi_docks_get_screen_edge_stats (GldiScreenEdgeStats *pStats)
+{
+	*pStats = s_edgeStats;
 }
 
 void gldi_dock_set_visibility (CairoDock *pDock, CairoDockVisibility iVisibility)
@@ -1185,6 +1348,8 @@ void gldi_dock_set_visibility (CairoDock *pDock, CairoDockVisibility iVisibility
 		_stop_polling_screen_edge ();
 	else if (!bIsPolling && bShouldPoll)
 		_start_polling_screen_edge ();
+	else
+		_update_screen_edge_watch ();  // the dock may be kept below now, or not anymore.
 }
 
 
@@ -1244,8 +1409,8 @@ static void _show_dock_at_mouse (CairoDock *pDock, G_GNUC_UNUSED gpointer data)
 		
 		// schedule a hiding in a few seconds
 		if (pDock->iSidHideBack != 0)
-			g_source_remove (pDock->iSidHideBack);
-		pDock->iSidHideBack = g_timeout_add (3000, (GSourceFunc) _autohide_after_shortkey, (gpointer) pDock);
+			gldi_timer_remove (pDock->iSidHideBack);
+		pDock->iSidHideBack = gldi_timer_add (3000, (GSourceFunc) _autohide_after_shortkey, (gpointer) pDock);
 	}
 }
 static void _raise_from_shortcut (G_GNUC_UNUSED const char *cKeyShortcut, G_GNUC_UNUSED gpointer data)
@@ -1258,6 +1423,7 @@ static gboolean _on_screen_geometry_changed (G_GNUC_UNUSED gpointer data, gboole
 {
 	if (bSizeHasChanged)
 		_reposition_root_docks (FALSE);  // FALSE <=> main dock included
+	g_list_foreach (s_pRootDockList, (GFunc) gldi_dock_update_edge_trigger, NULL);  // the screen edges may have moved.
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
@@ -2049,11 +2215,11 @@ static void reset_object (GldiObject *obj)
 	if (pDock->iSidUnhideDelayed != 0)
 		g_source_remove (pDock->iSidUnhideDelayed);
 	if (pDock->iSidHideBack != 0)
-		g_source_remove (pDock->iSidHideBack);
+		gldi_timer_remove (pDock->iSidHideBack);
 	if (pDock->iSidMoveResize != 0)
 		g_source_remove (pDock->iSidMoveResize);
 	if (pDock->iSidLeaveDemand != 0)
-		g_source_remove (pDock->iSidLeaveDemand);
+		gldi_timer_remove (pDock->iSidLeaveDemand);
 	if (pDock->iSidUpdateWMIcons != 0)
 		g_source_remove (pDock->iSidUpdateWMIcons);
 	if (pDock->iSidLoadBg != 0)
@@ -2096,6 +2262,7 @@ static void reset_object (GldiObject *obj)
 	}
 	
 	// stop the mouse scrutation
+	_remove_edge_trigger (pDock);
 	if (pDock->iVisibility == CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP
 	|| pDock->iVisibility == CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP_ANY
 	|| pDock->iVisibility == CAIRO_DOCK_VISI_AUTO_HIDE
@@ -2114,6 +2281,8 @@ static void reset_object (GldiObject *obj)
 	if (pDock->pActiveShapeBitmap != NULL)
 		cairo_region_destroy (pDock->pActiveShapeBitmap);
 	
+	cairo_dock_free_icons_layout (pDock);
+	
 	if (pDock->pRenderer != NULL && pDock->pRenderer->free_data != NULL)
 	{
 		pDock->pRenderer->free_data (pDock);
@@ -2170,6 +2339,8 @@ static GKeyFile* reload_object (GldiObject *obj, gboolean bReloadConf, G_GNUC_UN
 	
 	_cairo_dock_draw_one_subdock_icon (NULL, pDock, NULL);  // container-icons may be drawn differently according to the orientation (ex.: box). must be done after sub-docks are reloaded.
 	
+	gldi_dock_update_edge_trigger (pDock);  // the dock may have moved to another edge.
+	
 	gtk_widget_queue_draw (pDock->container.pWidget);
 	return NULL;
 }
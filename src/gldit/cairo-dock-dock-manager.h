@@ -238,6 +238,30 @@ void gldi_subdock_synchronize_orientation (CairoDock *pSubDock, CairoDock *pDock
 */
 void gldi_dock_set_visibility (CairoDock *pDock, CairoDockVisibility iVisibility);
 
+/// Counters of the detection of the screen edges, that reveal the hidden docks.
+typedef struct {
+	/// whether the screen edges are watched with events (TRUE) or by polling the pointer (FALSE).
+	gboolean bEventDriven;
+	/// number of times the pointer was polled.
+	guint iNbPollWakeups;
+	/// number of events received from the screen edges.
+	guint iNbEdgeEvents;
+	/// number of docks revealed by hitting a screen edge.
+	guint iNbReveals;
+	/// time between the detection of the last hit and the reveal of the dock, in ms (it includes the delay to unhide the dock).
+	double fLastRevealDelay;
+} GldiScreenEdgeStats;
+
+/** Arm or disarm the trigger of a root dock on its screen edge, according to its current state. A trigger is only set when the dock is hidden and the screen edges can be watched with events.
+*@param pDock a root dock.
+*/
+void gldi_dock_update_edge_trigger (CairoDock *pDock);
+
+/** Get the counters of the detection of the screen edges.
+*@param pStats a structure to fill with the counters.
+*/
+void gldi_docks_get_screen_edge_stats (GldiScreenEdgeStats *pStats);
+
 
 void gldi_register_docks_manager (void);
 
@@ -23,6 +23,11 @@
 #include <fcntl.h>  // open
 #include <sys/sendfile.h>  // sendfile
 #include <errno.h>  // errno
+#include <dirent.h>  // opendir
+#include <signal.h>  // kill
+#include <unistd.h>  // close, syscall
+#include <sys/syscall.h>  // SYS_pidfd_open
+#include <glib-unix.h>  // g_unix_fd_add
 
 #include "gldi-config.h"
 #include "cairo-dock-dock-factory.h"
@@ -37,6 +42,7 @@
 #include "cairo-dock-container.h"
 #include "cairo-dock-utils.h"  // cairo_dock_launch_command_sync, cairo_dock_property_is_present_on_root
 #include "cairo-dock-icon-manager.h"  // cairo_dock_free_icon
+#include "cairo-dock-timer.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-file-manager.h"
 
@@ -128,16 +134,12 @@ gboolean cairo_dock_fm_launch_uri (const gchar *cURI)
 		//s_pEnvBackend->launch_uri (cURI);
 		GError *erreur = NULL;
 		gchar *cThreadURI = g_strdup (cURI);
-		#if (GLIB_MAJOR_VERSION == 2 && GLIB_MINOR_VERSION < 32)
-		GThread* pThread = g_thread_create ((GThreadFunc) _cairo_dock_fm_launch_uri_threaded, (gpointer) cThreadURI, FALSE, &erreur);
-		#else
 		// The name can be useful for discriminating threads in a debugger.
 		// Some systems restrict the length of name to 16 bytes. 
 		gchar *cThreadName = g_strndup (cURI, 15);
 		GThread* pThread = g_thread_try_new (cThreadName, (GThreadFunc) _cairo_dock_fm_launch_uri_threaded, (gpointer) cThreadURI, &erreur);
 		g_thread_unref (pThread);
 		g_free (cThreadName);
-		#endif
 		if (erreur != NULL)
 		{
 			cd_warning (erreur->message);
@@ -542,45 +544,175 @@ gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath)
  /// PID ///
 ///////////
 
+typedef struct {
+	gchar **cNames;  // names of the processes to wait for, or NULL to wait for the PID only.
+	int iPid;  // process currently watched.
+	int iPidFd;  // pidfd of the process, or -1 if it's checked by the scanner.
+	guint iSidPidFd;
+	GSourceFunc pCallback;
+	gpointer pUserData;
+} CDPidWatch;
+
+static GList *s_pScannedPidWatches = NULL;  // watches that can't use a pidfd, all checked at once.
+static guint s_iSidScanPids = 0;
+#define CD_PID_SCAN_INTERVAL 1000  // ms
+
+static gboolean _process_has_name (const gchar *cPid, gchar **cNames)
+{
+	// like pidof, compare the names with the name of the executable (the first argument of the command line), and with the short name of the process.
+	gchar *cPath = g_strdup_printf ("/proc/%s/cmdline", cPid);
+	gchar *cCmdLine = NULL;
+	gboolean bFound = FALSE;
+	int i;
+	if (g_file_get_contents (cPath, &cCmdLine, NULL, NULL) && *cCmdLine != '\0')  // the arguments are separated by '\0', so we get the first one.
+	{
+		gchar *cExec = strrchr (cCmdLine, '/');
+		cExec = (cExec ? cExec + 1 : cCmdLine);
+		for (i = 0; cNames[i] != NULL && ! bFound; i ++)
+			bFound = (*cNames[i] != '\0' && strcmp (cExec, cNames[i]) == 0);
+	}
+	g_free (cCmdLine);
+	g_free (cPath);
+	if (bFound)
+		return TRUE;
+	
+	cPath = g_strdup_printf ("/proc/%s/comm", cPid);
+	gchar *cComm = NULL;
+	if (g_file_get_contents (cPath, &cComm, NULL, NULL))
+	{
+		g_strchomp (cComm);
+		for (i = 0; cNames[i] != NULL && ! bFound; i ++)
+			bFound = (*cNames[i] != '\0' && strncmp (cComm, cNames[i], 15) == 0 && (strlen (cNames[i]) <= 15 || strlen (cComm) == 15));  // the short name is truncated to 15 chars.
+	}
+	g_free (cComm);
+	g_free (cPath);
+	return bFound;
+}
+
+static int _find_process (gchar **cNames)
+{
+	DIR *d = opendir ("/proc");
+	if (d == NULL)
+		return -1;
+	int iPid = -1, iMyPid = getpid ();
+	struct dirent *e;
+	int pid;
+	while ((e = readdir (d)) != NULL)
+	{
+		if (! g_ascii_isdigit (e->d_name[0]))
+			continue;
+		pid = atoi (e->d_name);
+		if (pid == iMyPid)
+			continue;
+		if (_process_has_name (e->d_name, cNames))
+		{
+			iPid = pid;
+			break;
+		}
+	}
+	closedir (d);
+	return iPid;
+}
+
 int cairo_dock_fm_get_pid (const gchar *cProcessName)
 {
-	int iPID = -1;
-	gchar *cCommand = g_strdup_printf ("pidof %s", cProcessName);
-	gchar *cPID = cairo_dock_launch_command_sync (cCommand);
-
-	if (cPID != NULL && *cPID != '\0')
-		iPID = atoi (cPID);
-
-	g_free (cPID);
-	g_free (cCommand);
-
+	g_return_val_if_fail (cProcessName != NULL, -1);
+	gchar **cNames = g_strsplit_set (cProcessName, " ", -1);  // like pidof, several names can be given.
+	int iPID = _find_process (cNames);
+	g_strfreev (cNames);
 	return iPID;
 }
 
-static gboolean _wait_pid (gpointer *pData)
+static gboolean _process_is_running (int iPid)
 {
-	gboolean bCheckSameProcess = GPOINTER_TO_INT (pData[0]);
-	gchar *cProcess = pData[1];
+	return (kill (iPid, 0) == 0 || errno != ESRCH);  // EPERM means that the process exists but is not ours.
+}
 
-	// check if /proc/%d dir exists or the process is running
-	if ((bCheckSameProcess && ! g_file_test (cProcess, G_FILE_TEST_EXISTS))
-		|| (! bCheckSameProcess && cairo_dock_fm_get_pid (cProcess) == -1))
-	{
-		GSourceFunc pCallback = pData[2];
-		gpointer pUserData = pData[3];
+static int _open_pidfd (int iPid)
+{
+	#ifdef SYS_pidfd_open
+	return syscall (SYS_pidfd_open, iPid, 0);  // Linux >= 5.3
+	#else
+	return -1;
+	#endif
+}
 
-		pCallback (pUserData);
+static void _free_pid_watch (CDPidWatch *pWatch)
+{
+	if (pWatch->iSidPidFd != 0)
+		g_source_remove (pWatch->iSidPidFd);
+	if (pWatch->iPidFd >= 0)
+		close (pWatch->iPidFd);
+	g_strfreev (pWatch->cNames);
+	g_free (pWatch);
+}
 
-		// free allocated ressources just used for this function
-		g_free (cProcess);
-		g_free (pData);
+static void _watch_pid (CDPidWatch *pWatch);
 
-		return FALSE;
+static gboolean _on_pidfd (G_GNUC_UNUSED int fd, G_GNUC_UNUSED GIOCondition condition, CDPidWatch *pWatch)
+{
+	// the process has terminated
+	close (pWatch->iPidFd);
+	pWatch->iPidFd = -1;
+	pWatch->iSidPidFd = 0;  // the source is removed since we return FALSE
+	
+	// if we wait for a name, another process with this name may still be running.
+	if (pWatch->cNames != NULL)
+	{
+		pWatch->iPid = _find_process (pWatch->cNames);
+		if (pWatch->iPid != -1)
+		{
+			_watch_pid (pWatch);
+			return FALSE;
+		}
 	}
+	
+	pWatch->pCallback (pWatch->pUserData);
+	_free_pid_watch (pWatch);
+	return FALSE;
+}
 
+static gboolean _scan_pids (G_GNUC_UNUSED gpointer data)
+{
+	GList *w = s_pScannedPidWatches, *next_w;
+	CDPidWatch *pWatch;
+	while (w != NULL)
+	{
+		pWatch = w->data;
+		next_w = w->next;
+		if (! _process_is_running (pWatch->iPid)
+		&& (pWatch->cNames == NULL || (pWatch->iPid = _find_process (pWatch->cNames)) == -1))  // no more process with this name.
+		{
+			s_pScannedPidWatches = g_list_delete_link (s_pScannedPidWatches, w);
+			pWatch->pCallback (pWatch->pUserData);
+			_free_pid_watch (pWatch);
+		}
+		w = next_w;
+	}
+	
+	if (s_pScannedPidWatches == NULL)
+	{
+		s_iSidScanPids = 0;
+		return FALSE;
+	}
 	return TRUE;
 }
 
+static void _watch_pid (CDPidWatch *pWatch)
+{
+	pWatch->iPidFd = _open_pidfd (pWatch->iPid);
+	if (pWatch->iPidFd >= 0)  // the fd becomes readable when the process terminates, so we are notified at once, without polling.
+	{
+		pWatch->iSidPidFd = g_unix_fd_add (pWatch->iPidFd, G_IO_IN, (GUnixFDSourceFunc) _on_pidfd, pWatch);
+	}
+	else  // no pidfd (old kernel or not Linux), check all the processes together from time to time; no command is launched, so it's cheap.
+	{
+		s_pScannedPidWatches = g_list_prepend (s_pScannedPidWatches, pWatch);
+		if (s_iSidScanPids == 0)
+			s_iSidScanPids = gldi_timer_add (CD_PID_SCAN_INTERVAL, (GSourceFunc) _scan_pids, NULL);
+	}
+}
+
 gboolean cairo_dock_fm_monitor_pid (const gchar *cProcessName, gboolean bCheckSameProcess, GSourceFunc pCallback, gboolean bAlwaysLaunch, gpointer pUserData)
 {
 	int iPID = cairo_dock_fm_get_pid (cProcessName);
@@ -591,23 +723,20 @@ gboolean cairo_dock_fm_monitor_pid (const gchar *cProcessName, gboolean bCheckSa
 		return FALSE;
 	}
 
-	gpointer *pData = g_new (gpointer, 4);
-	pData[0] = GINT_TO_POINTER (bCheckSameProcess);
-	if (bCheckSameProcess)
-		pData[1] = g_strdup_printf ("/proc/%d", iPID);
-	else
-		pData[1] = g_strdup (cProcessName);
-	pData[2] = pCallback;
-	pData[3] = pUserData;
-
-	/* It's not easy to be notified when a non child process is stopped...
-	 * We can't use waitpid (not a child process) or monitor /proc/PID dir (or a
-	 * file into it) with g_file_monitor, poll or inotify => it's not working...
-	 * And for apt-get/dpkg, we can't monitor the lock file with fcntl because
-	 * we need root rights to do that.
-	 * Let's just check every 5 seconds if the PID is still running
+	CDPidWatch *pWatch = g_new0 (CDPidWatch, 1);
+	if (! bCheckSameProcess)
+		pWatch->cNames = g_strsplit_set (cProcessName, " ", -1);
+	pWatch->iPid = iPID;
+	pWatch->iPidFd = -1;
+	pWatch->pCallback = pCallback;
+	pWatch->pUserData = pUserData;
+
+	/* It's not easy to be notified when a non child process is stopped:
+	 * we can't use waitpid (not a child process) or monitor /proc/PID dir with
+	 * inotify. A pidfd can be polled though, and is notified when the process
+	 * terminates; otherwise, all the watched processes are checked together.
 	 */
-	g_timeout_add_seconds (5, (GSourceFunc)_wait_pid, pData);
+	_watch_pid (pWatch);
 
 	return TRUE;
 }
@@ -21,6 +21,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/wait.h>  // WIFEXITED
 
 #include <gtk/gtk.h>
 #include <glib/gstdio.h>
@@ -532,6 +533,7 @@ void cairo_dock_move_icon_after_icon (CairoDock *pDock, Icon *icon1, Icon *icon2
 	pDock->icons = g_list_insert_sorted (pDock->icons,
 		icon1,
 		(GCompareFunc) cairo_dock_compare_icons_order);
+	cairo_dock_invalidate_icons_layout (pDock);
 
 	//\_________________ On recalcule la largeur max, qui peut avoir ete influencee par le changement d'ordre.
 	cairo_dock_trigger_update_dock_size (pDock);
@@ -723,6 +725,19 @@ void gldi_theme_icon_write_order_in_conf_file (Icon *pIcon, double fOrder)
 
 
 
+typedef struct {
+	gchar *cClass;
+	guint iStartupSerial;  // the launching this command belongs to
+} CDLaunchedCommand;
+
+static void _on_command_exited (G_GNUC_UNUSED GPid pid, gint iStatus, CDLaunchedCommand *pCommand)
+{
+	if (! WIFEXITED (iStatus) || WEXITSTATUS (iStatus) != 0)  // the program has failed (not found, crashed, etc), no need to wait for its window; but if it exits late, the class may have been launched again since then, so don't end the new launching.
+		gldi_class_startup_notify_end_serial (pCommand->cClass, pCommand->iStartupSerial);
+	g_free (pCommand->cClass);
+	g_free (pCommand);
+}
+
 gboolean gldi_icon_launch_command (Icon *pIcon)
 {
 	// notify startup
@@ -734,8 +749,15 @@ gboolean gldi_icon_launch_command (Icon *pIcon)
 	if (! cCommand)
 		cCommand = cairo_dock_get_class_command (pIcon->cClass);
 
-	gboolean bSuccess = cairo_dock_launch_command_full (cCommand, cWorkingDirectory);
+	CDLaunchedCommand *pCommand = g_new0 (CDLaunchedCommand, 1);
+	pCommand->cClass = g_strdup (pIcon->cClass);
+	pCommand->iStartupSerial = gldi_class_get_startup_serial (pIcon->cClass);
+	gboolean bSuccess = cairo_dock_launch_command_full_with_callback (cCommand, cWorkingDirectory, (GChildWatchFunc) _on_command_exited, pCommand);
 	if (! bSuccess)
+	{
 		gldi_class_startup_notify_end (pIcon->cClass);
+		g_free (pCommand->cClass);
+		g_free (pCommand);
+	}
 	return bSuccess;
 }
@@ -37,10 +37,14 @@
 #include "cairo-dock-icon-facility.h"
 #include "cairo-dock-data-renderer.h"
 #include "cairo-dock-overlay.h"
+#include "cairo-dock-task.h"
+#include "cairo-dock-container.h"  // gldi_container_is_visible
+#include "cairo-dock-launcher-manager.h"  // GLDI_OBJECT_IS_LAUNCHER_ICON
+#include "cairo-dock-icon-manager.h"  // cairo_dock_search_icon_s_path
 #include "cairo-dock-icon-factory.h"
 
 extern CairoDockImageBuffer g_pIconBackgroundBuffer;
-//extern gboolean g_bUseOpenGL;
+extern gboolean g_bUseOpenGL;
 
 const gchar *s_cRendererNames[4] = {NULL, "Emblem", "Stack", "Box"};  // c'est juste pour realiser la transition entre le chiffre en conf, et un nom (limitation du panneau de conf). On garde le numero pour savoir rapidement sur laquelle on set.
 
@@ -197,7 +201,7 @@ void cairo_dock_load_icon_text (Icon *icon)
 		&myIconsParam.iconTextDescription,
 		&iWidth,
 		&iHeight);
-	cairo_dock_load_image_buffer_from_surface (&icon->label, pSurface, iWidth, iHeight);
+	cairo_dock_load_image_buffer_from_surface_in_atlas (&icon->label, pSurface, iWidth, iHeight);  // labels are small and many, and are only drawn as is.
 	g_free (cTruncatedName);
 }
 
@@ -207,13 +211,24 @@ void cairo_dock_load_icon_quickinfo (Icon *icon)
 	{
 		cairo_dock_remove_overlay_at_position (icon, CAIRO_OVERLAY_BOTTOM, (gpointer)"quick-info");
 	}
-	else  // add an overlay at the bottom with the text surface; any previous "quick-info" overlay will be removed.
+	else  // add an overlay at the bottom with the text; in OpenGL the previous "quick-info" overlay is updated in place, otherwise it's replaced by a new one.
 	{
 		int iWidth, iHeight;
 		cairo_dock_get_icon_extent (icon, &iWidth, &iHeight);
 		double fMaxScale = cairo_dock_get_icon_max_scale (icon);
 		if (iHeight / (myIconsParam.quickInfoTextDescription.iSize * fMaxScale) > 5)  // if the icon is very height (the text occupies less than 20% of the icon)
 			fMaxScale = MIN ((double)iHeight / (myIconsParam.quickInfoTextDescription.iSize * 5), MAX (1., 16./myIconsParam.quickInfoTextDescription.iSize) * fMaxScale);  // let's make it use 20% of the icon's height, limited to 16px
+		if (g_bUseOpenGL)  // draw the text with the glyph cache: the overlay is updated in place, so a quick-info that changes often (like a percentage) doesn't create any surface or texture.
+		{
+			CairoOverlay *pOverlay = cairo_dock_add_overlay_from_text (icon, icon->cQuickInfo,
+				&myIconsParam.quickInfoTextDescription,
+				fMaxScale,
+				iWidth,  // limit the text to the width of the icon
+				CAIRO_OVERLAY_BOTTOM, (gpointer)"quick-info");
+			if (pOverlay)
+				cairo_dock_set_overlay_scale (pOverlay, 0);
+			return;
+		}
 		int w, h;
 		cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (icon->cQuickInfo,
 			&myIconsParam.quickInfoTextDescription,
@@ -227,14 +242,72 @@ void cairo_dock_load_icon_quickinfo (Icon *icon)
 }
 
 
+static CairoDockIconLoadStats s_loadStats;
+static guint s_iNbPendingLoads = 0;
+static gint64 s_iLoadStartTime = 0;  // start of the current series of loads, in us
+static gboolean s_bFirstIconLoaded = FALSE;
+
+static void _on_icon_load_scheduled (void)
+{
+	if (s_iNbPendingLoads == 0)  // new series
+	{
+		s_iLoadStartTime = g_get_monotonic_time ();
+		s_bFirstIconLoaded = FALSE;
+	}
+	s_iNbPendingLoads ++;
+}
+
+static void _on_icon_load_done (gboolean bLoaded, gboolean bDecodedInThread)  // bLoaded is FALSE if the load has been cancelled
+{
+	g_return_if_fail (s_iNbPendingLoads != 0);
+	double fElapsed = (g_get_monotonic_time () - s_iLoadStartTime) * 1e-6;
+	if (bLoaded)
+	{
+		s_loadStats.iNbLoaded ++;
+		if (bDecodedInThread)
+			s_loadStats.iNbDecodedInThread ++;
+		if (! s_bFirstIconLoaded)
+		{
+			s_loadStats.fTimeToFirstIcon = fElapsed;
+			s_bFirstIconLoaded = TRUE;
+		}
+	}
+	s_iNbPendingLoads --;
+	if (s_iNbPendingLoads == 0)  // end of the series
+	{
+		s_loadStats.fTimeToAllIcons = fElapsed;
+		cd_debug ("icons loaded: first after %.3fs, all after %.3fs (%d/%d decoded in a thread)", s_loadStats.fTimeToFirstIcon, s_loadStats.fTimeToAllIcons, s_loadStats.iNbDecodedInThread, s_loadStats.iNbLoaded);
+	}
+}
+
+void cairo_dock_cancel_load_icon_buffers (Icon *pIcon)
+{
+	if (pIcon->iSidLoadImage != 0)
+	{
+		g_source_remove (pIcon->iSidLoadImage);
+		pIcon->iSidLoadImage = 0;
+		_on_icon_load_done (FALSE, FALSE);
+	}
+	else if (pIcon->pLoadImageTask != NULL)
+	{
+		gldi_task_discard (pIcon->pLoadImageTask);
+		pIcon->pLoadImageTask = NULL;
+		_on_icon_load_done (FALSE, FALSE);
+	}
+}
+
+void cairo_dock_get_icon_load_stats (CairoDockIconLoadStats *pStats)
+{
+	*pStats = s_loadStats;
+}
+
 void cairo_dock_load_icon_buffers (Icon *pIcon, GldiContainer *pContainer)
 {
 	gboolean bLoadText = TRUE;
-	if (pIcon->iSidLoadImage != 0)  // if a load was sheduled, cancel it and do it now (we need to load the applets' buffer before initializing the module).
+	if (pIcon->iSidLoadImage != 0 || pIcon->pLoadImageTask != NULL)  // if a load was sheduled, cancel it and do it now (we need to load the applets' buffer before initializing the module).
 	{
 		//g_print (" load %s immediately\n", pIcon->cName);
-		g_source_remove (pIcon->iSidLoadImage);
-		pIcon->iSidLoadImage = 0;
+		cairo_dock_cancel_load_icon_buffers (pIcon);  // if the image was being decoded in a thread, the result is just dropped.
 		bLoadText = FALSE;  // has been done in cairo_dock_trigger_load_icon_buffers(), the only function to schedule the image loading.
 	}
 	
@@ -249,11 +322,8 @@ void cairo_dock_load_icon_buffers (Icon *pIcon, GldiContainer *pContainer)
 	}
 }
 
-static gboolean _load_icon_buffer_idle (Icon *pIcon)
+static void _load_icon_buffer_now (Icon *pIcon)
 {
-	//g_print ("%s (%s; %dx%d; %.2fx%.2f; %x)\n", __func__, pIcon->cName, pIcon->iAllocatedWidth, pIcon->iAllocatedHeight, pIcon->fWidth, pIcon->fHeight, pIcon->pContainer);
-	pIcon->iSidLoadImage = 0;
-	
 	GldiContainer *pContainer = pIcon->pContainer;
 	if (pContainer)
 	{
@@ -268,14 +338,104 @@ static gboolean _load_icon_buffer_idle (Icon *pIcon)
 		//g_print ("icon-factory: do 1 main loop iteration\n");
 		//gtk_main_iteration_do (FALSE);  /// "unforseen consequences" : if _redraw_subdock_content_idle is planned just after, the container-icon stays blank in opengl only. couldn't figure why exactly :-/
 	}
+}
+
+static gboolean _load_icon_buffer_idle (Icon *pIcon)
+{
+	//g_print ("%s (%s; %dx%d; %.2fx%.2f; %x)\n", __func__, pIcon->cName, pIcon->iAllocatedWidth, pIcon->iAllocatedHeight, pIcon->fWidth, pIcon->fHeight, pIcon->pContainer);
+	pIcon->iSidLoadImage = 0;
+	
+	_load_icon_buffer_now (pIcon);
+	_on_icon_load_done (TRUE, FALSE);
 	return FALSE;
 }
+
+typedef struct {
+	Icon *pIcon;
+	gchar *cImagePath;
+	gint iWidth, iHeight;
+	cairo_surface_t *pSurface;
+} CDLoadImageData;
+
+static void _decode_icon_image (CDLoadImageData *pData)  // thread
+{
+	double fWidth, fHeight;
+	pData->pSurface = cairo_dock_create_surface_from_image (pData->cImagePath,
+		1.,
+		pData->iWidth,
+		pData->iHeight,
+		CAIRO_DOCK_FILL_SPACE,
+		&fWidth,
+		&fHeight,
+		NULL,
+		NULL);
+}
+
+static gboolean _load_decoded_icon_image (CDLoadImageData *pData)  // main loop
+{
+	Icon *pIcon = pData->pIcon;
+	gldi_task_discard (pIcon->pLoadImageTask);  // the data are freed once we return.
+	pIcon->pLoadImageTask = NULL;
+	
+	// the icon's loader will search and load the image again: give it the surface we already have.
+	cairo_dock_set_preloaded_surface (pData->cImagePath, pData->iWidth, pData->iHeight, pData->pSurface);
+	pData->pSurface = NULL;
+	_load_icon_buffer_now (pIcon);
+	cairo_dock_set_preloaded_surface (NULL, 0, 0, NULL);  // in case the loader didn't use it (size or image changed meanwhile).
+	
+	_on_icon_load_done (TRUE, TRUE);
+	return FALSE;
+}
+
+static void _free_load_image_data (CDLoadImageData *pData)
+{
+	g_free (pData->cImagePath);
+	if (pData->pSurface != NULL)
+		cairo_surface_destroy (pData->pSurface);
+	g_free (pData);
+}
+
+static gboolean _load_icon_image_in_thread (Icon *pIcon)
+{
+	// only the surface creation is thread-safe, and in OpenGL mode only (in Cairo mode the surfaces are made similar to the X window, in the main thread).
+	if (! g_bUseOpenGL || pIcon->cFileName == NULL || ! GLDI_OBJECT_IS_LAUNCHER_ICON (pIcon))  // launchers are loaded by the default loader, from their image only.
+		return FALSE;
+	int iWidth = cairo_dock_icon_get_allocated_width (pIcon);
+	int iHeight = cairo_dock_icon_get_allocated_height (pIcon);
+	if (iWidth <= 0 || iHeight <= 0)
+		return FALSE;
+	gchar *cImagePath = cairo_dock_search_icon_s_path (pIcon->cFileName, MAX (iWidth, iHeight));  // cached, so we can do it here.
+	if (cImagePath == NULL || *cImagePath == '\0')
+	{
+		g_free (cImagePath);
+		return FALSE;
+	}
+	
+	CDLoadImageData *pData = g_new0 (CDLoadImageData, 1);
+	pData->pIcon = pIcon;
+	pData->cImagePath = cImagePath;
+	pData->iWidth = iWidth;
+	pData->iHeight = iHeight;
+	pIcon->pLoadImageTask = gldi_task_new_full (0,
+		(GldiGetDataAsyncFunc) _decode_icon_image,
+		(GldiUpdateSyncFunc) _load_decoded_icon_image,
+		(GFreeFunc) _free_load_image_data,
+		pData);
+	if (pIcon->pContainer == NULL || gldi_container_is_visible (pIcon->pContainer))
+		gldi_task_launch (pIcon->pLoadImageTask);
+	else  // let the visible icons be loaded first.
+		gldi_task_launch_delayed (pIcon->pLoadImageTask, 0);
+	return TRUE;
+}
+
 void cairo_dock_trigger_load_icon_buffers (Icon *pIcon)
 {
-	if (pIcon->iSidLoadImage == 0)
+	if (pIcon->iSidLoadImage == 0 && pIcon->pLoadImageTask == NULL)
 	{
 		cairo_dock_load_icon_text (pIcon);  // la vue peut avoir besoin de connaitre la taille du texte.
-		pIcon->iSidLoadImage = g_idle_add ((GSourceFunc)_load_icon_buffer_idle, pIcon);
+		_on_icon_load_scheduled ();
+		if (! _load_icon_image_in_thread (pIcon))
+			pIcon->iSidLoadImage = g_idle_add ((GSourceFunc)_load_icon_buffer_idle, pIcon);
 	}
 }
 
@@ -175,7 +175,8 @@ struct _Icon {
 	gint iThumbnailWidth, iThumbnailHeight;
 	
 	gboolean bIsLaunching;  // a mere recopy of gldi_class_is_starting()
-	gpointer reserved[4];
+	GldiTask *pLoadImageTask;  // task decoding the image in a thread, before loading the buffers
+	gpointer reserved[3];
 };
 
 typedef void (*CairoIconContainerLoadFunc) (void);
@@ -293,8 +294,33 @@ void cairo_dock_load_icon_quickinfo (Icon *icon);
 */
 void cairo_dock_load_icon_buffers (Icon *pIcon, GldiContainer *pContainer);
 
+/** Schedule the loading of the buffers of an icon. In OpenGL mode, the image of a launcher is decoded and scaled in a thread, and only the texture is made in the main loop; icons whose container is visible are loaded first.
+*@param pIcon the icon.
+*/
 void cairo_dock_trigger_load_icon_buffers (Icon *pIcon);
 
+/** Cancel the loading of the buffers of an icon, that was scheduled with \ref cairo_dock_trigger_load_icon_buffers.
+*@param pIcon the icon.
+*/
+void cairo_dock_cancel_load_icon_buffers (Icon *pIcon);
+
+/// Times taken to load the icons scheduled with \ref cairo_dock_trigger_load_icon_buffers, measured from the first icon of a series (startup, theme change) until no more icon is waiting.
+typedef struct {
+	/// number of icons loaded.
+	guint iNbLoaded;
+	/// number of them whose image was decoded in a thread.
+	guint iNbDecodedInThread;
+	/// time between the first icon was scheduled and the first icon was loaded, for the last series, in s.
+	double fTimeToFirstIcon;
+	/// time between the first icon was scheduled and all the icons were loaded, for the last series, in s.
+	double fTimeToAllIcons;
+} CairoDockIconLoadStats;
+
+/** Get the counters of the loading of the icons.
+*@param pStats a structure to fill with the counters.
+*/
+void cairo_dock_get_icon_load_stats (CairoDockIconLoadStats *pStats);
+
 
 void cairo_dock_draw_subdock_content_on_icon (Icon *pIcon, CairoDock *pDock);
 
@@ -49,6 +49,7 @@
 #include "cairo-dock-applet-manager.h"  // GLDI_OBJECT_IS_APPLET_ICON
 #include "cairo-dock-backends-manager.h"  // cairo_dock_foreach_icon_container_renderer
 #include "cairo-dock-style-manager.h"
+#include "cairo-dock-image-cache.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-icon-manager.h"
 
@@ -72,6 +73,11 @@ static GtkIconTheme *s_pIconTheme = NULL;
 static gboolean s_bUseLocalIcons = FALSE;
 static gboolean s_bUseDefaultTheme = TRUE;
 static guint s_iSidReloadTheme = 0;
+static GHashTable *s_hIconPathCache = NULL;  // "size:name" -> path, or NULL if the icon has not been found.
+static GHashTable *s_hLocalIconPaths = NULL;  // name -> path in the local icons folder, or NULL if it's not there; searched in advance by some workers.
+static GMutex s_localIconPathsMutex;
+static GFileMonitor *s_pLocalIconsMonitor = NULL;
+static GldiIconPathCacheStats s_iconPathCacheStats = {0, 0};
 
 static void _cairo_dock_unload_icon_textures (void);
 static void _cairo_dock_unload_icon_theme (void);
@@ -221,6 +227,92 @@ gint cairo_dock_search_icon_size (GtkIconSize iIconSize)
 	return MAX (iWidth, iHeight);
 }
 
+  ///////////////////////
+ /// ICON PATH CACHE ///
+///////////////////////
+
+static void _clear_icon_path_cache (void)
+{
+	if (s_hIconPathCache != NULL)
+		g_hash_table_remove_all (s_hIconPathCache);
+	g_mutex_lock (&s_localIconPathsMutex);
+	if (s_hLocalIconPaths != NULL)
+		g_hash_table_remove_all (s_hLocalIconPaths);
+	g_mutex_unlock (&s_localIconPathsMutex);
+}
+
+static gboolean _is_missing_icon (G_GNUC_UNUSED gchar *cKey, gchar *cPath, G_GNUC_UNUSED gpointer data)
+{
+	return (cPath == NULL);
+}
+void cairo_dock_forget_missing_icons (void)
+{
+	if (s_hIconPathCache != NULL)
+		g_hash_table_foreach_remove (s_hIconPathCache, (GHRFunc) _is_missing_icon, NULL);
+}
+
+// GTK only notices that an icon has been installed into the theme when it looks an icon up, which the cache prevents for missing icons; so check it ourselves, but not too often since it stats all the folders of the theme.
+#define ICON_THEME_RESCAN_DELAY (5 * G_USEC_PER_SEC)
+static gboolean _icon_theme_has_changed (void)
+{
+	static gint64 s_iLastRescanTime = 0;
+	gint64 iTime = g_get_monotonic_time ();
+	if (iTime - s_iLastRescanTime < ICON_THEME_RESCAN_DELAY)
+		return FALSE;
+	s_iLastRescanTime = iTime;
+	return gtk_icon_theme_rescan_if_needed (s_pIconTheme);
+}
+
+static void _on_local_icons_changed (G_GNUC_UNUSED GFileMonitor *pMonitor, G_GNUC_UNUSED GFile *pFile, G_GNUC_UNUSED GFile *pOtherFile, GFileMonitorEvent iEventType, G_GNUC_UNUSED gpointer data)
+{
+	switch (iEventType)
+	{
+		case G_FILE_MONITOR_EVENT_CREATED:
+		case G_FILE_MONITOR_EVENT_DELETED:
+		case G_FILE_MONITOR_EVENT_MOVED_IN:
+		case G_FILE_MONITOR_EVENT_MOVED_OUT:
+		case G_FILE_MONITOR_EVENT_RENAMED:
+			cd_debug ("the local icons have changed");
+			_clear_icon_path_cache ();
+		break;
+		default:  // a modified file keeps its path.
+		break;
+	}
+}
+
+static void _start_monitoring_local_icons (void)
+{
+	if (s_pLocalIconsMonitor != NULL || g_cCurrentIconsPath == NULL)
+		return;
+	GFile *pDir = g_file_new_for_path (g_cCurrentIconsPath);
+	GError *erreur = NULL;
+	s_pLocalIconsMonitor = g_file_monitor_directory (pDir, G_FILE_MONITOR_WATCH_MOVES, NULL, &erreur);
+	g_object_unref (pDir);
+	if (erreur != NULL)
+	{
+		cd_warning ("couldn't monitor the local icons folder: %s", erreur->message);
+		g_error_free (erreur);
+		return;
+	}
+	g_signal_connect (s_pLocalIconsMonitor, "changed", G_CALLBACK (_on_local_icons_changed), NULL);
+}
+
+static void _stop_monitoring_local_icons (void)
+{
+	if (s_pLocalIconsMonitor == NULL)
+		return;
+	g_file_monitor_cancel (s_pLocalIconsMonitor);
+	g_object_unref (s_pLocalIconsMonitor);
+	s_pLocalIconsMonitor = NULL;
+}
+
+void cairo_dock_get_icon_path_cache_stats (GldiIconPathCacheStats *pStats)
+{
+	*pStats = s_iconPathCacheStats;
+}
+
+static gchar *_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize);
+
 gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize)
 {
 	g_return_val_if_fail (cFileName != NULL, NULL);
@@ -236,50 +328,121 @@ gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconS
 		return g_strdup (cFileName);
 	}
 	
-	//\_______________________ check for the presence of suffix and version number.
 	g_return_val_if_fail (s_pIconTheme != NULL, NULL);
 	
-	GString *sIconPath = g_string_new ("");
-	const gchar *cSuffixTab[4] = {".svg", ".png", ".xpm", NULL};
-	gboolean bHasSuffix=FALSE, bFileFound=FALSE, bHasVersion=FALSE;
-	GtkIconInfo* pIconInfo = NULL;
+	//\_______________________ look in the cache first, it also remembers the icons that were not found.
+	if (s_hIconPathCache == NULL)
+		s_hIconPathCache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	gchar *cKey = g_strdup_printf ("%d:%s", iDesiredIconSize, cFileName);
+	gpointer pCachedPath;
+	if (g_hash_table_lookup_extended (s_hIconPathCache, cKey, NULL, &pCachedPath))
+	{
+		if (pCachedPath != NULL || ! _icon_theme_has_changed ())
+		{
+			s_iconPathCacheStats.iNbHits ++;
+			g_free (cKey);
+			return g_strdup (pCachedPath);
+		}
+		cd_debug ("the icon theme has changed");
+		_clear_icon_path_cache ();  // the 'changed' signal will only be emitted in idle.
+	}
+	s_iconPathCacheStats.iNbMisses ++;
+	
+	gchar *cIconPath = _search_icon_s_path (cFileName, iDesiredIconSize);
+	g_hash_table_insert (s_hIconPathCache, cKey, g_strdup (cIconPath));  // takes the key
+	return cIconPath;
+}
+
+static const gchar *s_cIconSuffixes[4] = {".svg", ".png", ".xpm", NULL};
+
+static gboolean _icon_has_suffix (const gchar *cFileName)
+{
 	gchar *str = strrchr (cFileName, '.');
 	if (str)
 	{
 		int j = 0;
-		while (cSuffixTab[j] != NULL)
+		while (s_cIconSuffixes[j] != NULL)
+		{
+			if (strcmp(str+1, s_cIconSuffixes[j]) == 0)  // exemple : "firefox.svg", but not "firefox-3.0" or "org.gnome.Calculator"
+				return TRUE;
+			j ++;
+		}
+	}
+	return FALSE;
+}
+
+// the local icons folder is a plain folder, so unlike the icon theme, it can be searched from any thread.
+static gchar *_search_local_icon_s_path (const gchar *cFileName, gboolean bHasSuffix)
+{
+	GString *sIconPath = g_string_new ("");
+	gboolean bFileFound = FALSE;
+	if (! bHasSuffix)  // test all the suffix one by one.
+	{
+		int j = 0;
+		while (s_cIconSuffixes[j] != NULL)
 		{
-			if (strcmp(str+1, cSuffixTab[j]) == 0)  // exemple : "firefox.svg", but not "firefox-3.0" or "org.gnome.Calculator"
+			g_string_printf (sIconPath, "%s/%s%s", g_cCurrentIconsPath, cFileName, s_cIconSuffixes[j]);
+			if ( g_file_test (sIconPath->str, G_FILE_TEST_EXISTS) )
 			{
-				bHasSuffix = TRUE;
+				bFileFound = TRUE;
 				break;
 			}
 			j ++;
 		}
+	}
+	else  // just test the file.
+	{
+		g_string_printf (sIconPath, "%s/%s", g_cCurrentIconsPath, cFileName);
+		bFileFound = g_file_test (sIconPath->str, G_FILE_TEST_EXISTS);
+	}
+	return g_string_free (sIconPath, ! bFileFound);
+}
+
+void cairo_dock_preload_icon_s_path (const gchar *cFileName)
+{
+	if (! s_bUseLocalIcons || cFileName == NULL || *cFileName == '/' || *cFileName == '~')  // paths are not searched.
+		return;
+	gchar *cLocalPath = _search_local_icon_s_path (cFileName, _icon_has_suffix (cFileName));
+	g_mutex_lock (&s_localIconPathsMutex);
+	if (s_hLocalIconPaths == NULL)
+		s_hLocalIconPaths = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	g_hash_table_replace (s_hLocalIconPaths, g_strdup (cFileName), cLocalPath);
+	g_mutex_unlock (&s_localIconPathsMutex);
+}
+
+static gchar *_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize)
+{
+	//\_______________________ check for the presence of suffix and version number.
+	GString *sIconPath = g_string_new ("");
+	gboolean bHasSuffix=FALSE, bFileFound=FALSE, bHasVersion=FALSE;
+	GtkIconInfo* pIconInfo = NULL;
+	gchar *str = strrchr (cFileName, '.');
+	if (str)
+	{
+		bHasSuffix = _icon_has_suffix (cFileName);
 		bHasVersion = (g_ascii_isdigit (*(str+1)) && g_ascii_isdigit (*(str-1)) && str-1 != cFileName);  // doit finir par x.y, x et y ayant autant de chiffres que l'on veut.
 	}
 	
 	//\_______________________ search in the local icons folder if enabled.
 	if (s_bUseLocalIcons)
 	{
-		if (! bHasSuffix)  // test all the suffix one by one.
+		gchar *cLocalPath = NULL;
+		gboolean bSearched = FALSE;
+		g_mutex_lock (&s_localIconPathsMutex);
+		if (s_hLocalIconPaths != NULL)
 		{
-			int j = 0;
-			while (cSuffixTab[j] != NULL)
-			{
-				g_string_printf (sIconPath, "%s/%s%s", g_cCurrentIconsPath, cFileName, cSuffixTab[j]);
-				if ( g_file_test (sIconPath->str, G_FILE_TEST_EXISTS) )
-				{
-					bFileFound = TRUE;
-					break;
-				}
-				j ++;
-			}
+			gpointer pLocalPath;
+			bSearched = g_hash_table_lookup_extended (s_hLocalIconPaths, cFileName, NULL, &pLocalPath);
+			cLocalPath = g_strdup (pLocalPath);
 		}
-		else  // just test the file.
+		g_mutex_unlock (&s_localIconPathsMutex);
+		if (! bSearched)
+			cLocalPath = _search_local_icon_s_path (cFileName, bHasSuffix);
+		if (cLocalPath != NULL)
 		{
-			g_string_printf (sIconPath, "%s/%s", g_cCurrentIconsPath, cFileName);
-			bFileFound = g_file_test (sIconPath->str, G_FILE_TEST_EXISTS);
+			g_string_assign (sIconPath, cLocalPath);
+			g_free (cLocalPath);
+			bFileFound = TRUE;
 		}
 	}
 	
@@ -364,6 +527,7 @@ void cairo_dock_add_path_to_icon_theme (const gchar *cThemePath)
 	gtk_icon_theme_append_search_path (s_pIconTheme,
 		cThemePath);  /// TODO: does it check for unicity ?...
 	gtk_icon_theme_rescan_if_needed (s_pIconTheme);
+	_clear_icon_path_cache ();  // the 'changed' signal is blocked.
 	if (s_bUseDefaultTheme)
 	{
 		g_signal_handlers_unblock_matched (s_pIconTheme,
@@ -400,6 +564,7 @@ void cairo_dock_remove_path_from_icon_theme (const gchar *cThemePath)
 		gtk_icon_theme_set_search_path (s_pIconTheme, (const gchar **)paths, iNbPaths - 1);
 	}
 	g_strfreev (paths);
+	_clear_icon_path_cache ();  // the 'changed' signal is blocked.
 	
 	g_signal_handlers_unblock_matched (s_pIconTheme,
 		(GSignalMatchType) G_SIGNAL_MATCH_FUNC,
@@ -438,6 +603,8 @@ static gboolean get_config (GKeyFile *pKeyFile, CairoIconsParam *pIcons)
 	pIcons->iSinusoidWidth = MAX (1, pIcons->iSinusoidWidth);
 
 	pIcons->iIconGap = cairo_dock_get_integer_key_value (pKeyFile, "Icons", "icon gap", &bFlushConfFileNeeded, 0, NULL, NULL);
+	
+	pIcons->iImageCacheSize = cairo_dock_get_integer_key_value (pKeyFile, "Icons", "image cache size", &bFlushConfFileNeeded, 64, NULL, NULL);
 
 	//\___________________ Ficelle.
 	pIcons->iStringLineWidth = cairo_dock_get_integer_key_value (pKeyFile, "Icons", "string width", &bFlushConfFileNeeded, 0, NULL, NULL);
@@ -686,6 +853,7 @@ static gboolean _on_icon_theme_changed_idle (G_GNUC_UNUSED gpointer data)
 static void _on_icon_theme_changed (G_GNUC_UNUSED GtkIconTheme *pIconTheme, G_GNUC_UNUSED gpointer data)
 {
 	cd_message ("theme has changed");
+	_clear_icon_path_cache ();  // right now, since icons may be searched before the idle.
 	// Reload the icons in idle, because this signal is triggered directly by 'gtk_icon_theme_set_search_path()'; so we may end reloading an applet in the middle of its work (ex.: Status-Notifier when the watcher terminates)
 	if (s_iSidReloadTheme == 0)
 		s_iSidReloadTheme = g_idle_add (_on_icon_theme_changed_idle, NULL);
@@ -705,13 +873,18 @@ static void _cairo_dock_load_icon_theme (void)
 	{
 		s_pIconTheme = gtk_icon_theme_new ();
 		gtk_icon_theme_set_custom_theme (s_pIconTheme, myIconsParam.cIconTheme);
+		g_signal_connect (G_OBJECT (s_pIconTheme), "changed", G_CALLBACK (_on_icon_theme_changed), NULL);  // connected after setting the theme, which emits the signal.
 		s_bUseLocalIcons = FALSE;
 		s_bUseDefaultTheme = FALSE;
 	}
+	if (s_bUseLocalIcons)
+		_start_monitoring_local_icons ();
 }
 
 static void load (void)
 {
+	cairo_dock_image_cache_set_max_size ((gint64)myIconsParam.iImageCacheSize << 20);
+	
 	cairo_dock_create_icon_fbo ();
 	
 	_cairo_dock_load_icon_theme ();
@@ -786,6 +959,9 @@ static void reload (CairoIconsParam *pPrevIcons, CairoIconsParam *pIcons)
 		gldi_docks_foreach ((GHFunc)_reload_separators, GINT_TO_POINTER(bSeparatorsNeedReload));
 	}
 	
+	if (pPrevIcons->iImageCacheSize != pIcons->iImageCacheSize)
+		cairo_dock_image_cache_set_max_size ((gint64)pIcons->iImageCacheSize << 20);
+	
 	gboolean bThemeChanged = (g_strcmp0 (pIcons->cIconTheme, pPrevIcons->cIconTheme) != 0);
 	if (bThemeChanged)
 	{
@@ -863,11 +1039,12 @@ static void _cairo_dock_unload_icon_textures (void)
 }
 static void _cairo_dock_unload_icon_theme (void)
 {
-	if (s_bUseDefaultTheme)
-		g_signal_handlers_disconnect_by_func (G_OBJECT(s_pIconTheme), G_CALLBACK(_on_icon_theme_changed), NULL);
-	else
+	g_signal_handlers_disconnect_by_func (G_OBJECT(s_pIconTheme), G_CALLBACK(_on_icon_theme_changed), NULL);
+	if (! s_bUseDefaultTheme)
 		g_object_unref (s_pIconTheme);
 	s_pIconTheme = NULL;
+	_stop_monitoring_local_icons ();
+	_clear_icon_path_cache ();
 }
 static void unload (void)
 {
@@ -930,6 +1107,8 @@ static gboolean on_style_changed (G_GNUC_UNUSED gpointer data)
 
 static void init (void)
 {
+	cairo_dock_image_cache_init ();
+	
 	gldi_object_register_notification (&myDesktopMgr,
 		NOTIFICATION_DESKTOP_CHANGED,
 		(GldiNotificationFunc) _on_change_current_desktop_viewport_notification,
@@ -1000,8 +1179,7 @@ static void reset_object (GldiObject *obj)
 	
 	if (icon->iSidRedrawSubdockContent != 0)
 		g_source_remove (icon->iSidRedrawSubdockContent);
-	if (icon->iSidLoadImage != 0)  // remove timers after any function that could trigger one (for instance, cairo_dock_deinhibite_class calls cairo_dock_trigger_load_icon_buffers)
-		g_source_remove (icon->iSidLoadImage);
+	cairo_dock_cancel_load_icon_buffers (icon);  // remove timers after any function that could trigger one (for instance, cairo_dock_deinhibite_class calls cairo_dock_trigger_load_icon_buffers)
 	if (icon->iSidDoubleClickDelay != 0)
 		g_source_remove (icon->iSidDoubleClickDelay);
 	
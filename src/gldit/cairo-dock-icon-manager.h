@@ -84,6 +84,8 @@ struct _CairoIconsParam {
 	gboolean bLabelForPointedIconOnly;
 	gint iLabelSize;  // taille des etiquettes des icones, en prenant en compte le contour et la marge.
 	gdouble fLabelAlphaThreshold;
+	// images
+	gint iImageCacheSize;  // maximum size of the image cache, in MB; 0 to disable it.
 	};
 
 /// signals
@@ -106,6 +108,14 @@ typedef enum {
 	NB_NOTIFICATIONS_ICON
 	} CairoIconNotifications;
 
+/// Counters of the cache of icon paths, to measure how many searches it saved.
+typedef struct {
+	/// number of paths found in the cache (including the icons known to be missing).
+	guint iNbHits;
+	/// number of paths searched in the local icons and in the icon theme.
+	guint iNbMisses;
+} GldiIconPathCacheStats;
+
 
 
 /** Execute an action on all icons.
@@ -126,12 +136,27 @@ void cairo_dock_set_specified_desktop_for_icon (Icon *pIcon, int iSpecificDeskto
 gint cairo_dock_search_icon_size (GtkIconSize iIconSize);
 
 /** Search the path of an icon into the defined icons themes. It also handles the '~' caracter in paths.
+ * The result is cached, including when the icon is not found; the cache is cleared when the icon theme or the local icons change, and the missing icons are forgotten when the installed applications change.
  * @param cFileName name of the icon file.
  * @param iDesiredIconSize desired icon size if we use icons from user icons theme.
  * @return the complete path of the icon, or NULL if not found.
  */
 gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize);
 
+/** Search in advance whether an icon is in the local icons folder, so that \ref cairo_dock_search_icon_s_path doesn't have to. It can be called from any thread, for instance while parsing the launchers in parallel; the icon theme can only be used from the main thread though, so the icons that are not in the local folder are still searched in it by \ref cairo_dock_search_icon_s_path.
+ * @param cFileName name of the icon file.
+ */
+void cairo_dock_preload_icon_s_path (const gchar *cFileName);
+
+/** Get the counters of the cache of \ref cairo_dock_search_icon_s_path since the beginning.
+ * @param pStats a structure to fill with the counters.
+ */
+void cairo_dock_get_icon_path_cache_stats (GldiIconPathCacheStats *pStats);
+
+/** Forget the icons that \ref cairo_dock_search_icon_s_path could not find, so that they are searched again next time. Call it when some icons may have been installed, for instance with a new application.
+ */
+void cairo_dock_forget_missing_icons (void);
+
 void cairo_dock_add_path_to_icon_theme (const gchar *cPath);
 
 void cairo_dock_remove_path_from_icon_theme (const gchar *cPath);
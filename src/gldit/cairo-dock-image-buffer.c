@@ -27,6 +27,7 @@
 #include "cairo-dock-draw.h"
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-opengl.h"  // gldi_gl_container_make_current
+#include "cairo-dock-texture-atlas.h"
 #include "cairo-dock-image-buffer.h"
 
 extern gchar *g_cCurrentThemePath;
@@ -171,6 +172,69 @@ void cairo_dock_load_image_buffer_from_surface (CairoDockImageBuffer *pImage, ca
 		pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
 }
 
+void cairo_dock_load_image_buffer_from_surface_in_atlas (CairoDockImageBuffer *pImage, cairo_surface_t *pSurface, int iWidth, int iHeight)
+{
+	if (! g_bUseOpenGL || g_bEasterEggs)  // no atlas with mipmaps, neighbour images would bleed into each other.
+	{
+		cairo_dock_load_image_buffer_from_surface (pImage, pSurface, iWidth, iHeight);
+		return;
+	}
+	if ((iWidth == 0 || iHeight == 0) && pSurface != NULL)  // same as above
+	{
+		cd_warning ("An image has an invalid size, will not be loaded.");
+		pSurface = NULL;
+	}
+	pImage->pSurface = pSurface;
+	pImage->iWidth = iWidth;
+	pImage->iHeight = iHeight;
+	pImage->fZoomX = 1.;
+	pImage->fZoomY = 1.;
+	if (pSurface != NULL)
+	{
+		CairoDockAtlasSlot *pSlot = cairo_dock_atlas_add_image (pImage);
+		if (pSlot != NULL)
+			pImage->iTexture = cairo_dock_atlas_slot_get_texture (pSlot);
+		else  // no room left in the atlas
+			pImage->iTexture = cairo_dock_create_texture_from_surface (pSurface);
+	}
+}
+
+void cairo_dock_image_buffer_move_to_atlas (CairoDockImageBuffer *pImage)
+{
+	if (! g_bUseOpenGL || g_bEasterEggs || cairo_dock_atlas_get_image_slot (pImage) != NULL || cairo_dock_image_buffer_is_animated (pImage))
+		return;
+	CairoDockAtlasSlot *pSlot = cairo_dock_atlas_add_image (pImage);
+	if (pSlot != NULL)
+	{
+		if (pImage->iTexture != 0)
+			_cairo_dock_delete_texture (pImage->iTexture);
+		pImage->iTexture = cairo_dock_atlas_slot_get_texture (pSlot);
+	}
+}
+
+// takes the image out of the atlas, to draw on its own texture.
+static void _take_out_of_atlas (CairoDockImageBuffer *pImage, CairoDockAtlasSlot *pSlot)
+{
+	cairo_dock_atlas_remove_image (pSlot);
+	pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
+}
+
+void cairo_dock_image_buffer_get_texture_coords (const CairoDockImageBuffer *pImage, double *u, double *v, double *du, double *dv)
+{
+	CairoDockAtlasSlot *pSlot = cairo_dock_atlas_get_image_slot (pImage);
+	if (pSlot != NULL)
+	{
+		cairo_dock_atlas_slot_get_texture_coords (pSlot, u, v, du, dv);
+	}
+	else
+	{
+		*u = 0.;
+		*v = 0.;
+		*du = 1.;
+		*dv = 1.;
+	}
+}
+
 void cairo_dock_load_image_buffer_from_texture (CairoDockImageBuffer *pImage, GLuint iTexture, int iWidth, int iHeight)
 {
 	pImage->iTexture = iTexture;
@@ -195,7 +259,12 @@ void cairo_dock_unload_image_buffer (CairoDockImageBuffer *pImage)
 	{
 		cairo_surface_destroy (pImage->pSurface);
 	}
-	if (pImage->iTexture != 0)
+	CairoDockAtlasSlot *pSlot = cairo_dock_atlas_get_image_slot (pImage);
+	if (pSlot != NULL)
+	{
+		cairo_dock_atlas_remove_image (pSlot);
+	}
+	else if (pImage->iTexture != 0)
 	{
 		_cairo_dock_delete_texture (pImage->iTexture);
 	}
@@ -278,6 +347,10 @@ void cairo_dock_apply_image_buffer_surface_with_offset (const CairoDockImageBuff
 void cairo_dock_apply_image_buffer_texture_with_offset (const CairoDockImageBuffer *pImage, double x, double y)
 {
 	glBindTexture (GL_TEXTURE_2D, pImage->iTexture);
+	CairoDockAtlasSlot *pSlot = cairo_dock_atlas_get_image_slot (pImage);
+	double u = 0., v = 0., du = 1., dv = 1.;
+	if (pSlot != NULL)
+		cairo_dock_atlas_slot_get_texture_coords (pSlot, &u, &v, &du, &dv);
 	if (cairo_dock_image_buffer_is_animated (pImage))
 	{
 		int iFrameWidth = pImage->iWidth / pImage->iNbFrames;
@@ -288,8 +361,8 @@ void cairo_dock_apply_image_buffer_texture_with_offset (const CairoDockImageBuff
 		_cairo_dock_set_blend_alpha ();
 		
 		_cairo_dock_set_alpha (1. - dn);
-		_cairo_dock_apply_current_texture_portion_at_size_with_offset ((double)n / pImage->iNbFrames, 0,
-			1. / pImage->iNbFrames, 1.,
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (u + du * n / pImage->iNbFrames, v,
+			du / pImage->iNbFrames, dv,
 			iFrameWidth, pImage->iHeight,
 			x, y);
 		
@@ -297,11 +370,15 @@ void cairo_dock_apply_image_buffer_texture_with_offset (const CairoDockImageBuff
 		if (n2 >= pImage->iNbFrames)
 			n2  = 0;
 		_cairo_dock_set_alpha (dn);
-		_cairo_dock_apply_current_texture_portion_at_size_with_offset ((double)n2 / pImage->iNbFrames, 0,
-			1. / pImage->iNbFrames, 1.,
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (u + du * n2 / pImage->iNbFrames, v,
+			du / pImage->iNbFrames, dv,
 			iFrameWidth, pImage->iHeight,
 			x, y);
 	}
+	else if (pSlot != NULL)
+	{
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (u, v, du, dv, pImage->iWidth, pImage->iHeight, x, y);
+	}
 	else
 	{
 		_cairo_dock_apply_current_texture_at_size_with_offset (pImage->iWidth, pImage->iHeight, x, y);
@@ -353,6 +430,10 @@ void cairo_dock_apply_image_buffer_surface_at_size (const CairoDockImageBuffer *
 void cairo_dock_apply_image_buffer_texture_at_size (const CairoDockImageBuffer *pImage, int w, int h, double x, double y)
 {
 	glBindTexture (GL_TEXTURE_2D, pImage->iTexture);
+	CairoDockAtlasSlot *pSlot = cairo_dock_atlas_get_image_slot (pImage);
+	double u = 0., v = 0., du = 1., dv = 1.;
+	if (pSlot != NULL)
+		cairo_dock_atlas_slot_get_texture_coords (pSlot, &u, &v, &du, &dv);
 	if (cairo_dock_image_buffer_is_animated (pImage))
 	{
 		int n = (int) pImage->iCurrentFrame;
@@ -361,8 +442,8 @@ void cairo_dock_apply_image_buffer_texture_at_size (const CairoDockImageBuffer *
 		_cairo_dock_set_blend_alpha ();
 		
 		_cairo_dock_set_alpha (1. - dn);
-		_cairo_dock_apply_current_texture_portion_at_size_with_offset ((double)n / pImage->iNbFrames, 0,
-			1. / pImage->iNbFrames, 1.,
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (u + du * n / pImage->iNbFrames, v,
+			du / pImage->iNbFrames, dv,
 			w, h,
 			x, y);
 		
@@ -370,11 +451,15 @@ void cairo_dock_apply_image_buffer_texture_at_size (const CairoDockImageBuffer *
 		if (n2 >= pImage->iNbFrames)
 			n2  = 0;
 		_cairo_dock_set_alpha (dn);
-		_cairo_dock_apply_current_texture_portion_at_size_with_offset ((double)n2 / pImage->iNbFrames, 0,
-			1. / pImage->iNbFrames, 1.,
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (u + du * n2 / pImage->iNbFrames, v,
+			du / pImage->iNbFrames, dv,
 			w, h,
 			x, y);
 	}
+	else if (pSlot != NULL)
+	{
+		_cairo_dock_apply_current_texture_portion_at_size_with_offset (u, v, du, dv, w, h, x, y);
+	}
 	else
 	{
 		_cairo_dock_apply_current_texture_at_size_with_offset (w, h, x, y);
@@ -421,23 +506,26 @@ void cairo_dock_apply_image_buffer_texture_with_limit (const CairoDockImageBuffe
 {
 	glBindTexture (GL_TEXTURE_2D, pImage->iTexture);
 	
+	double u, v, du, dv;
+	cairo_dock_image_buffer_get_texture_coords (pImage, &u, &v, &du, &dv);
+	
 	int w = iMaxWidth, h = pImage->iHeight;
-	double u0 = 0., u1 = (double) w / pImage->iWidth;
+	double u0 = u, u1 = du * w / pImage->iWidth;
 	glBegin(GL_QUAD_STRIP);
 	
 	double a = .75;  // 3/4 plain, 1/4 gradation
 	a = (double) (floor ((-.5+a)*w)) / w + .5;
 	glColor4f (1., 1., 1., fAlpha);
-	glTexCoord2f(u0, 0); glVertex3f (-.5*w,  .5*h, 0.);  // top left
-	glTexCoord2f(u0, 1); glVertex3f (-.5*w, -.5*h, 0.);  // bottom left
+	glTexCoord2f(u0, v); glVertex3f (-.5*w,  .5*h, 0.);  // top left
+	glTexCoord2f(u0, v+dv); glVertex3f (-.5*w, -.5*h, 0.);  // bottom left
 	
-	glTexCoord2f(u1*a, 0); glVertex3f ((-.5+a)*w,  .5*h, 0.);  // top middle
-	glTexCoord2f(u1*a, 1); glVertex3f ((-.5+a)*w, -.5*h, 0.);  // bottom middle
+	glTexCoord2f(u0+u1*a, v); glVertex3f ((-.5+a)*w,  .5*h, 0.);  // top middle
+	glTexCoord2f(u0+u1*a, v+dv); glVertex3f ((-.5+a)*w, -.5*h, 0.);  // bottom middle
 	
 	glColor4f (1., 1., 1., 0.);
 	
-	glTexCoord2f(u1, 0); glVertex3f (.5*w,  .5*h, 0.);  // top right
-	glTexCoord2f(u1, 1); glVertex3f (.5*w, -.5*h, 0.);  // bottom right
+	glTexCoord2f(u0+u1, v); glVertex3f (.5*w,  .5*h, 0.);  // top right
+	glTexCoord2f(u0+u1, v+dv); glVertex3f (.5*w, -.5*h, 0.);  // bottom right
 	
 	glEnd();
 }
@@ -501,6 +589,9 @@ void cairo_dock_end_draw_image_buffer_cairo (CairoDockImageBuffer *pImage)
 
 gboolean cairo_dock_begin_draw_image_buffer_opengl (CairoDockImageBuffer *pImage, GldiContainer *pContainer, gint iRenderingMode)
 {
+	CairoDockAtlasSlot *pSlot = cairo_dock_atlas_get_image_slot (pImage);
+	if (pSlot != NULL)  // we can't draw on a part of the atlas, give the image its own texture.
+		_take_out_of_atlas (pImage, pSlot);
 	int iWidth, iHeight;
 	/// TODO: test without FBO and dock when iRenderingMode == 2
 	if (CAIRO_DOCK_IS_DESKLET (pContainer))
@@ -644,7 +735,12 @@ void cairo_dock_end_draw_image_buffer_opengl (CairoDockImageBuffer *pImage, Gldi
 
 void cairo_dock_image_buffer_update_texture (CairoDockImageBuffer *pImage)
 {
-	if (pImage->iTexture == 0)
+	CairoDockAtlasSlot *pSlot = cairo_dock_atlas_get_image_slot (pImage);
+	if (pSlot != NULL)
+	{
+		cairo_dock_atlas_update_image (pSlot);
+	}
+	else if (pImage->iTexture == 0)
 	{
 		pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
 	}
@@ -87,6 +87,25 @@ void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gcha
 *@param iHeight height of the surface
 */
 void cairo_dock_load_image_buffer_from_surface (CairoDockImageBuffer *pImage, cairo_surface_t *pSurface, int iWidth, int iHeight);
+/** Load a surface into an ImageBuffer, and store it in the texture atlas if possible (see cairo-dock-texture-atlas.h) rather than in its own texture. The image should then only be drawn with the cairo_dock_apply_image_buffer_texture* functions, and not be drawn on with \ref cairo_dock_begin_draw_image_buffer_opengl. The ImageBuffer must not be moved in memory (copied into another place and freed) while it's in the atlas.
+*@param pImage an ImageBuffer.
+*@param pSurface a cairo surface
+*@param iWidth width of the surface
+*@param iHeight height of the surface
+*/
+void cairo_dock_load_image_buffer_from_surface_in_atlas (CairoDockImageBuffer *pImage, cairo_surface_t *pSurface, int iWidth, int iHeight);
+/** Move an ImageBuffer that is already loaded into the texture atlas, if possible. Same remarks as \ref cairo_dock_load_image_buffer_from_surface_in_atlas.
+*@param pImage an ImageBuffer.
+*/
+void cairo_dock_image_buffer_move_to_atlas (CairoDockImageBuffer *pImage);
+/** Get the coordinates of an ImageBuffer inside its texture: the whole texture, unless the image is stored in the texture atlas.
+*@param pImage an ImageBuffer.
+*@param u horizontal coordinate of the left side, between 0 and 1.
+*@param v vertical coordinate of the top side, between 0 and 1.
+*@param du width, between 0 and 1.
+*@param dv height, between 0 and 1.
+*/
+void cairo_dock_image_buffer_get_texture_coords (const CairoDockImageBuffer *pImage, double *u, double *v, double *du, double *dv);
 
 void cairo_dock_load_image_buffer_from_texture (CairoDockImageBuffer *pImage, GLuint iTexture, int iWidth, int iHeight);
 
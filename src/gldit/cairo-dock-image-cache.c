@@ -0,0 +1,593 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <glib/gstdio.h>
+#include <cairo.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-task.h"
+#include "cairo-dock-image-cache.h"
+
+extern gboolean g_bUseOpenGL;
+
+#define CD_IMAGE_CACHE_DIR "cairo-dock/images"  // inside the user's cache dir
+#define CD_IMAGE_CACHE_MAGIC 0x43494443  // "CDIC"
+#define CD_IMAGE_CACHE_VERSION 1
+#define CD_IMAGE_CACHE_DEFAULT_MAX_SIZE (64 << 20)  // 64 MB is enough for ~1500 icons of 100x100
+#define CD_IMAGE_CACHE_ALIGN 16  // alignment of the pixels inside a file
+
+// an entry is a file made of this header, the key, and the pixels (aligned).
+typedef struct {
+	guint32 iMagic;
+	guint32 iVersion;
+	gint32 iWidth, iHeight, iStride;
+	guint32 iKeyLength;
+	guint32 iPixelsOffset;
+	guint32 iChecksum;  // of the pixels
+	double fImageWidth, fImageHeight;
+	double fZoomX, fZoomY;
+} CairoDockImageCacheHeader;
+
+typedef struct {
+	gpointer pData;
+	gsize iSize;
+} CairoDockImageCacheMapping;
+
+static GMutex s_mutex;  // images can be loaded in threads (see cairo_dock_trigger_load_icon_buffers)
+static gchar *s_cCacheDir = NULL;
+static gint64 s_iMaxSize = CD_IMAGE_CACHE_DEFAULT_MAX_SIZE;
+static CairoDockImageCacheStats s_cacheStats;
+static cairo_user_data_key_t s_mappingKey;
+static GThread *s_pMainThread = NULL;  // the entries are not written from this one.
+static gint64 s_iInitTime = 0;  // in s; older temporary files were left by a previous run.
+static GldiTask *s_pCheckTask = NULL;
+static GQueue s_pendingWritings = G_QUEUE_INIT;  // entries stored from the main thread, waiting to be written by the task below; protected by the mutex.
+static GldiTask *s_pWriteTask = NULL;
+
+  ///////////////
+ /// ENTRIES ///
+///////////////
+
+static guint32 _compute_checksum (const guchar *pPixels, gsize iSize)  // FNV-1a on 32 bits words; the size is a multiple of 4 (ARGB32)
+{
+	const guint32 *p = (const guint32 *)pPixels;
+	gsize i, n = iSize / 4;
+	guint32 h = 2166136261u;
+	for (i = 0; i < n; i ++)
+		h = (h ^ p[i]) * 16777619u;
+	return h;
+}
+
+static gchar *_make_key (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier)
+{
+	struct stat st;
+	if (g_stat (cImagePath, &st) != 0)
+		return NULL;
+	gchar cMaxScale[G_ASCII_DTOSTR_BUF_SIZE];
+	g_ascii_formatd (cMaxScale, sizeof (cMaxScale), "%.4f", fMaxScale);  // not "%f", the key must not depend on the locale.
+	return g_strdup_printf ("%s\n%lld.%09ld;%lld\n%s;%d;%d;%d",
+		cImagePath,
+		(long long)st.st_mtim.tv_sec, (long)st.st_mtim.tv_nsec, (long long)st.st_size,
+		cMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier);
+}
+
+static gchar *_get_entry_path (const gchar *cKey)
+{
+	gchar *cHash = g_compute_checksum_for_string (G_CHECKSUM_SHA1, cKey, -1);
+	gchar *cPath = g_strdup_printf ("%s/%s", s_cCacheDir, cHash);
+	g_free (cHash);
+	return cPath;
+}
+
+// check that a mapped entry is complete and not corrupted; a NULL key only checks the entry itself.
+static gboolean _entry_is_valid (const guchar *pData, gsize iSize, const gchar *cKey, gboolean *bCorrupted)
+{
+	const CairoDockImageCacheHeader *pHeader = (const CairoDockImageCacheHeader *)pData;
+	*bCorrupted = TRUE;
+	if (iSize < sizeof (CairoDockImageCacheHeader)
+	|| pHeader->iMagic != CD_IMAGE_CACHE_MAGIC
+	|| pHeader->iVersion != CD_IMAGE_CACHE_VERSION)
+		return FALSE;
+	if (pHeader->iWidth <= 0 || pHeader->iHeight <= 0
+	|| pHeader->iStride != cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, pHeader->iWidth)
+	|| pHeader->iPixelsOffset % CD_IMAGE_CACHE_ALIGN != 0
+	|| pHeader->iPixelsOffset < sizeof (CairoDockImageCacheHeader) + pHeader->iKeyLength
+	|| (gsize)pHeader->iPixelsOffset + (gsize)pHeader->iStride * pHeader->iHeight != iSize)
+		return FALSE;
+	if (cKey != NULL && (strlen (cKey) != pHeader->iKeyLength
+		|| memcmp (pData + sizeof (CairoDockImageCacheHeader), cKey, pHeader->iKeyLength) != 0))
+	{
+		*bCorrupted = FALSE;  // same hash for another key; it will just be replaced.
+		return FALSE;
+	}
+	if (_compute_checksum (pData + pHeader->iPixelsOffset, (gsize)pHeader->iStride * pHeader->iHeight) != pHeader->iChecksum)
+		return FALSE;
+	*bCorrupted = FALSE;
+	return TRUE;
+}
+
+static void _unmap_entry (CairoDockImageCacheMapping *pMapping)
+{
+	munmap (pMapping->pData, pMapping->iSize);
+	g_free (pMapping);
+}
+
+static gboolean _init_cache (void)  // called with the mutex locked
+{
+	if (s_cCacheDir != NULL)
+		return TRUE;
+	gchar *cCacheDir = g_strdup_printf ("%s/%s", g_get_user_cache_dir (), CD_IMAGE_CACHE_DIR);
+	if (g_mkdir_with_parents (cCacheDir, 7*8*8+7*8+5) != 0)
+	{
+		cd_warning ("couldn't create the image cache in '%s'", cCacheDir);
+		g_free (cCacheDir);
+		s_iMaxSize = 0;  // don't try again
+		return FALSE;
+	}
+	s_cCacheDir = cCacheDir;
+
+	// get the current size of the cache.
+	GDir *dir = g_dir_open (s_cCacheDir, 0, NULL);
+	if (dir != NULL)
+	{
+		const gchar *cFileName;
+		struct stat st;
+		while ((cFileName = g_dir_read_name (dir)) != NULL)
+		{
+			gchar *cPath = g_strdup_printf ("%s/%s", s_cCacheDir, cFileName);
+			if (g_stat (cPath, &st) == 0)
+				s_cacheStats.iSize += st.st_size;
+			g_free (cPath);
+		}
+		g_dir_close (dir);
+	}
+	return TRUE;
+}
+
+static gboolean _cache_is_enabled (void)  // called with the mutex locked
+{
+	return (g_bUseOpenGL && s_iMaxSize > 0 && _init_cache ());
+}
+
+  ////////////////
+ /// EVICTION ///
+////////////////
+
+typedef struct {
+	gchar *cPath;
+	gint64 iSize;
+	gint64 iLastUse;
+} CairoDockImageCacheFile;
+
+static int _compare_last_use (const CairoDockImageCacheFile *f1, const CairoDockImageCacheFile *f2)
+{
+	return (f1->iLastUse < f2->iLastUse ? -1 : f1->iLastUse > f2->iLastUse ? 1 : 0);
+}
+
+static void _evict_entries (gint64 iTargetSize)  // called with the mutex locked
+{
+	// the last use of an entry is its modification time, which is updated when it's used.
+	GArray *pFiles = g_array_new (FALSE, FALSE, sizeof (CairoDockImageCacheFile));
+	GDir *dir = g_dir_open (s_cCacheDir, 0, NULL);
+	if (dir == NULL)
+	{
+		g_array_free (pFiles, TRUE);
+		return;
+	}
+	const gchar *cFileName;
+	struct stat st;
+	gint64 iSize = 0;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		CairoDockImageCacheFile f;
+		f.cPath = g_strdup_printf ("%s/%s", s_cCacheDir, cFileName);
+		if (g_stat (f.cPath, &st) != 0)
+		{
+			g_free (f.cPath);
+			continue;
+		}
+		f.iSize = st.st_size;
+		f.iLastUse = (gint64)st.st_mtim.tv_sec * G_USEC_PER_SEC + st.st_mtim.tv_nsec / 1000;
+		iSize += f.iSize;
+		g_array_append_val (pFiles, f);
+	}
+	g_dir_close (dir);
+
+	g_array_sort (pFiles, (GCompareFunc) _compare_last_use);
+	guint i;
+	for (i = 0; i < pFiles->len; i ++)
+	{
+		CairoDockImageCacheFile *f = &g_array_index (pFiles, CairoDockImageCacheFile, i);
+		if (iSize > iTargetSize && g_unlink (f->cPath) == 0)
+		{
+			iSize -= f->iSize;
+			s_cacheStats.iNbEvicted ++;
+		}
+		g_free (f->cPath);
+	}
+	g_array_free (pFiles, TRUE);
+	s_cacheStats.iSize = iSize;  // re-synchronize with the actual content of the folder.
+}
+
+  /////////////
+ /// CACHE ///
+/////////////
+
+cairo_surface_t *cairo_dock_image_cache_lookup (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	g_return_val_if_fail (cImagePath != NULL, NULL);
+	g_mutex_lock (&s_mutex);
+	if (! _cache_is_enabled ())
+	{
+		g_mutex_unlock (&s_mutex);
+		return NULL;
+	}
+	g_mutex_unlock (&s_mutex);
+
+	gchar *cKey = _make_key (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier);
+	if (cKey == NULL)  // no such image
+		return NULL;
+	gchar *cEntryPath = _get_entry_path (cKey);
+
+	cairo_surface_t *pSurface = NULL;
+	gboolean bCorrupted = FALSE;
+	int fd = open (cEntryPath, O_RDONLY);
+	if (fd >= 0)
+	{
+		struct stat st;
+		if (fstat (fd, &st) == 0 && st.st_size > 0)
+		{
+			// map the file privately and writable: the surface can be drawn on (for instance by an applet) without modifying the file.
+			guchar *pData = mmap (NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			if (pData != MAP_FAILED)
+			{
+				if (_entry_is_valid (pData, st.st_size, cKey, &bCorrupted))
+				{
+					const CairoDockImageCacheHeader *pHeader = (const CairoDockImageCacheHeader *)pData;
+					pSurface = cairo_image_surface_create_for_data (pData + pHeader->iPixelsOffset,
+						CAIRO_FORMAT_ARGB32,
+						pHeader->iWidth,
+						pHeader->iHeight,
+						pHeader->iStride);
+					CairoDockImageCacheMapping *pMapping = g_new (CairoDockImageCacheMapping, 1);
+					pMapping->pData = pData;
+					pMapping->iSize = st.st_size;
+					cairo_surface_set_user_data (pSurface, &s_mappingKey, pMapping, (cairo_destroy_func_t) _unmap_entry);  // the pixels stay mapped as long as the surface is alive.
+					*fImageWidth = pHeader->fImageWidth;
+					*fImageHeight = pHeader->fImageHeight;
+					if (fZoomX != NULL)
+						*fZoomX = pHeader->fZoomX;
+					if (fZoomY != NULL)
+						*fZoomY = pHeader->fZoomY;
+					futimens (fd, NULL);  // mark it as recently used.
+				}
+				else
+					munmap (pData, st.st_size);
+			}
+		}
+		else
+			bCorrupted = TRUE;
+		close (fd);
+	}
+
+	g_mutex_lock (&s_mutex);
+	if (pSurface != NULL)
+		s_cacheStats.iNbHits ++;
+	else
+	{
+		s_cacheStats.iNbMisses ++;
+		if (bCorrupted)
+		{
+			cd_warning ("the cached image of '%s' is corrupted, it is removed", cImagePath);
+			struct stat st;
+			if (g_stat (cEntryPath, &st) == 0 && g_unlink (cEntryPath) == 0)
+				s_cacheStats.iSize -= st.st_size;
+			s_cacheStats.iNbCorrupted ++;
+		}
+	}
+	g_mutex_unlock (&s_mutex);
+
+	g_free (cEntryPath);
+	g_free (cKey);
+	return pSurface;
+}
+
+static void _write_entry (const gchar *cKey, const CairoDockImageCacheHeader *pHeader, const guchar *pPixels)  // not in the main thread
+{
+	gsize iPixelsSize = (gsize)pHeader->iStride * pHeader->iHeight;
+
+	// write into a temporary file and rename it, so that an entry is never seen half-written.
+	gchar *cEntryPath = _get_entry_path (cKey);
+	gchar *cTmpPath = g_strdup_printf ("%s.XXXXXX", cEntryPath);
+	int fd = g_mkstemp (cTmpPath);
+	if (fd < 0)
+	{
+		cd_warning ("couldn't write in the image cache (%s)", s_cCacheDir);
+		g_free (cTmpPath);
+		g_free (cEntryPath);
+		return;
+	}
+	guchar padding[CD_IMAGE_CACHE_ALIGN] = {0};
+	gsize iPaddingSize = pHeader->iPixelsOffset - sizeof (CairoDockImageCacheHeader) - pHeader->iKeyLength;
+	gboolean bWritten = (write (fd, pHeader, sizeof (CairoDockImageCacheHeader)) == sizeof (CairoDockImageCacheHeader)
+		&& write (fd, cKey, pHeader->iKeyLength) == (gssize)pHeader->iKeyLength
+		&& write (fd, padding, iPaddingSize) == (gssize)iPaddingSize
+		&& write (fd, pPixels, iPixelsSize) == (gssize)iPixelsSize);
+	close (fd);
+
+	g_mutex_lock (&s_mutex);
+	struct stat st;
+	gint64 iPrevSize = (g_stat (cEntryPath, &st) == 0 ? st.st_size : 0);
+	if (bWritten && g_rename (cTmpPath, cEntryPath) == 0)
+	{
+		s_cacheStats.iNbStored ++;
+		s_cacheStats.iSize += pHeader->iPixelsOffset + iPixelsSize - iPrevSize;
+		if (s_cacheStats.iSize > s_iMaxSize)
+			_evict_entries (s_iMaxSize * 3 / 4);  // leave some room, so that we don't scan the folder on each new image.
+	}
+	else
+	{
+		cd_warning ("couldn't write in the image cache (%s)", s_cCacheDir);
+		g_unlink (cTmpPath);
+	}
+	g_mutex_unlock (&s_mutex);
+
+	g_free (cTmpPath);
+	g_free (cEntryPath);
+}
+
+typedef struct {
+	gchar *cKey;
+	CairoDockImageCacheHeader header;  // with the checksum of the pixels at the time the image was stored.
+	cairo_surface_t *pSurface;  // a reference on the image; it can be drawn on in the meantime, in which case it's not written.
+} CairoDockImageCacheWriting;
+
+static void _free_writing (CairoDockImageCacheWriting *pWriting)
+{
+	g_free (pWriting->cKey);
+	cairo_surface_destroy (pWriting->pSurface);
+	g_free (pWriting);
+}
+
+static void _write_pending_entries (G_GNUC_UNUSED gpointer data)  // thread
+{
+	guchar *pPixels = NULL;  // one buffer for all the entries, that holds a copy of the pixels while they're written.
+	gsize iBufferSize = 0;
+	CairoDockImageCacheWriting *pWriting;
+	while (TRUE)
+	{
+		g_mutex_lock (&s_mutex);
+		pWriting = g_queue_pop_head (&s_pendingWritings);
+		g_mutex_unlock (&s_mutex);
+		if (pWriting == NULL)
+			break;
+		
+		gsize iPixelsSize = (gsize)pWriting->header.iStride * pWriting->header.iHeight;
+		if (iPixelsSize > iBufferSize)
+		{
+			pPixels = g_realloc (pPixels, iPixelsSize);
+			iBufferSize = iPixelsSize;
+		}
+		memcpy (pPixels, cairo_image_surface_get_data (pWriting->pSurface), iPixelsSize);
+		if (_compute_checksum (pPixels, iPixelsSize) == pWriting->header.iChecksum)
+			_write_entry (pWriting->cKey, &pWriting->header, pPixels);
+		else
+			cd_debug ("an image has been modified before it could be cached, skip it");
+		_free_writing (pWriting);
+	}
+	g_free (pPixels);
+}
+
+static gboolean _launch_write_task (G_GNUC_UNUSED gpointer data)
+{
+	gldi_task_launch (s_pWriteTask);
+	return FALSE;
+}
+
+static gboolean _on_pending_entries_written (G_GNUC_UNUSED gpointer data)
+{
+	// an entry may have been queued after the task found the queue empty, but before it was over (so it couldn't be launched); launch it again once it's over.
+	g_mutex_lock (&s_mutex);
+	gboolean bPending = ! g_queue_is_empty (&s_pendingWritings);
+	g_mutex_unlock (&s_mutex);
+	if (bPending)
+		g_idle_add (_launch_write_task, NULL);
+	return FALSE;
+}
+
+void cairo_dock_image_cache_store (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, cairo_surface_t *pSurface, double fImageWidth, double fImageHeight, double fZoomX, double fZoomY)
+{
+	g_return_if_fail (cImagePath != NULL);
+	if (pSurface == NULL
+	|| cairo_surface_get_type (pSurface) != CAIRO_SURFACE_TYPE_IMAGE
+	|| cairo_image_surface_get_format (pSurface) != CAIRO_FORMAT_ARGB32
+	|| cairo_surface_get_user_data (pSurface, &s_mappingKey) != NULL)  // already in the cache
+		return;
+	g_mutex_lock (&s_mutex);
+	gboolean bEnabled = _cache_is_enabled ();
+	gint64 iMaxSize = s_iMaxSize;
+	g_mutex_unlock (&s_mutex);
+	if (! bEnabled)
+		return;
+
+	cairo_surface_flush (pSurface);
+	CairoDockImageCacheHeader header;
+	memset (&header, 0, sizeof (header));
+	header.iWidth = cairo_image_surface_get_width (pSurface);
+	header.iHeight = cairo_image_surface_get_height (pSurface);
+	header.iStride = cairo_image_surface_get_stride (pSurface);
+	if (header.iWidth <= 0 || header.iHeight <= 0
+	|| header.iStride != cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, header.iWidth))
+		return;
+	gsize iPixelsSize = (gsize)header.iStride * header.iHeight;
+	if ((gint64)iPixelsSize > iMaxSize / 8)  // a huge image (a background for instance) would evict all the icons.
+		return;
+	gchar *cKey = _make_key (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier);
+	if (cKey == NULL)
+		return;
+	const guchar *pPixels = cairo_image_surface_get_data (pSurface);
+	header.iMagic = CD_IMAGE_CACHE_MAGIC;
+	header.iVersion = CD_IMAGE_CACHE_VERSION;
+	header.iKeyLength = strlen (cKey);
+	header.iPixelsOffset = (sizeof (header) + header.iKeyLength + CD_IMAGE_CACHE_ALIGN - 1) / CD_IMAGE_CACHE_ALIGN * CD_IMAGE_CACHE_ALIGN;
+	header.fImageWidth = fImageWidth;
+	header.fImageHeight = fImageHeight;
+	header.fZoomX = fZoomX;
+	header.fZoomY = fZoomY;
+	header.iChecksum = _compute_checksum (pPixels, iPixelsSize);
+
+	if (g_thread_self () != s_pMainThread)  // the image has been loaded by a task (see cairo_dock_trigger_load_icon_buffers), we can write it right away.
+	{
+		_write_entry (cKey, &header, pPixels);
+		g_free (cKey);
+	}
+	else  // don't block the main loop on the disk, queue it for the task that writes the entries.
+	{
+		CairoDockImageCacheWriting *pWriting = g_new (CairoDockImageCacheWriting, 1);
+		pWriting->cKey = cKey;
+		pWriting->header = header;
+		pWriting->pSurface = cairo_surface_reference (pSurface);
+		g_mutex_lock (&s_mutex);
+		g_queue_push_tail (&s_pendingWritings, pWriting);
+		g_mutex_unlock (&s_mutex);
+		if (s_pWriteTask == NULL)
+			s_pWriteTask = gldi_task_new (0,
+				(GldiGetDataAsyncFunc) _write_pending_entries,
+				(GldiUpdateSyncFunc) _on_pending_entries_written,
+				NULL);
+		gldi_task_launch (s_pWriteTask);  // does nothing if it's already writing the queue.
+	}
+}
+
+void cairo_dock_image_cache_set_max_size (gint64 iMaxSize)
+{
+	g_mutex_lock (&s_mutex);
+	s_iMaxSize = MAX (iMaxSize, 0);
+	if (s_cCacheDir != NULL && s_cacheStats.iSize > s_iMaxSize)
+		_evict_entries (s_iMaxSize);
+	g_mutex_unlock (&s_mutex);
+}
+
+guint cairo_dock_image_cache_check (void)
+{
+	// the folder is scanned without locking the cache, so that the images can be looked up meanwhile; the files are replaced atomically, and a removed entry stays valid as long as it's mapped.
+	g_mutex_lock (&s_mutex);
+	gboolean bInit = _init_cache ();
+	g_mutex_unlock (&s_mutex);
+	if (! bInit)
+		return 0;
+	GDir *dir = g_dir_open (s_cCacheDir, 0, NULL);
+	if (dir == NULL)
+		return 0;
+	guint iNbRemoved = 0;
+	const gchar *cFileName;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		gchar *cPath = g_strdup_printf ("%s/%s", s_cCacheDir, cFileName);
+		gboolean bCorrupted = TRUE;
+		gsize iSize = 0;
+		struct stat st;
+		if (strchr (cFileName, '.') != NULL)  // a temporary file (see _write_entry); it's being written, unless it was left by a crash.
+		{
+			if (g_stat (cPath, &st) == 0 && st.st_mtime < s_iInitTime)
+				iSize = st.st_size;
+			else
+				bCorrupted = FALSE;
+		}
+		else
+		{
+			int fd = open (cPath, O_RDONLY);
+			if (fd >= 0)
+			{
+				if (fstat (fd, &st) == 0 && st.st_size > 0)
+				{
+					iSize = st.st_size;
+					guchar *pData = mmap (NULL, iSize, PROT_READ, MAP_PRIVATE, fd, 0);
+					if (pData != MAP_FAILED)
+					{
+						_entry_is_valid (pData, iSize, NULL, &bCorrupted);
+						munmap (pData, iSize);
+					}
+				}
+				close (fd);
+			}
+		}
+		if (bCorrupted && g_unlink (cPath) == 0)
+		{
+			g_mutex_lock (&s_mutex);
+			s_cacheStats.iSize -= iSize;
+			s_cacheStats.iNbCorrupted ++;
+			g_mutex_unlock (&s_mutex);
+			iNbRemoved ++;
+		}
+		g_free (cPath);
+	}
+	g_dir_close (dir);
+	return iNbRemoved;
+}
+
+static void _check_cache (guint *iNbRemoved)  // thread
+{
+	*iNbRemoved = cairo_dock_image_cache_check ();
+}
+
+static gboolean _on_cache_checked (guint *iNbRemoved)
+{
+	if (*iNbRemoved != 0)
+		cd_message ("%u corrupted or unfinished entries removed from the image cache", *iNbRemoved);
+	gldi_task_discard (s_pCheckTask);
+	s_pCheckTask = NULL;
+	return FALSE;
+}
+
+void cairo_dock_image_cache_init (void)
+{
+	s_pMainThread = g_thread_self ();
+	s_iInitTime = g_get_real_time () / G_USEC_PER_SEC;
+	
+	// clean the cache in the background, it reads all the entries.
+	if (s_pCheckTask != NULL)
+		return;
+	s_pCheckTask = gldi_task_new_full (0,
+		(GldiGetDataAsyncFunc) _check_cache,
+		(GldiUpdateSyncFunc) _on_cache_checked,
+		(GFreeFunc) g_free,
+		g_new0 (guint, 1));
+	gldi_task_launch (s_pCheckTask);
+}
+
+void cairo_dock_image_cache_clear (void)
+{
+	g_mutex_lock (&s_mutex);
+	if (_init_cache ())
+		_evict_entries (0);
+	g_mutex_unlock (&s_mutex);
+}
+
+void cairo_dock_image_cache_get_stats (CairoDockImageCacheStats *pStats)
+{
+	g_mutex_lock (&s_mutex);
+	*pStats = s_cacheStats;
+	g_mutex_unlock (&s_mutex);
+}
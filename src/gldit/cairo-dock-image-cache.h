@@ -0,0 +1,108 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_IMAGE_CACHE__
+#define  __CAIRO_DOCK_IMAGE_CACHE__
+
+#include <glib.h>
+#include <cairo.h>
+
+#include "cairo-dock-struct.h"
+#include "cairo-dock-surface-factory.h"  // CairoDockLoadImageModifier
+
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-image-cache.h A persistent cache of the images loaded from files, so that they don't need to be decoded and rasterized again on the next start.
+* Each image is stored once loaded at a given size, in a file of the cache folder (in the user's cache dir, usually ~/.cache/cairo-dock/images), as premultiplied ARGB32 pixels. The entry is found again from the path of the image, its modification time and size, and the parameters of the loading; so a modified image is simply loaded again.
+* The files are mapped into memory, and the surfaces are created over the mapped pixels without any copy. Each entry holds a checksum of its pixels, that is verified before it is used; a corrupted entry is removed.
+* The size of the cache is limited; when it's exceeded, the least recently used entries are removed.
+* The cache is only used in OpenGL mode, where the images are loaded as image surfaces; it is used by \ref cairo_dock_create_surface_from_image, so you shouldn't have to use it directly.
+*/
+
+/// Counters of the image cache.
+typedef struct {
+	/// number of images found in the cache.
+	guint iNbHits;
+	/// number of images that were not in the cache.
+	guint iNbMisses;
+	/// number of images added to the cache.
+	guint iNbStored;
+	/// number of entries removed to keep the cache under its maximum size.
+	guint iNbEvicted;
+	/// number of corrupted entries found and removed.
+	guint iNbCorrupted;
+	/// current size of the cache, in bytes.
+	gint64 iSize;
+} CairoDockImageCacheStats;
+
+/** Look for an image in the cache. The parameters are the ones of \ref cairo_dock_create_surface_from_image.
+*@param cImagePath path of the image.
+*@param fMaxScale maximum zoom of the image.
+*@param iWidthConstraint constraint on the width, or 0 to not constraint it.
+*@param iHeightConstraint constraint on the height, or 0 to not constraint it.
+*@param iLoadingModifier modifier of the image loading.
+*@param fImageWidth pointer to the width of the image, filled if the image is found.
+*@param fImageHeight pointer to the height of the image, filled if the image is found.
+*@param fZoomX pointer to the horizontal zoom applied on the image, or NULL.
+*@param fZoomY pointer to the vertical zoom applied on the image, or NULL.
+*@return a surface over the mapped pixels, or NULL if the image is not in the cache.
+*/
+cairo_surface_t *cairo_dock_image_cache_lookup (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY);
+
+/** Add an image into the cache, once it has been loaded by \ref cairo_dock_create_surface_from_image. Nothing is done if the surface is not an image surface. From the main thread, the image is queued and written by a task, so that the main loop doesn't wait for the disk; if it's drawn on before it's written, it's not cached.
+*@param cImagePath path of the image.
+*@param fMaxScale maximum zoom of the image.
+*@param iWidthConstraint constraint on the width, or 0 to not constraint it.
+*@param iHeightConstraint constraint on the height, or 0 to not constraint it.
+*@param iLoadingModifier modifier of the image loading.
+*@param pSurface the surface that was loaded.
+*@param fImageWidth width of the image.
+*@param fImageHeight height of the image.
+*@param fZoomX horizontal zoom applied on the image.
+*@param fZoomY vertical zoom applied on the image.
+*/
+void cairo_dock_image_cache_store (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, cairo_surface_t *pSurface, double fImageWidth, double fImageHeight, double fZoomX, double fZoomY);
+
+/** Initialize the cache. It must be called from the main thread, before any image is loaded. The corrupted entries and the temporary files left by a previous run are removed in the background (see \ref cairo_dock_image_cache_check).
+*/
+void cairo_dock_image_cache_init (void);
+
+/** Set the maximum size of the cache. The least recently used entries are removed if the cache is bigger.
+*@param iMaxSize the size in bytes, 0 to disable the cache.
+*/
+void cairo_dock_image_cache_set_max_size (gint64 iMaxSize);
+
+/** Verify all the entries of the cache, and remove the ones that are corrupted, as well as the temporary files that were left by a previous run. It reads the whole cache, so it's better to call it from a thread.
+*@return the number of entries removed.
+*/
+guint cairo_dock_image_cache_check (void);
+
+/** Remove all the entries of the cache.
+*/
+void cairo_dock_image_cache_clear (void);
+
+/** Get the counters of the image cache.
+*@param pStats a structure to fill with the counters.
+*/
+void cairo_dock_image_cache_get_stats (CairoDockImageCacheStats *pStats);
+
+G_END_DECLS
+#endif
@@ -21,12 +21,88 @@
 #include <stdlib.h>
 
 #include "cairo-dock-log.h"
+#include "cairo-dock-timer.h"
+#include "cairo-dock-task.h"
+#include "cairo-dock-trace.h"
 #include "cairo-dock-keyfile-utilities.h"
 
+// the updates of the conf files are merged in memory, and written a little later by a worker, so that a series of changes (like moving a desklet or reordering icons) only writes each file once.
+#define CD_KEYFILE_WRITE_DELAY 1000  // ms; a change postpones the writing by this delay...
+#define CD_KEYFILE_MAX_WRITE_DELAY 5000  // ... but not more than this delay after the first change.
+
+typedef struct {
+	GKeyFile *pUpdates;  // only the updated values
+	gboolean bFileExisted;  // whether the file existed at the time of the first update.
+} CDPendingUpdates;
+
+static GHashTable *s_hPendingUpdates = NULL;  // path -> CDPendingUpdates
+static GMutex s_pendingMutex;  // protects the table of pending updates and the counters
+static GMutex s_writeMutex;  // held while writing some updates, so that the files are written in the order of their updates.
+static GldiTask *s_pWriteTask = NULL;
+static guint s_iSidWriteTimer = 0;
+static gint64 s_iFirstPendingTime = 0;
+static CairoDockKeyFileStats s_keyfileStats;
+
+static void _write_keys_to_file (GKeyFile *pKeyFile, const gchar *cConfFilePath);
+
+// conf files parsed in advance by some workers (at startup), and taken by the first call to cairo_dock_open_key_file.
+typedef struct {
+	GKeyFile *pKeyFile;  // NULL until it's parsed.
+	gboolean bParsing;  // a worker is parsing it; the entry is not removed until it's done.
+} CDPreloadedKeyFile;
+
+typedef struct {
+	gchar *cConfFilePath;
+	CairoDockPreloadKeyFileFunc pFunc;
+} CDPreloadJob;
+
+static GHashTable *s_hPreloadedKeyFiles = NULL;  // path -> CDPreloadedKeyFile
+static GMutex s_preloadMutex;
+static GCond s_preloadCond;  // signaled when a worker has parsed a file.
+static gint s_iNbParsing = 0;
+static GThreadPool *s_pPreloadPool = NULL;
+
+static void _free_preloaded_key_file (CDPreloadedKeyFile *pPreloaded)
+{
+	if (pPreloaded->pKeyFile != NULL)
+		g_key_file_free (pPreloaded->pKeyFile);
+	g_free (pPreloaded);
+}
+
+// remove a file from the preloaded ones, and get its key-file if it has been parsed; must be called with the mutex locked.
+static GKeyFile *_remove_preloaded_key_file (const gchar *cConfFilePath)
+{
+	CDPreloadedKeyFile *pPreloaded;
+	while ((pPreloaded = g_hash_table_lookup (s_hPreloadedKeyFiles, cConfFilePath)) != NULL && pPreloaded->bParsing)  // waiting for it is shorter than parsing it again.
+		g_cond_wait (&s_preloadCond, &s_preloadMutex);
+	if (pPreloaded == NULL)
+		return NULL;
+	GKeyFile *pKeyFile = pPreloaded->pKeyFile;  // NULL if no worker has taken it yet: the caller will parse it, and the worker will skip it.
+	pPreloaded->pKeyFile = NULL;
+	g_hash_table_remove (s_hPreloadedKeyFiles, cConfFilePath);
+	return pKeyFile;
+}
+
+static GKeyFile *_take_preloaded_key_file (const gchar *cConfFilePath)
+{
+	if (s_hPreloadedKeyFiles == NULL)
+		return NULL;
+	g_mutex_lock (&s_preloadMutex);
+	GKeyFile *pKeyFile = _remove_preloaded_key_file (cConfFilePath);
+	g_mutex_unlock (&s_preloadMutex);
+	return pKeyFile;
+}
+
 
 GKeyFile *cairo_dock_open_key_file (const gchar *cConfFilePath)
 {
-	GKeyFile *pKeyFile = g_key_file_new ();
+	cairo_dock_flush_keyfile (cConfFilePath);  // get the values that are waiting to be written.
+	
+	GKeyFile *pKeyFile = _take_preloaded_key_file (cConfFilePath);
+	if (pKeyFile != NULL)
+		return pKeyFile;
+	
+	pKeyFile = g_key_file_new ();
 	GError *erreur = NULL;
 	g_key_file_load_from_file (pKeyFile, cConfFilePath, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &erreur);
 	if (erreur != NULL)
@@ -40,6 +116,13 @@ GKeyFile *cairo_dock_open_key_file (const gchar *cConfFilePath)
 }
 
 void cairo_dock_write_keys_to_file (GKeyFile *pKeyFile, const gchar *cConfFilePath)
+{
+	cairo_dock_flush_keyfile (cConfFilePath);  // write the previous updates first, as if they had been written at once.
+	g_key_file_free (_take_preloaded_key_file (cConfFilePath));  // it's outdated now.
+	_write_keys_to_file (pKeyFile, cConfFilePath);
+}
+
+static void _write_keys_to_file (GKeyFile *pKeyFile, const gchar *cConfFilePath)
 {
 	cd_debug ("%s (%s)", __func__, cConfFilePath);
 	GError *erreur = NULL;
@@ -399,12 +482,105 @@ gchar * cairo_dock_get_locale_string_from_conf_file (GKeyFile *pKeyFile, const g
 	return g_key_file_get_locale_string (pKeyFile, cGroupName, cKeyName, cLocale, NULL);
 }
 
+  ///////////////////////
+ /// DELAYED UPDATES ///
+///////////////////////
+
+static void _free_pending_updates (CDPendingUpdates *pPending)
+{
+	g_key_file_free (pPending->pUpdates);
+	g_free (pPending);
+}
+
+static void _apply_updates (const gchar *cConfFilePath, CDPendingUpdates *pPending)
+{
+	if (pPending->bFileExisted && ! g_file_test (cConfFilePath, G_FILE_TEST_EXISTS))  // the file has been removed in the meantime (for instance the icon has been deleted), don't create it again.
+		return;
+	GKeyFile *pUpdates = pPending->pUpdates;
+	GKeyFile *pKeyFile = g_key_file_new ();  // if the key-file doesn't exist, it will be created.
+	g_key_file_load_from_file (pKeyFile, cConfFilePath, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, NULL);
+	
+	gchar **pGroupList = g_key_file_get_groups (pUpdates, NULL);
+	gchar **pKeyList, *cValue;
+	int i, j;
+	for (i = 0; pGroupList[i] != NULL; i ++)
+	{
+		pKeyList = g_key_file_get_keys (pUpdates, pGroupList[i], NULL, NULL);
+		for (j = 0; pKeyList[j] != NULL; j ++)
+		{
+			cValue = g_key_file_get_value (pUpdates, pGroupList[i], pKeyList[j], NULL);
+			g_key_file_set_value (pKeyFile, pGroupList[i], pKeyList[j], cValue);
+			g_free (cValue);
+		}
+		g_strfreev (pKeyList);
+	}
+	g_strfreev (pGroupList);
+	
+	_write_keys_to_file (pKeyFile, cConfFilePath);  // g_file_set_contents() writes into a temporary file and renames it, so the file is never partially written.
+	g_key_file_free (pKeyFile);
+	g_mutex_lock (&s_pendingMutex);  // the files are written in a worker.
+	s_keyfileStats.iNbWrites ++;
+	g_mutex_unlock (&s_pendingMutex);
+}
+
+static void _write_pending_updates (G_GNUC_UNUSED gpointer data)  // in a worker.
+{
+	g_mutex_lock (&s_writeMutex);
+	
+	// take all the pending updates; new updates will be written the next time.
+	g_mutex_lock (&s_pendingMutex);
+	GHashTable *pUpdates = s_hPendingUpdates;
+	s_hPendingUpdates = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) _free_pending_updates);
+	g_mutex_unlock (&s_pendingMutex);
+	
+	GHashTableIter iter;
+	gpointer cConfFilePath, pPending;
+	g_hash_table_iter_init (&iter, pUpdates);
+	while (g_hash_table_iter_next (&iter, &cConfFilePath, &pPending))
+		_apply_updates (cConfFilePath, pPending);
+	g_hash_table_destroy (pUpdates);
+	
+	g_mutex_unlock (&s_writeMutex);
+}
+
+static gboolean _write_timer (G_GNUC_UNUSED gpointer data);
+static gboolean _on_updates_written (G_GNUC_UNUSED gpointer data)
+{
+	// some updates may have come while we were writing, or the task may have been busy when the timer expired.
+	g_mutex_lock (&s_pendingMutex);
+	gboolean bPending = (g_hash_table_size (s_hPendingUpdates) != 0);
+	g_mutex_unlock (&s_pendingMutex);
+	if (bPending && s_iSidWriteTimer == 0)
+		s_iSidWriteTimer = gldi_timer_add (CD_KEYFILE_WRITE_DELAY, _write_timer, NULL);
+	return FALSE;
+}
+
+static gboolean _write_timer (G_GNUC_UNUSED gpointer data)
+{
+	s_iSidWriteTimer = 0;
+	s_iFirstPendingTime = 0;
+	if (s_pWriteTask == NULL)
+		s_pWriteTask = gldi_task_new (0, (GldiGetDataAsyncFunc) _write_pending_updates, (GldiUpdateSyncFunc) _on_updates_written, NULL);
+	gldi_task_launch (s_pWriteTask);  // if it's still writing, the updates will be written when it's done.
+	return FALSE;
+}
+
 void cairo_dock_update_keyfile_va_args (const gchar *cConfFilePath, GType iFirstDataType, va_list args)
 {
 	cd_message ("%s (%s)", __func__, cConfFilePath);
+	if (s_hPendingUpdates == NULL)
+		s_hPendingUpdates = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) _free_pending_updates);
 	
-	GKeyFile *pKeyFile = g_key_file_new ();  // if the key-file doesn't exist, it will be created.
-	g_key_file_load_from_file (pKeyFile, cConfFilePath, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, NULL);
+	g_mutex_lock (&s_pendingMutex);
+	CDPendingUpdates *pPending = g_hash_table_lookup (s_hPendingUpdates, cConfFilePath);  // merge with the previous updates of this file.
+	if (pPending == NULL)
+	{
+		pPending = g_new0 (CDPendingUpdates, 1);
+		pPending->pUpdates = g_key_file_new ();
+		pPending->bFileExisted = g_file_test (cConfFilePath, G_FILE_TEST_EXISTS);
+		g_hash_table_insert (s_hPendingUpdates, g_strdup (cConfFilePath), pPending);
+	}
+	GKeyFile *pKeyFile = pPending->pUpdates;
 	
 	GType iType = iFirstDataType;
 	gboolean bValue;
@@ -441,9 +617,177 @@ void cairo_dock_update_keyfile_va_args (const gchar *cConfFilePath, GType iFirst
 
 		iType = va_arg (args, GType);
 	}
+	s_keyfileStats.iNbUpdates ++;
+	g_mutex_unlock (&s_pendingMutex);
+	g_key_file_free (_take_preloaded_key_file (cConfFilePath));  // it's outdated now.
+	
+	// (re)schedule the writing.
+	gint64 t = g_get_monotonic_time ();
+	if (s_iFirstPendingTime == 0)
+		s_iFirstPendingTime = t;
+	if (t - s_iFirstPendingTime < CD_KEYFILE_MAX_WRITE_DELAY * 1000 || s_iSidWriteTimer == 0)
+	{
+		if (s_iSidWriteTimer != 0)
+			gldi_timer_remove (s_iSidWriteTimer);
+		s_iSidWriteTimer = gldi_timer_add (CD_KEYFILE_WRITE_DELAY, _write_timer, NULL);
+	}
+}
 
-	cairo_dock_write_keys_to_file (pKeyFile, cConfFilePath);
-	g_key_file_free (pKeyFile);
+void cairo_dock_flush_keyfile (const gchar *cConfFilePath)
+{
+	if (s_hPendingUpdates == NULL)  // nothing has been updated yet.
+		return;
+	g_mutex_lock (&s_writeMutex);  // wait for the updates being written, if any.
+	
+	g_mutex_lock (&s_pendingMutex);
+	gchar *cKey = NULL;
+	CDPendingUpdates *pPending = NULL;
+	g_hash_table_lookup_extended (s_hPendingUpdates, cConfFilePath, (gpointer*)&cKey, (gpointer*)&pPending);
+	if (pPending != NULL)
+	{
+		g_hash_table_steal (s_hPendingUpdates, cConfFilePath);
+		s_keyfileStats.iNbFlushes ++;
+	}
+	g_mutex_unlock (&s_pendingMutex);
+	
+	if (pPending != NULL)
+	{
+		_apply_updates (cConfFilePath, pPending);
+		_free_pending_updates (pPending);
+		g_free (cKey);
+	}
+	
+	g_mutex_unlock (&s_writeMutex);
+}
+
+void cairo_dock_discard_keyfile_updates (const gchar *cConfFilePath)
+{
+	g_key_file_free (_take_preloaded_key_file (cConfFilePath));  // the file will not be opened as it is now.
+	if (s_hPendingUpdates == NULL)  // nothing has been updated yet.
+		return;
+	g_mutex_lock (&s_writeMutex);  // if the file is being written, wait until it's done, so that it's not re-created afterwards.
+	g_mutex_lock (&s_pendingMutex);
+	g_hash_table_remove (s_hPendingUpdates, cConfFilePath);
+	g_mutex_unlock (&s_pendingMutex);
+	g_mutex_unlock (&s_writeMutex);
+}
+
+void cairo_dock_flush_all_keyfiles (void)
+{
+	if (s_hPendingUpdates == NULL)
+		return;
+	if (s_iSidWriteTimer != 0)
+	{
+		gldi_timer_remove (s_iSidWriteTimer);
+		s_iSidWriteTimer = 0;
+	}
+	s_iFirstPendingTime = 0;
+	_write_pending_updates (NULL);  // waits for the worker if it's writing.
+}
+
+  //////////////////
+ /// PRELOADING ///
+//////////////////
+
+static void _preload_key_file (CDPreloadJob *pJob, G_GNUC_UNUSED gpointer data)  // in a worker.
+{
+	// skip the file if it has been opened or forgotten in the meantime.
+	g_mutex_lock (&s_preloadMutex);
+	CDPreloadedKeyFile *pPreloaded = g_hash_table_lookup (s_hPreloadedKeyFiles, pJob->cConfFilePath);
+	if (pPreloaded != NULL && (pPreloaded->bParsing || pPreloaded->pKeyFile != NULL))  // the file has been forgotten and queued again, and another job has it.
+		pPreloaded = NULL;
+	if (pPreloaded != NULL)
+	{
+		pPreloaded->bParsing = TRUE;
+		s_iNbParsing ++;
+	}
+	g_mutex_unlock (&s_preloadMutex);
+	
+	if (pPreloaded != NULL)
+	{
+		gldi_trace_begin_with_arg ("parse", "keyfile", pJob->cConfFilePath);
+		GKeyFile *pKeyFile = g_key_file_new ();
+		gboolean bLoaded = g_key_file_load_from_file (pKeyFile, pJob->cConfFilePath, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, NULL);
+		if (bLoaded && pJob->pFunc != NULL)
+			pJob->pFunc (pKeyFile, pJob->cConfFilePath);
+		gldi_trace_end ("parse", "keyfile");
+		
+		g_mutex_lock (&s_preloadMutex);
+		pPreloaded->bParsing = FALSE;
+		s_iNbParsing --;
+		if (bLoaded)
+			pPreloaded->pKeyFile = pKeyFile;
+		else  // the error will be reported when the file is opened.
+		{
+			g_key_file_free (pKeyFile);
+			g_hash_table_remove (s_hPreloadedKeyFiles, pJob->cConfFilePath);
+		}
+		g_cond_broadcast (&s_preloadCond);
+		g_mutex_unlock (&s_preloadMutex);
+	}
+	g_free (pJob->cConfFilePath);
+	g_free (pJob);
+}
+
+void cairo_dock_preload_key_files (gchar **cConfFilePaths, CairoDockPreloadKeyFileFunc pFunc)
+{
+	g_return_if_fail (cConfFilePaths != NULL);
+	if (s_pPreloadPool == NULL)
+	{
+		GError *erreur = NULL;
+		s_pPreloadPool = g_thread_pool_new ((GFunc) _preload_key_file, NULL, g_get_num_processors (), FALSE, &erreur);  // FALSE <=> the threads are shared with the other pools.
+		if (erreur != NULL)  // the files will just be parsed when they're opened.
+		{
+			cd_warning ("couldn't preload the conf files: %s", erreur->message);
+			g_error_free (erreur);
+			return;
+		}
+		s_hPreloadedKeyFiles = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) _free_preloaded_key_file);
+	}
+	cairo_dock_flush_all_keyfiles ();  // the files must be up-to-date.
+	
+	// don't wait for the workers: the files are taken as they're opened, and the ones that are not parsed yet are just parsed by the caller.
+	CDPreloadJob *pJob;
+	gboolean bPreloaded;
+	int i;
+	for (i = 0; cConfFilePaths[i] != NULL; i ++)
+	{
+		g_mutex_lock (&s_preloadMutex);
+		bPreloaded = g_hash_table_contains (s_hPreloadedKeyFiles, cConfFilePaths[i]);
+		if (! bPreloaded)
+			g_hash_table_insert (s_hPreloadedKeyFiles, g_strdup (cConfFilePaths[i]), g_new0 (CDPreloadedKeyFile, 1));
+		g_mutex_unlock (&s_preloadMutex);
+		if (bPreloaded)  // already parsed or queued.
+			continue;
+		
+		pJob = g_new0 (CDPreloadJob, 1);
+		pJob->cConfFilePath = g_strdup (cConfFilePaths[i]);
+		pJob->pFunc = pFunc;
+		g_thread_pool_push (s_pPreloadPool, pJob, NULL);
+	}
+}
+
+void cairo_dock_clear_preloaded_key_files (void)
+{
+	if (s_hPreloadedKeyFiles == NULL)
+		return;
+	g_mutex_lock (&s_preloadMutex);
+	while (s_iNbParsing != 0)  // the files being parsed can't be removed; the ones that are waiting will be skipped.
+		g_cond_wait (&s_preloadCond, &s_preloadMutex);
+	g_hash_table_remove_all (s_hPreloadedKeyFiles);
+	g_mutex_unlock (&s_preloadMutex);
+}
+
+void cairo_dock_get_keyfile_stats (CairoDockKeyFileStats *pStats)
+{
+	if (s_hPendingUpdates == NULL)  // nothing has been updated yet.
+	{
+		memset (pStats, 0, sizeof (CairoDockKeyFileStats));
+		return;
+	}
+	g_mutex_lock (&s_pendingMutex);
+	*pStats = s_keyfileStats;
+	g_mutex_unlock (&s_pendingMutex);
 }
 
 void cairo_dock_update_keyfile (const gchar *cConfFilePath, GType iFirstDataType, ...)  // type, groupe, cle, valeur, etc. finir par G_TYPE_INVALID.
@@ -88,10 +88,53 @@ gchar * cairo_dock_get_locale_string_from_conf_file (GKeyFile *pKeyFile, const g
 void cairo_dock_update_keyfile_va_args (const gchar *cConfFilePath, GType iFirstDataType, va_list args);
 
 /** Update a conf file with a list of values of the form : {type, name of the groupe, name of the key, value}. Must end with G_TYPE_INVALID.
+*The values are not written immediately: they are merged with the other updates of the file, and written all at once a little later, by a worker. The conf file is always read with its latest values by \ref cairo_dock_open_key_file though.
 *@param cConfFilePath path to the conf file.
 *@param iFirstDataType type of the first value.
 */
 void cairo_dock_update_keyfile (const gchar *cConfFilePath, GType iFirstDataType, ...);
 
+/** Write the values of a conf file that are waiting to be written, if any. It is done automatically when the file is opened or written with the functions of this file, but must be called before reading or copying the file by other means.
+*@param cConfFilePath path to the conf file.
+*/
+void cairo_dock_flush_keyfile (const gchar *cConfFilePath);
+
+/** Forget the values of a conf file that are waiting to be written, if any. It must be called before deleting the file, so that it's not written again afterwards.
+*@param cConfFilePath path to the conf file.
+*/
+void cairo_dock_discard_keyfile_updates (const gchar *cConfFilePath);
+
+/** Write all the values that are waiting to be written. It must be called before quitting.
+*/
+void cairo_dock_flush_all_keyfiles (void);
+
+/// Function called by \ref cairo_dock_preload_key_files on each key-file it has parsed, in a worker thread.
+typedef void (*CairoDockPreloadKeyFileFunc) (GKeyFile *pKeyFile, const gchar *cConfFilePath);
+
+/** Parse some conf files in advance, in parallel on several threads. It returns at once: the next call to \ref cairo_dock_open_key_file on one of these files will return it directly if it's parsed, or wait for it if it's being parsed, or else parse it by itself.
+*@param cConfFilePaths a NULL-terminated array of paths.
+*@param pFunc function called on each key-file once it's parsed, in a worker thread, or NULL.
+*/
+void cairo_dock_preload_key_files (gchar **cConfFilePaths, CairoDockPreloadKeyFileFunc pFunc);
+
+/** Forget the conf files that have been parsed in advance and not opened.
+*/
+void cairo_dock_clear_preloaded_key_files (void);
+
+/// Counters of the updates of the conf files.
+typedef struct {
+	/// number of calls to \ref cairo_dock_update_keyfile.
+	guint iNbUpdates;
+	/// number of times a conf file has been written with some updates.
+	guint iNbWrites;
+	/// number of times the updates of a conf file had to be written immediately, because the file was read.
+	guint iNbFlushes;
+} CairoDockKeyFileStats;
+
+/** Get the counters of the updates of the conf files.
+*@param pStats a structure to fill with the counters.
+*/
+void cairo_dock_get_keyfile_stats (CairoDockKeyFileStats *pStats);
+
 G_END_DECLS
 #endif
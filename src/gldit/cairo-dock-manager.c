@@ -23,6 +23,7 @@
 #include "cairo-dock-log.h"
 #include "cairo-dock-module-manager.h"  // GldiVisitCard (for gldi_extend_manager)
 #include "cairo-dock-keyfile-utilities.h"
+#include "cairo-dock-trace.h"
 #define __MANAGER_DEF__
 #include "cairo-dock-manager.h"
 
@@ -50,13 +51,21 @@ static void _gldi_init_manager (GldiManager *pManager)
 	
 	// init the manager
 	if (pManager->init)
+	{
+		gldi_trace_begin (pManager->cModuleName, "manager-init");
 		pManager->init ();
+		gldi_trace_end (pManager->cModuleName, "manager-init");
+	}
 }
 
 static inline void _gldi_load_manager (GldiManager *pManager)
 {
 	if (pManager->load)
+	{
+		gldi_trace_begin (pManager->cModuleName, "manager-load");
 		pManager->load ();
+		gldi_trace_end (pManager->cModuleName, "manager-load");
+	}
 }
 
 static inline void _gldi_unload_manager (GldiManager *pManager)
@@ -104,7 +113,10 @@ static gboolean gldi_manager_get_config (GldiManager *pManager, GKeyFile *pKeyFi
 		pManager->reset_config (pManager->pConfig);
 	}
 	memset (pManager->pConfig, 0, pManager->iSizeOfConfig);
-	return pManager->get_config (pKeyFile, pManager->pConfig);
+	gldi_trace_begin (pManager->cModuleName, "manager-config");
+	gboolean bFlushConfFileNeeded = pManager->get_config (pKeyFile, pManager->pConfig);
+	gldi_trace_end (pManager->cModuleName, "manager-config");
+	return bFlushConfFileNeeded;
 }
 
 
@@ -34,6 +34,7 @@
 #include "cairo-dock-data-renderer.h"
 #include "cairo-dock-themes-manager.h"  // cairo_dock_update_conf_file
 #include "cairo-dock-module-manager.h"
+#include "cairo-dock-trace.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-module-instance-manager.h"
 
@@ -447,7 +448,11 @@ static void init_object (GldiObject *obj, gpointer attr)
 		_read_module_config (pKeyFile, pInstance);
 	
 	if (pModule->pInterface->initModule)
+	{
+		gldi_trace_begin_with_arg (pModule->pVisitCard->cModuleName, "module-init", pInstance->cConfFilePath);
 		pModule->pInterface->initModule (pInstance, pKeyFile);
+		gldi_trace_end (pModule->pVisitCard->cModuleName, "module-init");
+	}
 	
 	if (pDesklet && pDesklet->iDesiredWidth == 0 && pDesklet->iDesiredHeight == 0)  // can happen if the desklet has already resized itself before the init.
 		gtk_widget_queue_draw (pDesklet->container.pWidget);
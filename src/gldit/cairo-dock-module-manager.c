@@ -26,6 +26,7 @@
 #include "gldi-module-config.h"
 #include "cairo-dock-dock-manager.h"
 #include "cairo-dock-themes-manager.h"  // cairo_dock_add_conf_file
+#include "cairo-dock-keyfile-utilities.h"  // cairo_dock_preload_key_files
 #include "cairo-dock-file-manager.h"  // cairo_dock_copy_file
 #include "cairo-dock-log.h"
 #include "cairo-dock-applet-manager.h"
@@ -354,6 +355,7 @@ void gldi_module_activate (GldiModule *module)
 		if (n == 0)  // no conf file was present.
 		{
 			gchar *cConfFilePath = g_strdup_printf ("%s/%s", cUserDataDirPath, module->pVisitCard->cConfFileName);
+			cairo_dock_flush_keyfile (module->cConfFilePath);  // the file is copied as it is.
 			gboolean r = cairo_dock_copy_file (module->cConfFilePath, cConfFilePath);
 			if (! r)  // the copy failed.
 			{
@@ -389,6 +391,36 @@ void gldi_module_deactivate (GldiModule *module)  // stop all instances of a mod
 }
 
 
+static void _add_conf_files (GldiModule *pModule, GPtrArray *pFiles)
+{
+	if (pModule->pVisitCard->cConfFileName == NULL || pModule->pInstancesList != NULL)
+		return;
+	gchar *cUserDataDirPath = gldi_module_get_config_dir (pModule);
+	if (cUserDataDirPath == NULL)
+		return;
+	if (pModule->pVisitCard->bMultiInstance)  // same as in gldi_module_activate()
+	{
+		GDir *dir = g_dir_open (cUserDataDirPath, 0, NULL);
+		if (dir != NULL)
+		{
+			const gchar *cFileName;
+			gchar *str;
+			while ((cFileName = g_dir_read_name (dir)) != NULL)
+			{
+				str = strstr (cFileName, ".conf");
+				if (str && (*(str+5) == '-' || *(str+5) == '\0'))
+					g_ptr_array_add (pFiles, g_strdup_printf ("%s/%s", cUserDataDirPath, cFileName));
+			}
+			g_dir_close (dir);
+		}
+	}
+	else
+	{
+		g_ptr_array_add (pFiles, g_strdup_printf ("%s/%s", cUserDataDirPath, pModule->pVisitCard->cConfFileName));
+	}
+	g_free (cUserDataDirPath);
+}
+
 void gldi_modules_activate_from_list (gchar **cActiveModuleList)
 {
 	//\_______________ On active les modules auto-charges en premier.
@@ -407,9 +439,21 @@ void gldi_modules_activate_from_list (gchar **cActiveModuleList)
 	if (cActiveModuleList == NULL)
 		return ;
 	
-	//\_______________ On active tous les autres.
+	//\_______________ parse all their conf files in parallel.
+	GPtrArray *pFiles = g_ptr_array_new_with_free_func (g_free);
 	int i;
 	for (i = 0; cActiveModuleList[i] != NULL; i ++)
+	{
+		pModule = g_hash_table_lookup (s_hModuleTable, cActiveModuleList[i]);
+		if (pModule != NULL)
+			_add_conf_files (pModule, pFiles);
+	}
+	g_ptr_array_add (pFiles, NULL);
+	cairo_dock_preload_key_files ((gchar**)pFiles->pdata, NULL);
+	g_ptr_array_free (pFiles, TRUE);
+	
+	//\_______________ On active tous les autres.
+	for (i = 0; cActiveModuleList[i] != NULL; i ++)
 	{
 		cModuleName = cActiveModuleList[i];
 		pModule = g_hash_table_lookup (s_hModuleTable, cModuleName);
@@ -424,6 +468,7 @@ void gldi_modules_activate_from_list (gchar **cActiveModuleList)
 			gldi_module_activate (pModule);
 		}
 	}
+	cairo_dock_clear_preloaded_key_files ();
 	
 	// don't write down
 	if (s_iSidWriteModules != 0)
@@ -18,6 +18,7 @@
 */
 
 #include <math.h>
+#include <string.h>
 #include <pango/pango.h>
 #include <cairo.h>
 #include <GL/gl.h>
@@ -26,6 +27,10 @@
 #include "cairo-dock-draw.h"  // cairo_dock_create_drawing_context_generic
 #include "cairo-dock-log.h"
 #include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-image-buffer.h"  // cairo_dock_load_image_buffer_from_surface_in_atlas
+#include "cairo-dock-render-batch.h"
+#include "cairo-dock-style-manager.h"  // myStyleParam, gldi_style_colors_set_bg_color
+#include "cairo-dock-desktop-manager.h"  // gldi_desktop_get_width
 
 #include "cairo-dock-opengl-font.h"
 
@@ -36,6 +41,47 @@ extern GldiContainer *g_pPrimaryContainer;
 
 extern CairoDockGLConfig g_openglConfig;
 
+// glyph texts
+#define CD_GL_TEXT_MAX_GLYPHS 1024  // the cache is emptied when it grows bigger, which only happens if many different fonts/sizes are used.
+
+typedef struct {
+	PangoFont *pFont;  // a font has a given description and size.
+	PangoGlyph iGlyph;
+} CDGlyphKey;
+
+typedef struct {
+	CDGlyphKey key;
+	CairoDockImageBuffer image;  // the glyph in white, loaded into the atlas; empty for a blank glyph.
+	int x, y;  // position of the image relatively to the origin of the glyph.
+} CDGlyph;
+
+typedef struct {
+	CDGlyph *pGlyph;
+	GLfloat x, y;  // top-left corner of the glyph in the text.
+} CDGlyphQuad;
+
+struct _CairoDockGLText {
+	PangoLayout *pLayout;  // kept from one text to the other, along with its font.
+	GString *sText;
+	gboolean bUseMarkup;
+	GArray *pQuads;  // the glyphs to draw (CDGlyphQuad)
+	guint iGeneration;  // generation of the glyph cache that the quads belong to.
+	int iWidth, iHeight;
+	double fZoomX;
+	double fOffsetX, fOffsetY;  // position of the layout in the text.
+	gboolean bOutlined;
+	GldiColor fTextColor;
+	// background
+	gboolean bDrawBackground;
+	CairoDockImageBuffer bg;  // the 2 rounded ends of the frame, and a column of its middle.
+	double fBgParams[10];  // parameters the background was drawn with.
+};
+
+static GHashTable *s_hGlyphs = NULL;  // CDGlyphKey -> CDGlyph
+static guint s_iGlyphGeneration = 1;
+static PangoContext *s_pPangoContext = NULL;
+static CairoDockGLTextStats s_textStats;
+
 
 GLuint cairo_dock_create_texture_from_text_simple (const gchar *cText, const gchar *cFontDescription, cairo_t* pSourceContext, int *iWidth, int *iHeight)
 {
@@ -409,3 +455,366 @@ void cairo_dock_draw_gl_text_at_position_in_area (const guchar *cText, CairoDock
 		cairo_dock_draw_gl_text_in_area (cText, pFont, iWidth, iHeight, bCentered);
 	}
 }
+
+
+  ///////////////////
+ /// GLYPH TEXTS ///
+///////////////////
+
+static guint _glyph_hash (const CDGlyphKey *pKey)
+{
+	return g_direct_hash (pKey->pFont) ^ (pKey->iGlyph * 2654435761u);
+}
+
+static gboolean _glyph_equal (const CDGlyphKey *pKey1, const CDGlyphKey *pKey2)
+{
+	return (pKey1->pFont == pKey2->pFont && pKey1->iGlyph == pKey2->iGlyph);
+}
+
+static void _free_glyph (CDGlyph *pGlyph)
+{
+	cairo_dock_unload_image_buffer (&pGlyph->image);
+	g_object_unref (pGlyph->key.pFont);
+	g_free (pGlyph);
+}
+
+static CDGlyph *_get_glyph (PangoFont *pFont, PangoGlyph iGlyph)
+{
+	CDGlyphKey key = {pFont, iGlyph};
+	CDGlyph *pGlyph = g_hash_table_lookup (s_hGlyphs, &key);
+	if (pGlyph != NULL)
+		return pGlyph;
+	
+	pGlyph = g_new0 (CDGlyph, 1);
+	pGlyph->key.pFont = g_object_ref (pFont);
+	pGlyph->key.iGlyph = iGlyph;
+	
+	PangoRectangle ink;
+	pango_font_get_glyph_extents (pFont, iGlyph, &ink, NULL);
+	pango_extents_to_pixels (&ink, NULL);  // rounds outwards
+	if (ink.width > 0 && ink.height > 0)
+	{
+		//\_________________ draw the glyph in white, with a margin of 1 pixel for the anti-aliasing.
+		pGlyph->x = ink.x - 1;
+		pGlyph->y = ink.y - 1;
+		int iWidth = ink.width + 2, iHeight = ink.height + 2;
+		cairo_surface_t *pSurface = cairo_dock_create_blank_surface (iWidth, iHeight);
+		cairo_t *pCairoContext = cairo_create (pSurface);
+		cairo_set_source_rgb (pCairoContext, 1., 1., 1.);
+		cairo_move_to (pCairoContext, - pGlyph->x, - pGlyph->y);  // the glyph is drawn on its baseline.
+		PangoGlyphString *pGlyphString = pango_glyph_string_new ();
+		pango_glyph_string_set_size (pGlyphString, 1);
+		memset (&pGlyphString->glyphs[0], 0, sizeof (PangoGlyphInfo));
+		pGlyphString->glyphs[0].glyph = iGlyph;
+		pGlyphString->glyphs[0].attr.is_cluster_start = 1;
+		pGlyphString->log_clusters[0] = 0;
+		pango_cairo_show_glyph_string (pCairoContext, pFont, pGlyphString);
+		pango_glyph_string_free (pGlyphString);
+		cairo_destroy (pCairoContext);
+		
+		//\_________________ keep only the coverage: the glyph will be colorized by the color of its quad, and blended like any texture.
+		if (cairo_surface_get_type (pSurface) == CAIRO_SURFACE_TYPE_IMAGE)
+		{
+			cairo_surface_flush (pSurface);
+			guchar *pPixels = cairo_image_surface_get_data (pSurface);
+			int iStride = cairo_image_surface_get_stride (pSurface);
+			int i, j;
+			guint32 *pRow;
+			for (j = 0; j < iHeight; j ++)
+			{
+				pRow = (guint32*)(pPixels + j * iStride);
+				for (i = 0; i < iWidth; i ++)
+					pRow[i] |= 0x00FFFFFF;
+			}
+			cairo_surface_mark_dirty (pSurface);
+		}
+		
+		cairo_dock_load_image_buffer_from_surface_in_atlas (&pGlyph->image, pSurface, iWidth, iHeight);  // takes the surface
+		s_textStats.iNbRasterizedGlyphs ++;
+	}
+	
+	g_hash_table_insert (s_hGlyphs, &pGlyph->key, pGlyph);
+	return pGlyph;
+}
+
+static void _layout_glyphs (CairoDockGLText *pText)
+{
+	if (g_hash_table_size (s_hGlyphs) > CD_GL_TEXT_MAX_GLYPHS)  // too many glyphs, start again from scratch; the other texts will be laid out again when drawn.
+	{
+		g_hash_table_remove_all (s_hGlyphs);
+		s_iGlyphGeneration ++;
+	}
+	
+	g_array_set_size (pText->pQuads, 0);
+	PangoLayoutIter *pIter = pango_layout_get_iter (pText->pLayout);
+	PangoLayoutRun *pRun;
+	PangoGlyphInfo *pInfo;
+	CDGlyph *pGlyph;
+	CDGlyphQuad quad;
+	PangoRectangle log;
+	int iBaseline, x, i;
+	do
+	{
+		pRun = pango_layout_iter_get_run_readonly (pIter);
+		if (pRun == NULL)  // end of a line
+			continue;
+		iBaseline = pango_layout_iter_get_baseline (pIter);
+		pango_layout_iter_get_run_extents (pIter, NULL, &log);
+		x = log.x;
+		for (i = 0; i < pRun->glyphs->num_glyphs; i ++)
+		{
+			pInfo = &pRun->glyphs->glyphs[i];
+			if (pInfo->glyph != PANGO_GLYPH_EMPTY && ! (pInfo->glyph & PANGO_GLYPH_UNKNOWN_FLAG))
+			{
+				pGlyph = _get_glyph (pRun->item->analysis.font, pInfo->glyph);
+				if (pGlyph->image.iWidth != 0)
+				{
+					quad.pGlyph = pGlyph;
+					quad.x = pText->fOffsetX + ((double)(x + pInfo->geometry.x_offset) / PANGO_SCALE + pGlyph->x) * pText->fZoomX;
+					quad.y = pText->fOffsetY + (double)(iBaseline + pInfo->geometry.y_offset) / PANGO_SCALE + pGlyph->y;
+					if (pText->fZoomX == 1)  // place the glyphs on the grid, to keep them sharp.
+						quad.x = round (quad.x);
+					quad.y = round (quad.y);
+					g_array_append_val (pText->pQuads, quad);
+				}
+			}
+			x += pInfo->geometry.width;
+		}
+	}
+	while (pango_layout_iter_next_run (pIter));
+	pango_layout_iter_free (pIter);
+	
+	pText->iGeneration = s_iGlyphGeneration;
+	s_textStats.iNbLayouts ++;
+}
+
+static void _load_background (CairoDockGLText *pText, GldiTextDescription *pTextDescription, double fRadius, double fLineWidth)
+{
+	//\_________________ get the colors, and check if the current background can be kept.
+	GldiColor bg, line;
+	if (pTextDescription->bUseDefaultColors)
+	{
+		gldi_style_color_get (GLDI_COLOR_BG, &bg);
+		gldi_style_color_get (GLDI_COLOR_LINE, &line);
+	}
+	else
+	{
+		bg = pTextDescription->fBackgroundColor;
+		line = pTextDescription->fLineColor;
+	}
+	double fParams[10] = {pText->iHeight, fRadius,
+		bg.rgba.red, bg.rgba.green, bg.rgba.blue, bg.rgba.alpha,
+		line.rgba.red, line.rgba.green, line.rgba.blue, line.rgba.alpha};
+	if (pText->bg.iWidth != 0 && memcmp (fParams, pText->fBgParams, sizeof (fParams)) == 0)
+		return;
+	memcpy (pText->fBgParams, fParams, sizeof (fParams));
+	
+	//\_________________ draw the frame with the smallest width; it is then stretched by its middle column.
+	int iCapWidth = ceil (fRadius + fLineWidth);
+	int iWidth = 2 * iCapWidth + 1;
+	cairo_surface_t *pSurface = cairo_dock_create_blank_surface (iWidth, pText->iHeight);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	double fFrameWidth = iWidth - 2 * fRadius - fLineWidth;
+	double fFrameHeight = pText->iHeight - fLineWidth;
+	cairo_dock_draw_rounded_rectangle (pCairoContext, fRadius, fLineWidth, fFrameWidth, fFrameHeight);
+	
+	if (pTextDescription->bUseDefaultColors)
+		gldi_style_colors_set_bg_color (pCairoContext);
+	else
+		gldi_color_set_cairo (pCairoContext, &pTextDescription->fBackgroundColor);
+	cairo_fill_preserve (pCairoContext);
+	
+	if (pTextDescription->bUseDefaultColors)
+		gldi_style_colors_set_line_color (pCairoContext);
+	else
+		gldi_color_set_cairo (pCairoContext, &pTextDescription->fLineColor);
+	cairo_set_line_width (pCairoContext, fLineWidth);
+	cairo_stroke (pCairoContext);
+	cairo_destroy (pCairoContext);
+	
+	cairo_dock_unload_image_buffer (&pText->bg);
+	cairo_dock_load_image_buffer_from_surface_in_atlas (&pText->bg, pSurface, iWidth, pText->iHeight);
+}
+
+CairoDockGLText *cairo_dock_gl_text_new (void)
+{
+	if (s_pPangoContext == NULL)
+	{
+		s_pPangoContext = pango_font_map_create_context (pango_cairo_font_map_get_default ());
+		GdkScreen *pScreen = gdk_screen_get_default ();
+		if (pScreen != NULL)
+			pango_cairo_context_set_font_options (s_pPangoContext, gdk_screen_get_font_options (pScreen));
+		s_hGlyphs = g_hash_table_new_full ((GHashFunc) _glyph_hash,
+			(GEqualFunc) _glyph_equal,
+			NULL,
+			(GDestroyNotify) _free_glyph);
+	}
+	CairoDockGLText *pText = g_new0 (CairoDockGLText, 1);
+	pText->pLayout = pango_layout_new (s_pPangoContext);
+	pText->sText = g_string_new ("");
+	pText->pQuads = g_array_new (FALSE, FALSE, sizeof (CDGlyphQuad));
+	pText->fZoomX = 1.;
+	return pText;
+}
+
+void cairo_dock_gl_text_free (CairoDockGLText *pText)
+{
+	if (pText == NULL)
+		return;
+	g_object_unref (pText->pLayout);
+	g_string_free (pText->sText, TRUE);
+	g_array_free (pText->pQuads, TRUE);
+	cairo_dock_unload_image_buffer (&pText->bg);
+	g_free (pText);
+}
+
+void cairo_dock_gl_text_set_text (CairoDockGLText *pText, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth)
+{
+	g_return_if_fail (pText != NULL && cText != NULL && pTextDescription != NULL);
+	
+	//\_________________ set the font, only if it has changed, so that the layout keeps its fonts.
+	PangoFontDescription *pDesc = gldi_text_description_get_description (pTextDescription);
+	g_return_if_fail (pDesc != NULL);
+	int iSize = gldi_text_description_get_size (pTextDescription);
+	pango_font_description_set_absolute_size (pDesc, fMaxScale * iSize * PANGO_SCALE);
+	const PangoFontDescription *pCurrentDesc = pango_layout_get_font_description (pText->pLayout);
+	if (pCurrentDesc == NULL || ! pango_font_description_equal (pCurrentDesc, pDesc))
+		pango_layout_set_font_description (pText->pLayout, pDesc);
+	pango_font_description_set_absolute_size (pDesc, iSize * PANGO_SCALE);
+	
+	//\_________________ set the text
+	if (pText->bUseMarkup != pTextDescription->bUseMarkup || strcmp (pText->sText->str, cText) != 0)
+	{
+		g_string_assign (pText->sText, cText);
+		pText->bUseMarkup = pTextDescription->bUseMarkup;
+		if (pText->bUseMarkup)
+			pango_layout_set_markup (pText->pLayout, cText, -1);
+		else
+			pango_layout_set_text (pText->pLayout, cText, -1);
+	}
+	
+	//\_________________ handle max width
+	int iMaxLineWidth = -1;
+	if (pTextDescription->fMaxRelativeWidth != 0)
+		iMaxLineWidth = pTextDescription->fMaxRelativeWidth * gldi_desktop_get_width() / g_desktopGeometry.iNbScreens * PANGO_SCALE;  // same as for the surfaces.
+	if (pango_layout_get_width (pText->pLayout) != iMaxLineWidth)
+		pango_layout_set_width (pText->pLayout, iMaxLineWidth);
+	PangoRectangle log;
+	pango_layout_get_pixel_extents (pText->pLayout, NULL, &log);
+	
+	//\_________________ compute the size of the text, the same way as cairo_dock_create_surface_from_text_full().
+	pText->bDrawBackground = ! pTextDescription->bNoDecorations;
+	double fRadius = (pTextDescription->bUseDefaultColors ? MIN (myStyleParam.iCornerRadius * .75, iSize/2) : fMaxScale * MAX (pTextDescription->iMargin, MIN (6, iSize/2)));
+	int iOutlineMargin = 2*pTextDescription->iMargin * fMaxScale + (pTextDescription->bOutlined ? 2 : 0);
+	pText->fZoomX = ((iMaxWidth != 0 && log.width + iOutlineMargin > iMaxWidth) ? (double)iMaxWidth / (log.width + iOutlineMargin) : 1.);
+	double fLineWidth = 1;
+	
+	pText->iWidth = (log.width + iOutlineMargin) * pText->fZoomX + 2*fLineWidth;
+	if (pText->bDrawBackground)
+	{
+		pText->iWidth = MAX (pText->iWidth, 2 * fRadius + 10);
+		if (iMaxWidth != 0 && pText->iWidth > iMaxWidth)
+			pText->iWidth = iMaxWidth;
+	}
+	pText->iHeight = log.height + iOutlineMargin + 2*fLineWidth;
+	
+	int dx = (pText->iWidth - log.width * pText->fZoomX)/2;
+	int dy = (pText->iHeight - log.height)/2;
+	pText->fOffsetX = -log.x * pText->fZoomX + dx;
+	pText->fOffsetY = -log.y + dy;
+	
+	//\_________________ colors and background
+	pText->bOutlined = pTextDescription->bOutlined;
+	if (pTextDescription->bUseDefaultColors)
+		gldi_style_color_get (GLDI_COLOR_TEXT, &pText->fTextColor);
+	else
+		pText->fTextColor = pTextDescription->fColorStart;
+	if (pText->bDrawBackground && pText->iHeight > 0)
+		_load_background (pText, pTextDescription, fRadius, fLineWidth);
+	
+	//\_________________ place the glyphs
+	_layout_glyphs (pText);
+}
+
+void cairo_dock_gl_text_get_size (CairoDockGLText *pText, int *iWidth, int *iHeight)
+{
+	*iWidth = pText->iWidth;
+	*iHeight = pText->iHeight;
+}
+
+#define _add_text_quad(pImage, u, v, du, dv, qx, qy, qw, qh, r, g, b, a) \
+	cairo_dock_render_batch_add_colored_quad_portion ((pImage)->iTexture, u, v, du, dv,\
+		x0 + ((qx) + (qw)/2.) * fScaleX,\
+		y0 - ((qy) + (qh)/2.) * fScaleY,\
+		(qw) * fScaleX,\
+		(qh) * fScaleY,\
+		r, g, b, a)
+
+static inline void _add_glyphs (CairoDockGLText *pText, double x0, double y0, double fScaleX, double fScaleY, double ox, double oy, double r, double g, double b, double fAlpha)
+{
+	CDGlyphQuad *pQuad;
+	CairoDockImageBuffer *pImage;
+	double u, v, du, dv;
+	guint i;
+	for (i = 0; i < pText->pQuads->len; i ++)
+	{
+		pQuad = &g_array_index (pText->pQuads, CDGlyphQuad, i);
+		pImage = &pQuad->pGlyph->image;
+		cairo_dock_image_buffer_get_texture_coords (pImage, &u, &v, &du, &dv);
+		_add_text_quad (pImage, u, v, du, dv,
+			pQuad->x + ox, pQuad->y + oy, pImage->iWidth * pText->fZoomX, pImage->iHeight,
+			r, g, b, fAlpha);
+	}
+}
+
+void cairo_dock_gl_text_render (CairoDockGLText *pText, double x, double y, double w, double h, double fAlpha)
+{
+	if (pText == NULL || pText->iWidth <= 0 || pText->iHeight <= 0)
+		return;
+	if (pText->iGeneration != s_iGlyphGeneration)  // the glyph cache has been emptied since the text was laid out.
+		_layout_glyphs (pText);
+	
+	double fScaleX = w / pText->iWidth, fScaleY = h / pText->iHeight;
+	double x0 = x - w/2, y0 = y + h/2;  // top-left corner of the text.
+	double u, v, du, dv;
+	
+	//\_________________ the background: both ends as they are, and the middle column stretched.
+	if (pText->bDrawBackground && pText->bg.iWidth != 0)
+	{
+		CairoDockImageBuffer *pImage = &pText->bg;
+		cairo_dock_image_buffer_get_texture_coords (pImage, &u, &v, &du, &dv);
+		int iCapWidth = pImage->iWidth / 2;
+		double fCapWidth = MIN (iCapWidth, pText->iWidth / 2.);
+		double duCap = du * iCapWidth / pImage->iWidth;
+		_add_text_quad (pImage, u, v, duCap, dv,
+			0, 0, fCapWidth, pText->iHeight,
+			1., 1., 1., fAlpha);
+		if (pText->iWidth > 2 * fCapWidth)
+			_add_text_quad (pImage, u + du * (iCapWidth + .5) / pImage->iWidth, v, 0., dv,
+				fCapWidth, 0, pText->iWidth - 2 * fCapWidth, pText->iHeight,
+				1., 1., 1., fAlpha);
+		_add_text_quad (pImage, u + du * (iCapWidth + 1) / pImage->iWidth, v, duCap, dv,
+			pText->iWidth - fCapWidth, 0, fCapWidth, pText->iHeight,
+			1., 1., 1., fAlpha);
+	}
+	
+	//\_________________ the outline of the text: the glyphs shifted by 1 pixel in each direction.
+	if (pText->bOutlined)
+	{
+		_add_glyphs (pText, x0, y0, fScaleX, fScaleY, 0, -1, .2, .2, .2, fAlpha);
+		_add_glyphs (pText, x0, y0, fScaleX, fScaleY, 0, 1, .2, .2, .2, fAlpha);
+		_add_glyphs (pText, x0, y0, fScaleX, fScaleY, -pText->fZoomX, 0, .2, .2, .2, fAlpha);
+		_add_glyphs (pText, x0, y0, fScaleX, fScaleY, pText->fZoomX, 0, .2, .2, .2, fAlpha);
+	}
+	
+	//\_________________ the text itself.
+	_add_glyphs (pText, x0, y0, fScaleX, fScaleY, 0, 0,
+		pText->fTextColor.rgba.red, pText->fTextColor.rgba.green, pText->fTextColor.rgba.blue,
+		fAlpha);
+}
+
+void cairo_dock_gl_text_get_stats (CairoDockGLTextStats *pStats)
+{
+	*pStats = s_textStats;
+	pStats->iNbGlyphs = (s_hGlyphs != NULL ? g_hash_table_size (s_hGlyphs) : 0);
+}
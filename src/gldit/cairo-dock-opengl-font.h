@@ -35,6 +35,7 @@ G_BEGIN_DECLS
 * For a more efficient way, you load a font into a CairoDockGLFont with either :
 * \ref cairo_dock_load_textured_font to load a subset of a Mono font into textures.
 * You then use \ref cairo_dock_draw_gl_text_at_position to draw the text.
+* To draw a text that changes often with any font (like a quick-info), use a CairoDockGLText: the text is laid out by Pango, but each glyph is rasterized only once in a shared cache and loaded into the texture atlas, and the text is then drawn as a set of quads. Changing the text only lays it out again.
 */
 
 /** Create a texture from a text. The text is drawn in white, so that you can later colorize it with a mere glColor.
@@ -129,5 +130,57 @@ void cairo_dock_draw_gl_text_in_area (const guchar *cText, CairoDockGLFont *pFon
 void cairo_dock_draw_gl_text_at_position_in_area (const guchar *cText, CairoDockGLFont *pFont, int x, int y, int iWidth, int iHeight, gboolean bCentered);
 
 
+/// Counters of the glyph cache used by the CairoDockGLText.
+typedef struct {
+	/// number of glyphs currently in the cache.
+	guint iNbGlyphs;
+	/// number of glyphs rasterized (and loaded into the atlas) since the beginning.
+	guint iNbRasterizedGlyphs;
+	/// number of times a text has been laid out.
+	guint iNbLayouts;
+} CairoDockGLTextStats;
+
+/** Create a new empty text, that will be drawn with the glyph cache.
+*@return a newly allocated text, to be freed with \ref cairo_dock_gl_text_free.
+*/
+CairoDockGLText *cairo_dock_gl_text_new (void);
+
+/** Free a text.
+*@param pText the text.
+*/
+void cairo_dock_gl_text_free (CairoDockGLText *pText);
+
+/** Set the text and its description. The result is the same as \ref cairo_dock_create_surface_from_text_full, but no surface nor texture is created, except for the glyphs that have never been drawn before.
+*@param pText the text.
+*@param cText the string to display.
+*@param pTextDescription description of the text.
+*@param fMaxScale maximum zoom of the text.
+*@param iMaxWidth maximum width allowed, or 0 to not limit it.
+*/
+void cairo_dock_gl_text_set_text (CairoDockGLText *pText, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth);
+
+/** Get the size of a text.
+*@param pText the text.
+*@param iWidth a pointer that will be filled with the width of the text.
+*@param iHeight a pointer that will be filled with the height of the text.
+*/
+void cairo_dock_gl_text_get_size (CairoDockGLText *pText, int *iWidth, int *iHeight);
+
+/** Draw a text. The quads of the text are added to the current render batch (see \ref cairo_dock_render_batch_flush), so texturing and blending must be enabled before the batch is flushed.
+*@param pText the text.
+*@param x horizontal position of the center of the text.
+*@param y vertical position of the center of the text.
+*@param w width at which to draw the text.
+*@param h height at which to draw the text.
+*@param fAlpha transparency of the text.
+*/
+void cairo_dock_gl_text_render (CairoDockGLText *pText, double x, double y, double w, double h, double fAlpha);
+
+/** Get the counters of the glyph cache.
+*@param pStats a structure to fill with the counters.
+*/
+void cairo_dock_gl_text_get_stats (CairoDockGLTextStats *pStats);
+
+
 G_END_DECLS
 #endif
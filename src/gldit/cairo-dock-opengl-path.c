@@ -18,14 +18,18 @@
 */
 
 #include <math.h>
+#include <string.h>  // memcmp
 #include <GL/gl.h>
 
 #include "cairo-dock-struct.h"
 #include "cairo-dock-icon-facility.h"  // cairo_dock_generate_string_path_opengl
 #include "cairo-dock-dock-factory.h"
 #include "cairo-dock-separator-manager.h"
+#include "cairo-dock-opengl.h"  // g_openglConfig.bVboAvailable
 #include "cairo-dock-opengl-path.h"
 
+extern CairoDockGLConfig g_openglConfig;
+
 #define _CD_PATH_DIM 2
 #define _cd_gl_path_set_nth_vertex_x(pPath, _x, i) pPath->pVertices[_CD_PATH_DIM*(i)] = _x
 #define _cd_gl_path_set_nth_vertex_y(pPath, _y, i) pPath->pVertices[_CD_PATH_DIM*(i)+1] = _y
@@ -55,6 +59,8 @@ void cairo_dock_free_gl_path (CairoDockGLPath *pPath)
 {
 	if (!pPath)
 		return;
+	if (pPath->iVbo != 0)
+		glDeleteBuffersARB (1, &pPath->iVbo);
 	g_free (pPath->pVertices);
 	g_free (pPath);
 }
@@ -64,6 +70,7 @@ void cairo_dock_gl_path_move_to (CairoDockGLPath *pPath, double x0, double y0)
 	pPath->iCurrentPt = 0;
 	_cd_gl_path_set_current_vertex (pPath, x0, y0);
 	pPath->iCurrentPt ++;
+	pPath->iNbVboPoints = 0;
 }
 
 void cairo_dock_gl_path_set_extent (CairoDockGLPath *pPath, int iWidth, int iHeight)
@@ -76,6 +83,7 @@ void cairo_dock_gl_path_line_to (CairoDockGLPath *pPath, GLfloat x, GLfloat y)
 {
 	g_return_if_fail (pPath->iCurrentPt < pPath->iNbPoints);
 	_cd_gl_path_set_current_vertex (pPath, x, y);
+	pPath->iNbVboPoints = MIN (pPath->iNbVboPoints, pPath->iCurrentPt);
 	pPath->iCurrentPt ++;
 }
 
@@ -107,6 +115,7 @@ void cairo_dock_gl_path_curve_to (CairoDockGLPath *pPath, int iNbPoints, GLfloat
 		_cd_gl_path_set_nth_vertex_x (pPath, Bezier (x0, x1, x2, x3, t), pPath->iCurrentPt + i);
 		_cd_gl_path_set_nth_vertex_y (pPath, Bezier (y0, y1, y2, y3, t), pPath->iCurrentPt + i);
 	}
+	pPath->iNbVboPoints = MIN (pPath->iNbVboPoints, pPath->iCurrentPt);
 	pPath->iCurrentPt += iNbPoints;
 }
 
@@ -133,6 +142,7 @@ void cairo_dock_gl_path_simple_curve_to (CairoDockGLPath *pPath, int iNbPoints,
 		_cd_gl_path_set_nth_vertex_x (pPath, Bezier2 (x0, x1, x2, t), pPath->iCurrentPt + i);
 		_cd_gl_path_set_nth_vertex_y (pPath, Bezier2 (y0, y1, y2, t), pPath->iCurrentPt + i);
 	}
+	pPath->iNbVboPoints = MIN (pPath->iNbVboPoints, pPath->iCurrentPt);
 	pPath->iCurrentPt += iNbPoints;
 }
 
@@ -155,9 +165,48 @@ void cairo_dock_gl_path_arc (CairoDockGLPath *pPath, int iNbPoints, GLfloat xc,
 		_cd_gl_path_set_nth_vertex_x (pPath, xc + r * cos (t), pPath->iCurrentPt + i);
 		_cd_gl_path_set_nth_vertex_y (pPath, yc + r * sin (t), pPath->iCurrentPt + i);
 	}
+	pPath->iNbVboPoints = MIN (pPath->iNbVboPoints, pPath->iCurrentPt);
 	pPath->iCurrentPt += iNbPoints;
 }
 
+static void _enable_vbo (CairoDockGLPath *pPath)  // keep the vertices of the path in a VBO, for paths that are drawn many times.
+{
+	if (! g_openglConfig.bVboAvailable)
+		return;
+	glGenBuffersARB (1, &pPath->iVbo);
+	glBindBufferARB (GL_ARRAY_BUFFER_ARB, pPath->iVbo);
+	glBufferDataARB (GL_ARRAY_BUFFER_ARB, (pPath->iNbPoints+1) * _CD_PATH_DIM * sizeof (GLfloat), NULL, GL_DYNAMIC_DRAW_ARB);
+	glBindBufferARB (GL_ARRAY_BUFFER_ARB, 0);
+	pPath->iNbVboPoints = 0;
+}
+
+static inline void _set_vertex_pointer (CairoDockGLPath *pPath)
+{
+	if (pPath->iVbo != 0)
+	{
+		glBindBufferARB (GL_ARRAY_BUFFER_ARB, pPath->iVbo);
+		if (pPath->iNbVboPoints < pPath->iCurrentPt)  // only upload the vertices that changed.
+		{
+			glBufferSubDataARB (GL_ARRAY_BUFFER_ARB,
+				pPath->iNbVboPoints * _CD_PATH_DIM * sizeof (GLfloat),
+				(pPath->iCurrentPt - pPath->iNbVboPoints) * _CD_PATH_DIM * sizeof (GLfloat),
+				&pPath->pVertices[_CD_PATH_DIM * pPath->iNbVboPoints]);
+			pPath->iNbVboPoints = pPath->iCurrentPt;
+		}
+		glVertexPointer (_CD_PATH_DIM, GL_FLOAT, 0, NULL);
+	}
+	else
+	{
+		glVertexPointer (_CD_PATH_DIM, GL_FLOAT, 0, pPath->pVertices);
+	}
+}
+
+static inline void _unset_vertex_pointer (const CairoDockGLPath *pPath)
+{
+	if (pPath->iVbo != 0)
+		glBindBufferARB (GL_ARRAY_BUFFER_ARB, 0);
+}
+
 static inline void _draw_current_path (int iNbPoints, gboolean bClosePath)
 {
 	//\__________________ On active l'antialiasing.
@@ -180,8 +229,9 @@ static inline void _draw_current_path (int iNbPoints, gboolean bClosePath)
 }
 void cairo_dock_stroke_gl_path (const CairoDockGLPath *pPath, gboolean bClosePath)
 {
-	glVertexPointer (_CD_PATH_DIM, GL_FLOAT, 0, pPath->pVertices);
+	_set_vertex_pointer ((CairoDockGLPath*)pPath);  // only the VBO may be updated.
 	_draw_current_path (pPath->iCurrentPt, bClosePath);
+	_unset_vertex_pointer (pPath);
 }
 
 void cairo_dock_fill_gl_path (const CairoDockGLPath *pPath, GLuint iTexture)
@@ -220,8 +270,9 @@ void cairo_dock_fill_gl_path (const CairoDockGLPath *pPath, GLuint iTexture)
 	
 	//\__________________ On dessine le cadre.
 	glEnableClientState (GL_VERTEX_ARRAY);
-	glVertexPointer (_CD_PATH_DIM, GL_FLOAT, 0, pPath->pVertices);
+	_set_vertex_pointer ((CairoDockGLPath*)pPath);
 	glDrawArrays (GL_TRIANGLE_FAN, 0, pPath->iCurrentPt);  // GL_POLYGON / GL_TRIANGLE_FAN
+	_unset_vertex_pointer (pPath);
 	glDisableClientState (GL_VERTEX_ARRAY);
 	
 	//\__________________ On desactive l'antialiasing et la texture.
@@ -243,9 +294,53 @@ void cairo_dock_fill_gl_path (const CairoDockGLPath *pPath, GLuint iTexture)
 // HELPER FUNCTIONS //
 
 #define DELTA_ROUND_DEGREE 3
+
+// the frames only change when the size of the dock changes, so keep the last ones and their parameters.
+#define CD_GL_PATH_CACHE_SIZE 4
+typedef struct {
+	double fParams[5];
+	double fExtraWidth;
+	CairoDockGLPath *pPath;
+	guint iLastUse;
+} CDGLPathCacheEntry;
+
+static CDGLPathCacheEntry s_pRectangleCache[CD_GL_PATH_CACHE_SIZE];
+static CDGLPathCacheEntry s_pTrapezeCache[CD_GL_PATH_CACHE_SIZE];
+static guint s_iCacheClock = 0;
+static CairoDockGLPath *s_pStringPath = NULL;  // see cairo_dock_generate_string_path_opengl
+
+// return the entry matching the parameters, or the least recently used one, to be filled with a new path (*bFound is then FALSE).
+static CDGLPathCacheEntry *_get_cache_entry (CDGLPathCacheEntry *pCache, const double *fParams, gboolean *bFound)
+{
+	CDGLPathCacheEntry *pEntry, *pOldest = &pCache[0];
+	int i;
+	s_iCacheClock ++;
+	for (i = 0; i < CD_GL_PATH_CACHE_SIZE; i ++)
+	{
+		pEntry = &pCache[i];
+		if (pEntry->pPath != NULL && memcmp (pEntry->fParams, fParams, sizeof (pEntry->fParams)) == 0)
+		{
+			pEntry->iLastUse = s_iCacheClock;
+			*bFound = TRUE;
+			return pEntry;
+		}
+		if (pEntry->iLastUse < pOldest->iLastUse)
+			pOldest = pEntry;
+	}
+	memcpy (pOldest->fParams, fParams, sizeof (pOldest->fParams));
+	pOldest->iLastUse = s_iCacheClock;
+	*bFound = FALSE;
+	return pOldest;
+}
+
 const CairoDockGLPath *cairo_dock_generate_rectangle_path (double fFrameWidth, double fTotalHeight, double fRadius, gboolean bRoundedBottomCorner)
 {
-	static CairoDockGLPath *pPath = NULL;
+	double fParams[5] = {fFrameWidth, fTotalHeight, fRadius, bRoundedBottomCorner, 0.};
+	gboolean bFound;
+	CDGLPathCacheEntry *pEntry = _get_cache_entry (s_pRectangleCache, fParams, &bFound);
+	if (bFound)
+		return pEntry->pPath;
+	
 	double fTotalWidth = fFrameWidth + 2 * fRadius;
 	double fFrameHeight = MAX (0, fTotalHeight - 2 * fRadius);
 	double w = fFrameWidth / 2;
@@ -253,9 +348,12 @@ const CairoDockGLPath *cairo_dock_generate_rectangle_path (double fFrameWidth, d
 	double r = fRadius;
 	
 	int iNbPoins1Round = 90/10;
+	CairoDockGLPath *pPath = pEntry->pPath;
 	if (pPath == NULL)
 	{
 		pPath = cairo_dock_new_gl_path ((iNbPoins1Round+1)*4+1, w+r, h, fTotalWidth, fTotalHeight);  // on commence au centre droit pour avoir une bonne triangulation du polygone, et en raisonnant par rapport au centre du rectangle.
+		_enable_vbo (pPath);
+		pEntry->pPath = pPath;
 		///pPath = cairo_dock_new_gl_path ((iNbPoins1Round+1)*4+1, 0, 0, fTotalWidth, fTotalHeight);  // on commence au centre pour avoir une bonne triangulation
 	}
 	else
@@ -290,7 +388,14 @@ const CairoDockGLPath *cairo_dock_generate_rectangle_path (double fFrameWidth, d
 
 const CairoDockGLPath *cairo_dock_generate_trapeze_path (double fUpperFrameWidth, double fTotalHeight, double fRadius, gboolean bRoundedBottomCorner, double fInclination, double *fExtraWidth)
 {
-	static CairoDockGLPath *pPath = NULL;
+	double fParams[5] = {fUpperFrameWidth, fTotalHeight, fRadius, bRoundedBottomCorner, fInclination};
+	gboolean bFound;
+	CDGLPathCacheEntry *pEntry = _get_cache_entry (s_pTrapezeCache, fParams, &bFound);
+	if (bFound)
+	{
+		*fExtraWidth = pEntry->fExtraWidth;
+		return pEntry->pPath;
+	}
 	
 	double a = atan (fInclination);  // /|
 	double cosa = 1. / sqrt (1 + fInclination * fInclination);
@@ -298,6 +403,7 @@ const CairoDockGLPath *cairo_dock_generate_trapeze_path (double fUpperFrameWidth
 	
 	double fFrameHeight = MAX (0, fTotalHeight - 2 * fRadius);
 	*fExtraWidth = fInclination * (fTotalHeight - (bRoundedBottomCorner ? 2 : 1-sina) * fRadius) + fRadius * (bRoundedBottomCorner ? 1 : cosa);
+	pEntry->fExtraWidth = *fExtraWidth;
 	double fTotalWidth = fUpperFrameWidth + 2*(*fExtraWidth);
 	double dw = *fExtraWidth;
 	double r = fRadius;
@@ -307,8 +413,13 @@ const CairoDockGLPath *cairo_dock_generate_trapeze_path (double fUpperFrameWidth
 	
 	int iNbPoins1Round = 70/DELTA_ROUND_DEGREE;  // pour une inclinaison classique (~30deg), les coins du haut feront moins d'1/4 de tour.
 	int iNbPoins1Curve = 10;
+	CairoDockGLPath *pPath = pEntry->pPath;
 	if (pPath == NULL)
+	{
 		pPath = cairo_dock_new_gl_path ((iNbPoins1Round+1)*2 + (iNbPoins1Curve+1)*2 + 1, 0., fTotalHeight/2, fTotalWidth, fTotalHeight);
+		_enable_vbo (pPath);
+		pEntry->pPath = pPath;
+	}
 	else
 	{
 		cairo_dock_gl_path_move_to (pPath, 0., fTotalHeight/2);
@@ -353,6 +464,21 @@ const CairoDockGLPath *cairo_dock_generate_trapeze_path (double fUpperFrameWidth
 }
 
 
+void cairo_dock_free_cached_gl_paths (void)
+{
+	int i;
+	for (i = 0; i < CD_GL_PATH_CACHE_SIZE; i ++)
+	{
+		cairo_dock_free_gl_path (s_pRectangleCache[i].pPath);
+		cairo_dock_free_gl_path (s_pTrapezeCache[i].pPath);
+	}
+	memset (s_pRectangleCache, 0, sizeof (s_pRectangleCache));
+	memset (s_pTrapezeCache, 0, sizeof (s_pTrapezeCache));
+	cairo_dock_free_gl_path (s_pStringPath);
+	s_pStringPath = NULL;
+}
+
+
 #define _get_icon_center_x(icon) (icon->fDrawX + icon->fWidth * icon->fScale/2)
 #define _get_icon_center_y(icon) (icon->fDrawY + (bForceConstantSeparator && CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (icon) ? icon->fHeight * (icon->fScale - .5) : icon->fHeight * icon->fScale/2))
 #define _get_icon_center(icon,x,y) do {\
@@ -369,11 +495,18 @@ const CairoDockGLPath *cairo_dock_generate_trapeze_path (double fUpperFrameWidth
 	dx /= norme;\
 	dy /= norme; } while (0)
 #define NB_VERTEX_PER_ICON_PAIR 10
+#define NB_MAX_ICON_PAIRS 100
 const CairoDockGLPath *cairo_dock_generate_string_path_opengl (CairoDock *pDock, gboolean bIsLoop, gboolean bForceConstantSeparator)
 {
-	static CairoDockGLPath *pPath = NULL;
-	if (pPath == NULL)
-		pPath = cairo_dock_new_gl_path (100*NB_VERTEX_PER_ICON_PAIR + 1, 0., 0., 0., 0.);
+	static GLfloat pSegments[NB_MAX_ICON_PAIRS][8];  // the 4 points of the curve of each pair of icons, as computed the last time; the vertices of a curve only depend on them.
+	static int iNbSegments = 0;  // number of curves in the path the last time.
+	if (s_pStringPath == NULL)
+	{
+		s_pStringPath = cairo_dock_new_gl_path (NB_MAX_ICON_PAIRS*NB_VERTEX_PER_ICON_PAIR + 1, 0., 0., 0., 0.);
+		_enable_vbo (s_pStringPath);
+		iNbSegments = 0;  // the new path contains no curve yet.
+	}
+	CairoDockGLPath *pPath = s_pStringPath;
 	
 	GList *ic, *next_ic, *next2_ic, *pFirstDrawnElement = pDock->icons;
 	Icon *pIcon, *pNextIcon, *pNext2Icon;
@@ -410,13 +543,21 @@ const CairoDockGLPath *cairo_dock_generate_string_path_opengl (CairoDock *pDock,
 	pNext2Icon = next2_ic->data;
 	_get_icon_center (pNext2Icon,x2,y2);
 	
-	cairo_dock_gl_path_move_to (pPath, x0, y0);
+	if (iNbSegments > 0 && _cd_gl_path_get_nth_vertex_x (pPath, 0) == (GLfloat)x0 && _cd_gl_path_get_nth_vertex_y (pPath, 0) == (GLfloat)y0)  // same origin, keep the vertices.
+		pPath->iCurrentPt = 1;
+	else
+	{
+		cairo_dock_gl_path_move_to (pPath, x0, y0);
+		iNbSegments = 0;
+	}
 	if (pDock->container.bIsHorizontal)
 		cairo_dock_gl_path_set_extent (pPath, pDock->container.iWidth, pDock->container.iHeight);
 	else
 		cairo_dock_gl_path_set_extent (pPath, pDock->container.iHeight, pDock->container.iWidth);
 	
 	// on parcourt les icones.
+	int n = 0;  // index of the current curve.
+	GLfloat *seg;
 	do
 	{
 		// l'icone courante, la suivante, et celle d'apres.
@@ -439,10 +580,29 @@ const CairoDockGLPath *cairo_dock_generate_string_path_opengl (CairoDock *pDock,
 		x1_ = x1 - dx_ * norme;
 		y1_ = y1 - dy_ * norme;
 		
-		cairo_dock_gl_path_curve_to (pPath, NB_VERTEX_PER_ICON_PAIR,
-			x0_, y0_,
-			x1_, y1_,
-			x1,  y1);
+		if (n >= NB_MAX_ICON_PAIRS)
+			break;
+		seg = pSegments[n];
+		if (n < iNbSegments
+		&& seg[0] == (GLfloat)x0 && seg[1] == (GLfloat)y0
+		&& seg[2] == (GLfloat)x0_ && seg[3] == (GLfloat)y0_
+		&& seg[4] == (GLfloat)x1_ && seg[5] == (GLfloat)y1_
+		&& seg[6] == (GLfloat)x1 && seg[7] == (GLfloat)y1)  // these 2 icons haven't moved, the curve is already there.
+		{
+			pPath->iCurrentPt += NB_VERTEX_PER_ICON_PAIR;
+		}
+		else
+		{
+			cairo_dock_gl_path_curve_to (pPath, NB_VERTEX_PER_ICON_PAIR,
+				x0_, y0_,
+				x1_, y1_,
+				x1,  y1);
+			seg[0] = x0; seg[1] = y0;
+			seg[2] = x0_; seg[3] = y0_;
+			seg[4] = x1_; seg[5] = y1_;
+			seg[6] = x1; seg[7] = y1;
+		}
+		n ++;
 		
 		// on decale tout d'un cran.
 		ic = next_ic;
@@ -454,6 +614,7 @@ const CairoDockGLPath *cairo_dock_generate_string_path_opengl (CairoDock *pDock,
 			break ;
 	}
 	while (ic != pFirstDrawnElement);
+	iNbSegments = n;
 	
 	return pPath;
 }
@@ -27,6 +27,8 @@ G_BEGIN_DECLS
 * You create a path with \ref cairo_dock_new_gl_path, then you add lines, curves or arcs to it.
 * Once the path is defined, you can eigher stroke it with \ref cairo_dock_stroke_gl_path or fill it with \ref cairo_dock_fill_gl_path. You can fill a path with the current color or with a texture, in this case you must provide the dimension of the husk.
 * To destroy the path, use \ref cairo_dock_free_gl_path.
+*
+* The paths of the frames (\ref cairo_dock_generate_rectangle_path and \ref cairo_dock_generate_trapeze_path) are cached: they are only computed again when their parameters change, and their vertices are kept in a VBO. The path of the string is only updated where the icons have moved.
 */
 
 /// Definition of a CairoDockGLPath.
@@ -35,6 +37,10 @@ struct _CairoDockGLPath {
 	GLfloat *pVertices;
 	int iCurrentPt;
 	int iWidth, iHeight;
+	/// VBO holding the vertices, or 0 if the path is drawn from the client memory (private).
+	GLuint iVbo;
+	/// number of vertices up to date in the VBO (private).
+	int iNbVboPoints;
 	};
 
 /** Create a new path. It will start at the point (x0, y0). If you want to be abe to fill it with a texture, you can specify here the dimension of the path's husk.
@@ -148,12 +154,38 @@ void cairo_dock_stroke_gl_path (const CairoDockGLPath *pPath, gboolean bClosePat
 void cairo_dock_fill_gl_path (const CairoDockGLPath *pPath, GLuint iTexture);
 
 
+/** Get the path of a rectangle with rounded corners, centered on the origin. The path is cached and shared, so it must not be modified, and it is only valid until the next call.
+*@param fFrameWidth width of the rectangle, without the corners.
+*@param fTotalHeight height of the rectangle, including the corners.
+*@param fRadius radius of the corners.
+*@param bRoundedBottomCorner whether the bottom corners are rounded too.
+*@return the path.
+*/
 const CairoDockGLPath *cairo_dock_generate_rectangle_path (double fFrameWidth, double fTotalHeight, double fRadius, gboolean bRoundedBottomCorner);
 
+/** Same as above, but with inclined sides.
+*@param fUpperFrameWidth width of the upper side, without the corners.
+*@param fTotalHeight height of the trapeze, including the corners.
+*@param fRadius radius of the corners.
+*@param bRoundedBottomCorner whether the bottom corners are rounded too.
+*@param fInclination inclination of the sides (tangent of their angle with the vertical).
+*@param fExtraWidth filled with the width added on each side of the upper side.
+*@return the path.
+*/
 const CairoDockGLPath *cairo_dock_generate_trapeze_path (double fUpperFrameWidth, double fTotalHeight, double fRadius, gboolean bRoundedBottomCorner, double fInclination, double *fExtraWidth);
 
+/** Get the path of the string joining the icons of a dock. Only the parts between icons that have moved since the previous call are computed again.
+*@param pDock the dock.
+*@param bIsLoop whether the string joins the last icon to the first one.
+*@param bForceConstantSeparator whether separators are drawn with a constant size.
+*@return the path.
+*/
 const CairoDockGLPath *cairo_dock_generate_string_path_opengl (CairoDock *pDock, gboolean bIsLoop, gboolean bForceConstantSeparator);
 
+/** Free the paths cached by the functions above, and their VBOs. It's done when the OpenGL backend is stopped, while its context still exists.
+*/
+void cairo_dock_free_cached_gl_paths (void);
+
 void cairo_dock_draw_current_path_opengl (double fLineWidth, double *fLineColor, int iNbVertex);
 
 /** Draw a rectangle with rounded corners. The rectangle will be centered at the current point. The current matrix is not altered.
@@ -18,6 +18,7 @@
 */
 
 #include <math.h>
+#include <string.h>  // memmove, memset
 #include <GL/gl.h>
 #include <GL/glu.h>  // gluLookAt
 
@@ -26,6 +27,7 @@
 #include "cairo-dock-icon-facility.h"  // cairo_dock_get_icon_extent
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-desktop-manager.h"  // desktop dimensions
+#include "cairo-dock-opengl-path.h"  // cairo_dock_free_cached_gl_paths
 
 #include "cairo-dock-opengl.h"
 
@@ -41,6 +43,18 @@ extern gboolean g_bEasterEggs;
 static GldiGLManagerBackend s_backend;
 static gboolean s_bInitialized = FALSE;
 static gboolean s_bForceOpenGL = FALSE;
+static GldiGLRedrawStats s_redrawStats;
+static double s_fTotalRedrawnFraction = 0.;
+
+#define GLDI_GL_DAMAGE_HISTORY_SIZE 4  // drivers usually use 2 or 3 buffers
+
+typedef struct {
+	GdkRectangle damage[GLDI_GL_DAMAGE_HISTORY_SIZE];  // areas that changed in the previous frames, the most recent first
+	gint iNbFrames;  // number of valid areas
+	GdkRectangle changed;  // area that changes in the current frame
+	GdkRectangle redrawn;  // area redrawn in the current frame, to bring the back buffer up-to-date
+	gboolean bPartial;  // whether the current frame is only partially redrawn
+} GldiGLDamageHistory;
 
 
 gboolean gldi_gl_backend_init (gboolean bForceOpenGL)
@@ -57,6 +71,8 @@ gboolean gldi_gl_backend_init (gboolean bForceOpenGL)
 
 void gldi_gl_backend_deactivate (void)
 {
+	if (g_bUseOpenGL)
+		cairo_dock_free_cached_gl_paths ();  // before the context is destroyed.
 	if (g_bUseOpenGL && s_backend.stop)
 		s_backend.stop ();
 	g_bUseOpenGL = FALSE;
@@ -209,6 +225,86 @@ static void _apply_desktop_background (GldiContainer *pContainer)
 	glPopMatrix ();
 }
 
+static GdkRectangle *_get_area_to_redraw (GldiContainer *pContainer, GdkRectangle *pArea, GdkRectangle *pFullArea)
+{
+	GldiGLDamageHistory *pHistory = pContainer->pDamageHistory;
+	if (pHistory == NULL)
+	{
+		pHistory = g_new0 (GldiGLDamageHistory, 1);
+		pContainer->pDamageHistory = pHistory;
+	}
+	
+	// the back buffer contains the frame drawn 'age' frames ago; so we must redraw what has changed since then too.
+	GdkRectangle *pRedrawnArea = NULL;
+	if (pArea != NULL && s_backend.container_get_buffer_age != NULL)
+	{
+		int iAge = s_backend.container_get_buffer_age (pContainer);
+		if (iAge > 0 && pHistory->iNbFrames > 0 && iAge - 1 <= pHistory->iNbFrames)  // without any frame in the history, the content of the back buffer is unknown.
+		{
+			GdkRectangle area = *pArea;
+			int i;
+			for (i = 0; i < iAge - 1; i ++)
+			{
+				if (pHistory->damage[i].width > 0 && pHistory->damage[i].height > 0)
+					gdk_rectangle_union (&area, &pHistory->damage[i], &area);
+			}
+			gdk_rectangle_intersect (&area, pFullArea, &area);
+			if (area.width * area.height < pFullArea->width * pFullArea->height)
+			{
+				pHistory->redrawn = area;
+				pRedrawnArea = &pHistory->redrawn;
+			}
+		}
+	}
+	
+	// remember what changes in this frame; it's pushed in the history once the buffers are swapped.
+	pHistory->bPartial = (pRedrawnArea != NULL);
+	if (pHistory->bPartial)
+	{
+		if (! gdk_rectangle_intersect (pArea, pFullArea, &pHistory->changed))
+			memset (&pHistory->changed, 0, sizeof (GdkRectangle));
+	}
+	else
+	{
+		pHistory->changed = *pFullArea;
+		pHistory->redrawn = *pFullArea;
+	}
+	return pRedrawnArea;
+}
+
+static void _push_damage_history (GldiContainer *pContainer)
+{
+	GldiGLDamageHistory *pHistory = pContainer->pDamageHistory;
+	if (pHistory == NULL)  // no frame has begun
+		return;
+	memmove (&pHistory->damage[1], &pHistory->damage[0], (GLDI_GL_DAMAGE_HISTORY_SIZE - 1) * sizeof (GdkRectangle));
+	pHistory->damage[0] = pHistory->changed;
+	if (pHistory->iNbFrames < GLDI_GL_DAMAGE_HISTORY_SIZE)
+		pHistory->iNbFrames ++;
+	
+	int iWidth = (pContainer->bIsHorizontal ? pContainer->iWidth : pContainer->iHeight);
+	int iHeight = (pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth);
+	double fFraction = (iWidth > 0 && iHeight > 0 ? MIN (1., (double)pHistory->redrawn.width * pHistory->redrawn.height / ((double)iWidth * iHeight)) : 1.);
+	s_redrawStats.iNbFrames ++;
+	if (pHistory->bPartial)
+		s_redrawStats.iNbPartialFrames ++;
+	s_redrawStats.fLastRedrawnFraction = fFraction;
+	s_fTotalRedrawnFraction += fFraction;
+	s_redrawStats.fAverageRedrawnFraction = s_fTotalRedrawnFraction / s_redrawStats.iNbFrames;
+}
+
+void gldi_gl_container_reset_damage_history (GldiContainer *pContainer)
+{
+	GldiGLDamageHistory *pHistory = pContainer->pDamageHistory;
+	if (pHistory != NULL)
+		pHistory->iNbFrames = 0;
+}
+
+void gldi_gl_get_redraw_stats (GldiGLRedrawStats *pStats)
+{
+	*pStats = s_redrawStats;
+}
+
 gboolean gldi_gl_container_begin_draw_full (GldiContainer *pContainer, GdkRectangle *pArea, gboolean bClear)
 {
 	if (! gldi_gl_container_make_current (pContainer))
@@ -216,14 +312,17 @@ gboolean gldi_gl_container_begin_draw_full (GldiContainer *pContainer, GdkRectan
 	
 	glLoadIdentity ();
 	
-	if (pArea != NULL)
+	GdkRectangle fullArea = {0, 0,
+		pContainer->bIsHorizontal ? pContainer->iWidth : pContainer->iHeight,
+		pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth};
+	GdkRectangle *pRedrawnArea = _get_area_to_redraw (pContainer, pArea, &fullArea);
+	if (pRedrawnArea != NULL)
 	{
 		glEnable (GL_SCISSOR_TEST);  // ou comment diviser par 4 l'occupation CPU !
-		glScissor ((int) pArea->x,
-			(int) (pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth) -
-				pArea->y - pArea->height,  // lower left corner of the scissor box.
-			(int) pArea->width,
-			(int) pArea->height);
+		glScissor ((int) pRedrawnArea->x,
+			(int) fullArea.height - pRedrawnArea->y - pRedrawnArea->height,  // lower left corner of the scissor box.
+			(int) pRedrawnArea->width,
+			(int) pRedrawnArea->height);
 	}
 	
 	if (bClear)
@@ -240,6 +339,7 @@ void gldi_gl_container_end_draw (GldiContainer *pContainer)
 	glDisable (GL_SCISSOR_TEST);
 	if (s_backend.container_end_draw)
 		s_backend.container_end_draw (pContainer);
+	_push_damage_history (pContainer);
 }
 
 
@@ -308,6 +408,7 @@ static void _post_initialize_opengl_backend (G_GNUC_UNUSED GtkWidget *pWidget, G
 	
 	g_openglConfig.bNonPowerOfTwoAvailable = _check_gl_extension ("GL_ARB_texture_non_power_of_two");
 	g_openglConfig.bAccumBufferAvailable = _check_gl_extension ("GL_SUN_slice_accum");
+	g_openglConfig.bVboAvailable = _check_gl_extension ("GL_ARB_vertex_buffer_object");
 	
 	GLfloat fMaximumAnistropy = 0.;
 	if (_check_gl_extension ("GL_EXT_texture_filter_anisotropic"))
@@ -320,12 +421,13 @@ static void _post_initialize_opengl_backend (G_GNUC_UNUSED GtkWidget *pWidget, G
 	const gchar *cVendor   = (const gchar *) glGetString (GL_VENDOR);
 	const gchar *cRenderer = (const gchar *) glGetString (GL_RENDERER);
 
-	cd_message ("OpenGL config summary :\n - bNonPowerOfTwoAvailable : %d\n - bFboAvailable : %d\n - direct rendering : %d\n - bTextureFromPixmapAvailable : %d\n - bAccumBufferAvailable : %d\n - Anisotroy filtering level max : %.1f\n - OpenGL version: %s\n - OpenGL vendor: %s\n - OpenGL renderer: %s\n\n",
+	cd_message ("OpenGL config summary :\n - bNonPowerOfTwoAvailable : %d\n - bFboAvailable : %d\n - direct rendering : %d\n - bTextureFromPixmapAvailable : %d\n - bAccumBufferAvailable : %d\n - bVboAvailable : %d\n - Anisotroy filtering level max : %.1f\n - OpenGL version: %s\n - OpenGL vendor: %s\n - OpenGL renderer: %s\n\n",
 		g_openglConfig.bNonPowerOfTwoAvailable,
 		g_openglConfig.bFboAvailable,
 		!g_openglConfig.bIndirectRendering,
 		g_openglConfig.bTextureFromPixmapAvailable,
 		g_openglConfig.bAccumBufferAvailable,
+		g_openglConfig.bVboAvailable,
 		fMaximumAnistropy,
 		cVersion,
 		cVendor,
@@ -366,6 +468,8 @@ void gldi_gl_container_finish (GldiContainer *pContainer)
 {
 	if (g_bUseOpenGL && s_backend.container_finish)
 		s_backend.container_finish (pContainer);
+	g_free (pContainer->pDamageHistory);
+	pContainer->pDamageHistory = NULL;
 }
 
 
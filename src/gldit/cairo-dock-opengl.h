@@ -48,6 +48,7 @@ struct _CairoDockGLConfig {
 	void (*bindTexImage) (EGLDisplay *display, EGLSurface drawable, int buffer);  // texture from pixmap
 	void (*releaseTexImage) (EGLDisplay *display, EGLSurface drawable, int buffer);  // texture from pixmap
 	#endif
+	gboolean bVboAvailable;  // at the end, so that the previous fields keep their offset for the applets built against an older version.
 };
 
 struct _GldiGLManagerBackend {
@@ -57,7 +58,20 @@ struct _GldiGLManagerBackend {
 	void (*container_end_draw) (GldiContainer *pContainer);
 	void (*container_init) (GldiContainer *pContainer);
 	void (*container_finish) (GldiContainer *pContainer);
+	int (*container_get_buffer_age) (GldiContainer *pContainer);  // number of frames since the back buffer was drawn, or 0 if its content is unknown.
 };
+
+/// Counters of the partial redraws of the containers in OpenGL.
+typedef struct {
+	/// number of frames drawn.
+	guint iNbFrames;
+	/// number of frames where only a part of the container was redrawn.
+	guint iNbPartialFrames;
+	/// fraction of the pixels redrawn in the last frame, between 0 and 1.
+	double fLastRedrawnFraction;
+	/// average fraction of the pixels redrawn per frame, between 0 and 1.
+	double fAverageRedrawnFraction;
+} GldiGLRedrawStats;
 	
 
 
@@ -90,6 +104,7 @@ void gldi_gl_backend_force_indirect_rendering (void);
 gboolean gldi_gl_container_make_current (GldiContainer *pContainer);
 
 /** Start drawing on a Container's OpenGL context.
+* If an area is given, only this area is redrawn, provided that the rest of the back buffer is known to be up-to-date: the areas redrawn in the previous frames are remembered, and added to the area according to the age of the back buffer. If the age of the back buffer is unknown, the whole Container is redrawn.
 *@param pContainer the container
 *@param pArea optional area to clip the drawing (NULL to draw on the whole Container)
 *@param bClear whether to clear the color buffer or not
@@ -106,6 +121,11 @@ gboolean gldi_gl_container_begin_draw_full (GldiContainer *pContainer, GdkRectan
 */
 void gldi_gl_container_end_draw (GldiContainer *pContainer);
 
+/** Forget the areas redrawn in the previous frames, so that the next frame redraws the whole Container. Call it if you have drawn into the back buffer without going through \ref gldi_gl_container_end_draw, for instance to read its pixels.
+*@param pContainer the container
+*/
+void gldi_gl_container_reset_damage_history (GldiContainer *pContainer);
+
 
 /** Set a perspective view to the current GL context to fit a given Container. You may want to ensure the Container's context is really the current one.
 *@param pContainer the container
@@ -134,6 +154,11 @@ void gldi_gl_container_init (GldiContainer *pContainer);
 
 void gldi_gl_container_finish (GldiContainer *pContainer);
 
+/** Get the counters of the partial redraws.
+*@param pStats a structure to fill with the counters.
+*/
+void gldi_gl_get_redraw_stats (GldiGLRedrawStats *pStats);
+
 
 void gldi_gl_manager_register_backend (GldiGLManagerBackend *pBackend);
 
@@ -26,6 +26,8 @@
 #include "cairo-dock-icon-facility.h"
 #include "cairo-dock-draw.h"
 #include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-render-batch.h"
+#include "cairo-dock-opengl-font.h"
 #include "cairo-dock-image-buffer.h"
 #include "cairo-dock-log.h"
 #define _MANAGER_DEF_
@@ -118,6 +120,42 @@ CairoOverlay *cairo_dock_add_overlay_from_texture (Icon *pIcon, GLuint iTexture,
 	return gldi_overlay_new (&attr);
 }
 
+CairoOverlay *cairo_dock_add_overlay_from_text (Icon *pIcon, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, CairoOverlayPosition iPosition, gpointer data)
+{
+	g_return_val_if_fail (pIcon != NULL && cText != NULL, NULL);
+	
+	// if the icon already has this text overlay, just update its text.
+	if (data != NULL)
+	{
+		GList* ov;
+		CairoOverlay *p;
+		for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
+		{
+			p = ov->data;
+			if (p->data == data && p->iPosition == iPosition && p->pText != NULL)
+			{
+				cairo_dock_gl_text_set_text (p->pText, cText, pTextDescription, fMaxScale, iMaxWidth);
+				cairo_dock_gl_text_get_size (p->pText, &p->image.iWidth, &p->image.iHeight);
+				return p;
+			}
+		}
+	}
+	
+	// create an empty overlay, then attach the text to it; the image buffer stays empty, it only holds the size of the text.
+	CairoOverlayAttr attr;
+	memset (&attr, 0, sizeof (CairoOverlayAttr));
+	attr.iPosition = iPosition;
+	attr.pIcon = pIcon;
+	attr.data = data;
+	CairoOverlay *pOverlay = gldi_overlay_new (&attr);
+	g_return_val_if_fail (pOverlay != NULL, NULL);
+	
+	pOverlay->pText = cairo_dock_gl_text_new ();
+	cairo_dock_gl_text_set_text (pOverlay->pText, cText, pTextDescription, fMaxScale, iMaxWidth);
+	cairo_dock_gl_text_get_size (pOverlay->pText, &pOverlay->image.iWidth, &pOverlay->image.iHeight);
+	return pOverlay;
+}
+
 
 void cairo_dock_remove_overlay_at_position (Icon *pIcon, CairoOverlayPosition iPosition, gpointer data)
 {
@@ -269,16 +307,19 @@ void cairo_dock_draw_icon_overlays_opengl (Icon *pIcon, double fRatio)
 	_cairo_dock_set_blend_over ();
 	_cairo_dock_set_alpha (pIcon->fAlpha);
 	
+	glPushMatrix ();
+	glRotatef (-pIcon->fOrientation/G_PI*180., 0., 0., 1.);
+	
 	GList* ov;
 	CairoOverlay *p;
 	int wo, ho;  // actual size at which the overlay will be rendered.
 	double x, y;  // position of the overlay relatively to the icon center.
+	double u, v, du, dv;  // part of the texture (the overlay may be in the texture atlas).
 	for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
 	{
 		p = ov->data;
-		if (! p->image.iTexture)
+		if (! p->image.iTexture && ! p->pText)
 			continue;
-		glPushMatrix ();
 		
 		_get_overlay_position_and_size (p, w, h, z, &x, &y, &wo, &ho);
 		if (pIcon->fScale == 1)  // place the overlay on the grid to avoid scale blur (only when the icon is at rest, otherwise it makes the movement jerky).
@@ -293,15 +334,18 @@ void cairo_dock_draw_icon_overlays_opengl (Icon *pIcon, double fRatio)
 				y = round (y);
 		}
 		
-		// translate to the overlay center.
-		glRotatef (-pIcon->fOrientation/G_PI*180., 0., 0., 1.);
-		glTranslatef (x, y, 0.);
-		
-		// draw.
-		_cairo_dock_apply_texture_at_size (p->image.iTexture, wo, ho);
-		
-		glPopMatrix ();
+		// draw at the overlay center; all the overlays are drawn at once.
+		if (p->pText != NULL)
+		{
+			cairo_dock_gl_text_render (p->pText, x, y, wo, ho, pIcon->fAlpha);
+			continue;
+		}
+		cairo_dock_image_buffer_get_texture_coords (&p->image, &u, &v, &du, &dv);
+		cairo_dock_render_batch_add_quad_portion (p->image.iTexture, u, v, du, dv, x, y, wo, ho, pIcon->fAlpha);
 	}
+	cairo_dock_render_batch_flush ();
+	
+	glPopMatrix ();
 	_cairo_dock_disable_texture ();
 }
 
@@ -448,6 +492,7 @@ static void reset_object (GldiObject *obj)
 	
 	// free data
 	cairo_dock_unload_image_buffer (&pOverlay->image);
+	cairo_dock_gl_text_free (pOverlay->pText);
 }
 
 void gldi_register_overlays_manager (void)
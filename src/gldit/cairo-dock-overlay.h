@@ -91,6 +91,8 @@ struct _CairoOverlay {
 	Icon *pIcon;
 	/// data used to identify an overlay
 	gpointer data;
+	/// text drawn instead of the image buffer (OpenGL only), or NULL; the size of the text is the size of the image buffer.
+	CairoDockGLText *pText;
 } ;
 
 
@@ -127,6 +129,18 @@ CairoOverlay *cairo_dock_add_overlay_from_surface (Icon *pIcon, cairo_surface_t
  */
 CairoOverlay *cairo_dock_add_overlay_from_texture (Icon *pIcon, GLuint iTexture, CairoOverlayPosition iPosition, gpointer data);
 
+/** Add an overlay on an icon from a text, drawn with the glyph cache (see \ref cairo_dock_gl_text_set_text). Only use it in OpenGL mode. If a text overlay with the same position and data already exists, its text is simply updated, which is much cheaper than creating a new surface.
+ *@param pIcon the icon
+ *@param cText the text
+ *@param pTextDescription description of the text
+ *@param fMaxScale maximum zoom of the text
+ *@param iMaxWidth maximum width of the text, or 0 to not limit it
+ *@param iPosition position where to display the overlay
+ *@param data data that will be used to look for the overlay in \ref cairo_dock_remove_overlay_at_position; if NULL, then this function can't be used
+ *@return the overlay.
+ */
+CairoOverlay *cairo_dock_add_overlay_from_text (Icon *pIcon, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, CairoOverlayPosition iPosition, gpointer data);
+
 
 /** Set the scale of an overlay; by default it's 0.5
  *@param pOverlay the overlay
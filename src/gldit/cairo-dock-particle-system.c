@@ -23,15 +23,81 @@
 #include <cairo.h>
 
 #include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-opengl.h"  // g_openglConfig.bVboAvailable
 #include "cairo-dock-particle-system.h"
 
+extern CairoDockGLConfig g_openglConfig;
+
 static GLfloat s_pCornerCoords[8] = {0.0, 0.0,
 	0.0, 1.0,
 	1.0, 1.0,
 	1.0, 0.0};
 
+static CairoParticlesStats s_stats;
+
+static inline GLfloat *_add_particle_quad (GLfloat *vertices, GLfloat x, GLfloat y, GLfloat z, GLfloat w, GLfloat h)
+{
+	vertices[0] = x - w;
+	vertices[1] = y + h;
+	vertices[2] = z;
+	vertices[3] = x - w;
+	vertices[4] = y - h;
+	vertices[5] = z;
+	vertices[6] = x + w;
+	vertices[7] = y - h;
+	vertices[8] = z;
+	vertices[9] = x + w;
+	vertices[10] = y + h;
+	vertices[11] = z;
+	return vertices + 12;
+}
+
+static inline GLfloat *_add_particle_color (GLfloat *colors, GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+{
+	int i;
+	for (i = 0; i < 4; i ++)  // same color on the 4 corners.
+	{
+		colors[0] = r;
+		colors[1] = g;
+		colors[2] = b;
+		colors[3] = a;
+		colors += 4;
+	}
+	return colors;
+}
+
+static void _upload_particles (CairoParticleSystem *pParticleSystem, int iNbVertices)
+{
+	int N = pParticleSystem->iNbParticles;
+	if (pParticleSystem->iCoordsVbo == 0)  // the texture coordinates never change, upload them once.
+	{
+		glGenBuffersARB (1, &pParticleSystem->iCoordsVbo);
+		glBindBufferARB (GL_ARRAY_BUFFER_ARB, pParticleSystem->iCoordsVbo);
+		glBufferDataARB (GL_ARRAY_BUFFER_ARB, N * 4 * 2 * sizeof(GLfloat)*2, pParticleSystem->pCoords, GL_STATIC_DRAW_ARB);
+		glGenBuffersARB (1, &pParticleSystem->iVbo);
+	}
+	
+	// the vertices and colors change at each frame: get a new storage (so that we don't wait for the previous frame to be drawn), and only upload the live particles.
+	// layout: [vertices | vertices of the lights | colors | colors of the lights]
+	glBindBufferARB (GL_ARRAY_BUFFER_ARB, pParticleSystem->iVbo);
+	glBufferDataARB (GL_ARRAY_BUFFER_ARB, N * 4 * (3+4) * sizeof(GLfloat)*2, NULL, GL_STREAM_DRAW_ARB);
+	int k, n = (pParticleSystem->bAddLight ? 2 : 1);
+	for (k = 0; k < n; k ++)
+	{
+		glBufferSubDataARB (GL_ARRAY_BUFFER_ARB,
+			k * N * 4 * 3 * sizeof(GLfloat),
+			iNbVertices * 3 * sizeof(GLfloat),
+			&pParticleSystem->pVertices[k * N * 4 * 3]);
+		glBufferSubDataARB (GL_ARRAY_BUFFER_ARB,
+			(2 * N * 4 * 3 + k * N * 4 * 4) * sizeof(GLfloat),
+			iNbVertices * 4 * sizeof(GLfloat),
+			&pParticleSystem->pColors[k * N * 4 * 4]);
+	}
+}
+
 void cairo_dock_render_particles_full (CairoParticleSystem *pParticleSystem, int iDepth)
 {
+	gint64 t0 = g_get_monotonic_time ();
 	_cairo_dock_enable_texture ();
 	
 	if (pParticleSystem->bAddLuminance)
@@ -42,124 +108,76 @@ void cairo_dock_render_particles_full (CairoParticleSystem *pParticleSystem, int
 	
 	glBindTexture(GL_TEXTURE_2D, pParticleSystem->iTexture);
 	
+	// the live particles are packed at the beginning of the arrays, and their lights at the middle.
+	int N = pParticleSystem->iNbParticles;
 	GLfloat *vertices = pParticleSystem->pVertices;
-	///GLfloat *coords = pParticleSystem->pCoords;
 	GLfloat *colors = pParticleSystem->pColors;
-	GLfloat *vertices2 = &pParticleSystem->pVertices[pParticleSystem->iNbParticles * 4 * 3];
-	///GLfloat *coords2 = &pParticleSystem->pCoords[pParticleSystem->iNbParticles * 4 * 2];
-	GLfloat *colors2 = &pParticleSystem->pColors[pParticleSystem->iNbParticles * 4 * 4];
+	GLfloat *vertices2 = &pParticleSystem->pVertices[N * 4 * 3];
+	GLfloat *colors2 = &pParticleSystem->pColors[N * 4 * 4];
 	
 	GLfloat x,y,z;
 	GLfloat w, h;
-	GLfloat fHeight = pParticleSystem->fHeight;
+	GLfloat fScaleX = pParticleSystem->fWidth / 2;
+	GLfloat fOffsetY = (pParticleSystem->bDirectionUp ? 0 : pParticleSystem->fHeight);  // if the system is upside down, y -> fHeight - y
+	GLfloat fScaleY = (pParticleSystem->bDirectionUp ? pParticleSystem->fHeight : - pParticleSystem->fHeight);
+	gboolean bAddLight = pParticleSystem->bAddLight;
 	
-	int numActive = 0;
-	CairoParticle *p;
-	int i;
-	for (i = 0; i < pParticleSystem->iNbParticles; i ++)
+	CairoParticle *p, *pEnd = pParticleSystem->pParticles + N;
+	for (p = pParticleSystem->pParticles; p < pEnd; p ++)
 	{
-		p = &pParticleSystem->pParticles[i];
 		if (p->iLife == 0 || iDepth * p->z < 0)
 			continue;
 		
-		numActive += 4;
 		w = p->fWidth * p->fSizeFactor;
 		h = p->fHeight * p->fSizeFactor;
-		x = p->x * pParticleSystem->fWidth / 2;
-		y = p->y * pParticleSystem->fHeight;
+		x = p->x * fScaleX;
+		y = fOffsetY + p->y * fScaleY;
 		z = p->z;
 		
-		vertices[0] = x - w;
-		vertices[2] = z;
-		vertices[3] = x - w;
-		vertices[5] = z;
-		vertices[6] = x + w;
-		vertices[8] = z;
-		vertices[9] = x + w;
-		vertices[11] = z;
-		if (pParticleSystem->bDirectionUp)
-		{
-			vertices[1] = y + h;
-			vertices[4] = y - h;
-			vertices[7] = y - h;
-			vertices[10] = y + h;
-		}
-		else
-		{
-			vertices[1] = fHeight - y + h;
-			vertices[4] = fHeight - y - h;
-			vertices[7] = fHeight - y - h;
-			vertices[10] = fHeight - y + h;
-		}
-		vertices += 12;
-		
-		///memcpy (coords, s_pCornerCoords, sizeof (s_pCornerCoords));
-		///coords += 8;
-
-		colors[0] = p->color[0];
-		colors[1] = p->color[1];
-		colors[2] = p->color[2];
-		colors[3] = p->color[3];
-		memcpy (colors + 4, colors, 4*sizeof (GLfloat));
-		memcpy (colors + 8, colors, 8*sizeof (GLfloat));
-		colors += 16;
+		vertices = _add_particle_quad (vertices, x, y, z, w, h);
+		colors = _add_particle_color (colors, p->color[0], p->color[1], p->color[2], p->color[3]);
 		
-		if (pParticleSystem->bAddLight)
+		if (bAddLight)
 		{
-			w/=1.6;
-			h/=1.6;
-			vertices2[0] = x - w;
-			vertices2[2] = z;
-			vertices2[3] = x - w;
-			vertices2[5] = z;
-			vertices2[6] = x + w;
-			vertices2[8] = z;
-			vertices2[9] = x + w;
-			vertices2[11] = z;
-			if (pParticleSystem->bDirectionUp)
-			{
-				vertices2[1] = y + h;
-				vertices2[4] = y - h;
-				vertices2[7] = y - h;
-				vertices2[10] = y + h;
-			}
-			else
-			{
-				vertices2[1] = fHeight - y + h;
-				vertices2[4] = fHeight - y - h;
-				vertices2[7] = fHeight - y - h;
-				vertices2[10] = fHeight - y + h;
-			}
-			vertices2 += 12;
-			
-			///memcpy (coords2, s_pCornerCoords, sizeof (s_pCornerCoords));
-			///coords2 += 8;
-			
-			colors2[0] = 1;
-			colors2[1] = 1;
-			colors2[2] = 1;
-			colors2[3] = colors[3];
-			memcpy (colors2 + 4, colors2, 4*sizeof (GLfloat));
-			memcpy (colors2 + 8, colors2, 8*sizeof (GLfloat));
-			colors2 += 16;
+			vertices2 = _add_particle_quad (vertices2, x, y, z, w/1.6, h/1.6);
+			colors2 = _add_particle_color (colors2, 1., 1., 1., p->color[3]);
 		}
 	}
+	int iNbVertices = (vertices - pParticleSystem->pVertices) / 3;
 	
 	glEnableClientState(GL_COLOR_ARRAY);
 	glEnableClientState (GL_TEXTURE_COORD_ARRAY);
 	glEnableClientState (GL_VERTEX_ARRAY);
 	
-	glTexCoordPointer(2, GL_FLOAT, 2 * sizeof(GLfloat), pParticleSystem->pCoords);
-	glVertexPointer(3, GL_FLOAT, 3 * sizeof(GLfloat), pParticleSystem->pVertices);
-	glColorPointer(4, GL_FLOAT, 4 * sizeof(GLfloat), pParticleSystem->pColors);
-
-	glDrawArrays(GL_QUADS, 0, pParticleSystem->bAddLight ? numActive*2 : numActive);
-
+	if (g_openglConfig.bVboAvailable)
+	{
+		_upload_particles (pParticleSystem, iNbVertices);
+		glVertexPointer(3, GL_FLOAT, 3 * sizeof(GLfloat), NULL);
+		glColorPointer(4, GL_FLOAT, 4 * sizeof(GLfloat), (GLvoid*)(2 * N * 4 * 3 * sizeof(GLfloat)));
+		glBindBufferARB (GL_ARRAY_BUFFER_ARB, pParticleSystem->iCoordsVbo);
+		glTexCoordPointer(2, GL_FLOAT, 2 * sizeof(GLfloat), NULL);
+		glBindBufferARB (GL_ARRAY_BUFFER_ARB, 0);
+	}
+	else
+	{
+		glTexCoordPointer(2, GL_FLOAT, 2 * sizeof(GLfloat), pParticleSystem->pCoords);
+		glVertexPointer(3, GL_FLOAT, 3 * sizeof(GLfloat), pParticleSystem->pVertices);
+		glColorPointer(4, GL_FLOAT, 4 * sizeof(GLfloat), pParticleSystem->pColors);
+	}
+	
+	glDrawArrays(GL_QUADS, 0, iNbVertices);
+	if (bAddLight)
+		glDrawArrays(GL_QUADS, N * 4, iNbVertices);  // the lights are after all the particles.
+	
 	glDisableClientState(GL_COLOR_ARRAY);
 	glDisableClientState (GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState (GL_VERTEX_ARRAY);
 	
 	_cairo_dock_disable_texture ();
+	
+	s_stats.iNbRenders ++;
+	s_stats.iNbParticlesRendered += iNbVertices / 4;
+	s_stats.fRenderTime += (g_get_monotonic_time () - t0) / 1000.;
 }
 
 CairoParticleSystem *cairo_dock_create_particle_system (int iNbParticles, GLuint iTexture, double fWidth, double fHeight)
@@ -200,6 +218,10 @@ void cairo_dock_free_particle_system (CairoParticleSystem *pParticleSystem)
 	
 	g_free (pParticleSystem->pParticles);
 	
+	if (pParticleSystem->iVbo != 0)
+		glDeleteBuffersARB (1, &pParticleSystem->iVbo);
+	if (pParticleSystem->iCoordsVbo != 0)
+		glDeleteBuffersARB (1, &pParticleSystem->iCoordsVbo);
 	free (pParticleSystem->pVertices);
 	free (pParticleSystem->pCoords);
 	free (pParticleSystem->pColors);
@@ -208,19 +230,26 @@ void cairo_dock_free_particle_system (CairoParticleSystem *pParticleSystem)
 }
 
 
+// sin() is the most expensive part of the update, and it's only used for a small oscillation, so a fast approximation is enough (error < 0.0011).
+#define TWO_PI 6.28318530717958647692f
+static inline GLfloat _fast_sin (GLfloat x)
+{
+	x -= TWO_PI * floorf (x * (1.f / TWO_PI) + .5f);  // [-pi, pi]
+	GLfloat y = (4.f / G_PI) * x - (4.f / (G_PI * G_PI)) * x * fabsf (x);  // parabola
+	return .225f * (y * fabsf (y) - y) + y;  // corrected
+}
+
 gboolean cairo_dock_update_default_particle_system (CairoParticleSystem *pParticleSystem, CairoDockRewindParticleFunc pRewindParticle)
 {
+	gint64 t0 = g_get_monotonic_time ();
 	gboolean bAllParticlesEnded = TRUE;
-	CairoParticle *p;
-	int i;
-	for (i = 0; i < pParticleSystem->iNbParticles; i ++)
+	CairoParticle *p, *pEnd = pParticleSystem->pParticles + pParticleSystem->iNbParticles;
+	for (p = pParticleSystem->pParticles; p < pEnd; p ++)
 	{
-		p = &(pParticleSystem->pParticles[i]);
-		
 		p->fOscillation += p->fOmega;
-		p->x += p->vx + (p->z + 2)/3. * .02 * sin (p->fOscillation);  // 3%
+		p->x += p->vx + (p->z + 2) * (.02f / 3) * _fast_sin (p->fOscillation);  // 3%
 		p->y += p->vy;
-		p->color[3] = 1.*p->iLife / p->iInitialLife;
+		p->color[3] = (GLfloat)p->iLife / p->iInitialLife;
 		p->fSizeFactor += p->fResizeSpeed;
 		if (p->iLife > 0)
 		{
@@ -229,11 +258,20 @@ gboolean cairo_dock_update_default_particle_system (CairoParticleSystem *pPartic
 			{
 				pRewindParticle (p, pParticleSystem->dt);
 			}
-			if (bAllParticlesEnded && p->iLife != 0)
+			if (p->iLife != 0)
 				bAllParticlesEnded = FALSE;
 		}
 		else if (pRewindParticle)
 			pRewindParticle (p, pParticleSystem->dt);
 	}
+	
+	s_stats.iNbUpdates ++;
+	s_stats.iNbParticlesUpdated += pParticleSystem->iNbParticles;
+	s_stats.fUpdateTime += (g_get_monotonic_time () - t0) / 1000.;
 	return ! bAllParticlesEnded;
 }
+
+void cairo_dock_get_particles_stats (CairoParticlesStats *pStats)
+{
+	*pStats = s_stats;
+}
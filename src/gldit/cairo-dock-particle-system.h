@@ -74,8 +74,28 @@ typedef struct _CairoParticleSystem {
 	gboolean bDirectionUp;
 	gboolean bAddLuminance;
 	gboolean bAddLight;
+	/// VBO where the live particles are streamed at each frame (private).
+	GLuint iVbo;
+	/// VBO of the texture coordinates, that don't change (private).
+	GLuint iCoordsVbo;
 	} CairoParticleSystem;
 
+/// Counters of the particle systems, to measure the cost of the particles per frame.
+typedef struct {
+	/// number of calls to \ref cairo_dock_update_default_particle_system.
+	guint iNbUpdates;
+	/// total number of particles updated.
+	guint64 iNbParticlesUpdated;
+	/// total time spent to update the particles, in ms.
+	double fUpdateTime;
+	/// number of calls to \ref cairo_dock_render_particles_full.
+	guint iNbRenders;
+	/// total number of particles drawn.
+	guint64 iNbParticlesRendered;
+	/// total time spent to fill, upload and draw the particles, in ms.
+	double fRenderTime;
+	} CairoParticlesStats;
+
 /// Function that re-initializes a particle when its life is over.
 typedef void (CairoDockRewindParticleFunc) (CairoParticle *pParticle, double dt);
 
@@ -110,5 +130,10 @@ void cairo_dock_free_particle_system (CairoParticleSystem *pParticleSystem);
 */
 gboolean cairo_dock_update_default_particle_system (CairoParticleSystem *pParticleSystem, CairoDockRewindParticleFunc pRewindParticle);
 
+/** Get the counters of all the particle systems since the beginning. Divide the times by the numbers of particles to get the cost of a particle.
+*@param pStats a structure to fill with the counters.
+*/
+void cairo_dock_get_particles_stats (CairoParticlesStats *pStats);
+
 G_END_DECLS
 #endif
@@ -0,0 +1,104 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-render-batch.h"
+
+// the quads are stored in 3 arrays that can be given directly to OpenGL; they are kept between the flushes to avoid reallocating them each frame.
+static GArray *s_pVertices = NULL;  // 4 vertices (x,y) per quad, in the same order as in _cairo_dock_apply_current_texture_at_size
+static GArray *s_pCoords = NULL;  // 4 texture coordinates (u,v) per quad
+static GArray *s_pColors = NULL;  // 4 colors (r,g,b,a) per quad
+static GArray *s_pTextures = NULL;  // 1 texture per quad
+static CairoDockRenderBatchStats s_batchStats;
+
+void cairo_dock_render_batch_add_colored_quad_portion (GLuint iTexture, double u, double v, double du, double dv, double x, double y, double w, double h, double r, double g, double b, double fAlpha)
+{
+	if (s_pVertices == NULL)
+	{
+		s_pVertices = g_array_sized_new (FALSE, FALSE, sizeof (GLfloat), 16 * 8);
+		s_pCoords = g_array_sized_new (FALSE, FALSE, sizeof (GLfloat), 16 * 8);
+		s_pColors = g_array_sized_new (FALSE, FALSE, sizeof (GLfloat), 16 * 16);
+		s_pTextures = g_array_sized_new (FALSE, FALSE, sizeof (GLuint), 16);
+	}
+	
+	GLfloat x0 = x - .5*w, x1 = x + .5*w;
+	GLfloat y0 = y + .5*h, y1 = y - .5*h;
+	GLfloat vertices[8] = {x0, y0,  x1, y0,  x1, y1,  x0, y1};
+	GLfloat coords[8] = {u, v,  u+du, v,  u+du, v+dv,  u, v+dv};
+	GLfloat colors[16] = {r, g, b, fAlpha,  r, g, b, fAlpha,  r, g, b, fAlpha,  r, g, b, fAlpha};
+	g_array_append_vals (s_pVertices, vertices, 8);
+	g_array_append_vals (s_pCoords, coords, 8);
+	g_array_append_vals (s_pColors, colors, 16);
+	g_array_append_val (s_pTextures, iTexture);
+}
+
+void cairo_dock_render_batch_add_quad_portion (GLuint iTexture, double u, double v, double du, double dv, double x, double y, double w, double h, double fAlpha)
+{
+	cairo_dock_render_batch_add_colored_quad_portion (iTexture, u, v, du, dv, x, y, w, h, 1., 1., 1., fAlpha);
+}
+
+void cairo_dock_render_batch_add_quad (GLuint iTexture, double x, double y, double w, double h, double fAlpha)
+{
+	cairo_dock_render_batch_add_quad_portion (iTexture, 0., 0., 1., 1., x, y, w, h, fAlpha);
+}
+
+void cairo_dock_render_batch_flush (void)
+{
+	if (s_pTextures == NULL || s_pTextures->len == 0)
+		return;
+	
+	GLuint *pTextures = (GLuint*)s_pTextures->data;
+	guint n = s_pTextures->len;
+	
+	glEnableClientState (GL_COLOR_ARRAY);
+	glEnableClientState (GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState (GL_VERTEX_ARRAY);
+	
+	glVertexPointer (2, GL_FLOAT, 0, s_pVertices->data);
+	glTexCoordPointer (2, GL_FLOAT, 0, s_pCoords->data);
+	glColorPointer (4, GL_FLOAT, 0, s_pColors->data);
+	
+	// draw each run of consecutive quads sharing the same texture in a single call, so that the drawing order is preserved.
+	guint i, j;
+	for (i = 0; i < n; i = j)
+	{
+		for (j = i + 1; j < n && pTextures[j] == pTextures[i]; j ++);
+		glBindTexture (GL_TEXTURE_2D, pTextures[i]);
+		glDrawArrays (GL_QUADS, 4 * i, 4 * (j - i));
+		s_batchStats.iNbDrawCalls ++;
+	}
+	s_batchStats.iNbQuads += n;
+	
+	glDisableClientState (GL_COLOR_ARRAY);
+	glDisableClientState (GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState (GL_VERTEX_ARRAY);
+	
+	// the current color is undefined after drawing with a color array; set it as if the quads had been drawn one by one.
+	_cairo_dock_set_alpha (g_array_index (s_pColors, GLfloat, 16 * n - 1));
+	
+	g_array_set_size (s_pVertices, 0);
+	g_array_set_size (s_pCoords, 0);
+	g_array_set_size (s_pColors, 0);
+	g_array_set_size (s_pTextures, 0);
+}
+
+void cairo_dock_render_batch_get_stats (CairoDockRenderBatchStats *pStats)
+{
+	*pStats = s_batchStats;
+}
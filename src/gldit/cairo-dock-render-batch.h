@@ -0,0 +1,95 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_RENDER_BATCH__
+#define  __CAIRO_DOCK_RENDER_BATCH__
+
+#include <glib.h>
+#include <GL/gl.h>
+
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-render-batch.h A render batch collects textured quads and draws them with as few draw calls as possible, instead of one glBegin/glEnd per quad.
+* The quads are drawn in the order they were added, so the result is the same as if they were drawn one by one; consecutive quads using the same texture are drawn in a single call.
+* All the quads of a batch are drawn with the current modelview matrix and blending function at the time of the flush, so the batch must be flushed before changing them.
+*/
+
+/// Counters of the render batches, to measure the number of draw calls.
+typedef struct {
+	/// number of quads drawn.
+	guint iNbQuads;
+	/// number of draw calls used to draw them.
+	guint iNbDrawCalls;
+} CairoDockRenderBatchStats;
+
+/** Add a quad showing a whole texture to the current batch. Nothing is drawn until \ref cairo_dock_render_batch_flush is called.
+*@param iTexture the texture of the quad; it must stay valid until the batch is flushed.
+*@param x horizontal position of the center of the quad, in the current modelview space.
+*@param y vertical position of the center of the quad, in the current modelview space.
+*@param w width of the quad.
+*@param h height of the quad.
+*@param fAlpha transparency of the quad, between 0 and 1.
+*/
+void cairo_dock_render_batch_add_quad (GLuint iTexture, double x, double y, double w, double h, double fAlpha);
+
+/** Add a quad showing a part of a texture to the current batch (for instance an image of a texture atlas). Nothing is drawn until \ref cairo_dock_render_batch_flush is called.
+*@param iTexture the texture of the quad; it must stay valid until the batch is flushed.
+*@param u horizontal texture coordinate of the top-left corner of the part, between 0 and 1.
+*@param v vertical texture coordinate of the top-left corner of the part, between 0 and 1.
+*@param du width of the part, in texture coordinates.
+*@param dv height of the part, in texture coordinates.
+*@param x horizontal position of the center of the quad, in the current modelview space.
+*@param y vertical position of the center of the quad, in the current modelview space.
+*@param w width of the quad.
+*@param h height of the quad.
+*@param fAlpha transparency of the quad, between 0 and 1.
+*/
+void cairo_dock_render_batch_add_quad_portion (GLuint iTexture, double u, double v, double du, double dv, double x, double y, double w, double h, double fAlpha);
+
+/** Add a quad showing a part of a texture multiplied by a color to the current batch (for instance to colorize a white text). Nothing is drawn until \ref cairo_dock_render_batch_flush is called.
+*@param iTexture the texture of the quad; it must stay valid until the batch is flushed.
+*@param u horizontal texture coordinate of the top-left corner of the part, between 0 and 1.
+*@param v vertical texture coordinate of the top-left corner of the part, between 0 and 1.
+*@param du width of the part, in texture coordinates.
+*@param dv height of the part, in texture coordinates.
+*@param x horizontal position of the center of the quad, in the current modelview space.
+*@param y vertical position of the center of the quad, in the current modelview space.
+*@param w width of the quad.
+*@param h height of the quad.
+*@param r red component of the color, between 0 and 1.
+*@param g green component of the color, between 0 and 1.
+*@param b blue component of the color, between 0 and 1.
+*@param fAlpha transparency of the quad, between 0 and 1.
+*/
+void cairo_dock_render_batch_add_colored_quad_portion (GLuint iTexture, double u, double v, double du, double dv, double x, double y, double w, double h, double r, double g, double b, double fAlpha);
+
+/** Draw all the quads of the current batch in the order they were added, and empty the batch. It does nothing if the batch is empty.
+* Texturing must be enabled, and the quads are drawn with the current modelview matrix and blending function. Afterwards, the current color is the one of the last quad, as if the quads had been drawn one by one.
+*/
+void cairo_dock_render_batch_flush (void);
+
+/** Get the counters of the render batches since the beginning (the quads are only counted when they are flushed).
+*@param pStats a structure to fill with the counters.
+*/
+void cairo_dock_render_batch_get_stats (CairoDockRenderBatchStats *pStats);
+
+G_END_DECLS
+#endif
@@ -205,6 +205,7 @@ static gboolean delete_object (GldiObject *obj)
 	{
 		GList *pSubIcons = icon->pSubDock->icons;
 		icon->pSubDock->icons = NULL;
+		cairo_dock_invalidate_icons_layout (icon->pSubDock);
 		GList *ic;
 		for (ic = pSubIcons; ic != NULL; ic = ic->next)
 		{
@@ -395,6 +395,7 @@ typedef struct _Icon Icon;
 typedef struct _GldiContainer GldiContainer;
 typedef struct _GldiContainerInterface GldiContainerInterface;
 typedef struct _CairoDock CairoDock;
+typedef struct _CairoDockIconsLayout CairoDockIconsLayout;
 typedef struct _CairoDesklet CairoDesklet;
 typedef struct _CairoDialog CairoDialog;
 typedef struct _CairoFlyingContainer CairoFlyingContainer;
@@ -436,10 +437,14 @@ typedef struct _CairoDockGLConfig CairoDockGLConfig;
 
 typedef struct _CairoDockGLFont CairoDockGLFont;
 
+typedef struct _CairoDockGLText CairoDockGLText;
+
 typedef struct _CairoDockGLPath CairoDockGLPath;
 
 typedef struct _CairoDockImageBuffer CairoDockImageBuffer;
 
+typedef struct _CairoDockAtlasSlot CairoDockAtlasSlot;
+
 typedef struct _CairoOverlay CairoOverlay;
 
 typedef struct _GldiTask GldiTask;
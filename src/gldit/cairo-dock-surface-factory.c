@@ -30,6 +30,8 @@
 #include "cairo-dock-icon-manager.h"  // cairo_dock_search_icon_s_path
 #include "cairo-dock-dialog-manager.h"
 #include "cairo-dock-style-manager.h"
+#include "cairo-dock-image-cache.h"
+#include "cairo-dock-trace.h"
 #include "cairo-dock-surface-factory.h"
 
 extern GldiContainer *g_pPrimaryContainer;
@@ -261,6 +263,58 @@ static inline void _apply_orientation_and_scale (cairo_t *pCairoContext, CairoDo
 }
 
 
+// divide by 255 with the same result as the former float division followed by a truncation (checked for all alpha and color values), but with only integer operations.
+#define _div_255(x) (((x) + 1 + ((x) >> 8)) >> 8)
+static void _premultiply_xicon_buffer (const gulong *pXPixels, guint32 *pPixels, int n)
+{
+	// pPixels may be the same memory as pXPixels: since sizeof(gulong) >= sizeof(guint32), each pixel is read before being overwritten.
+	int i;
+	guint32 pixel, alpha;
+	for (i = 0; i < n; i ++)
+	{
+		pixel = (guint32) pXPixels[i];
+		alpha = pixel >> 24;
+		pPixels[i] = (pixel & 0xFF000000)
+			| (_div_255 (((pixel >> 16) & 0xFF) * alpha) << 16)
+			| (_div_255 (((pixel >> 8) & 0xFF) * alpha) << 8)
+			| _div_255 ((pixel & 0xFF) * alpha);
+	}
+}
+
+// reduce a premultiplied ARGB image by an integer factor, by averaging each square of k x k pixels. It is done in place, since each pixel of the result is written after all the pixels it's made of have been read.
+static void _reduce_xicon_buffer (guint32 *pPixels, int w, int h, int k)
+{
+	int w_ = w / k, h_ = h / k;
+	guint n = k * k;
+	guint a, r, g, b;
+	guint32 pixel;
+	int x, y, i, j;
+	const guint32 *p;
+	for (y = 0; y < h_; y ++)
+	{
+		for (x = 0; x < w_; x ++)
+		{
+			a = r = g = b = 0;
+			for (j = 0; j < k; j ++)
+			{
+				p = &pPixels[(y * k + j) * w + x * k];
+				for (i = 0; i < k; i ++)
+				{
+					pixel = p[i];
+					a += pixel >> 24;
+					r += (pixel >> 16) & 0xFF;
+					g += (pixel >> 8) & 0xFF;
+					b += pixel & 0xFF;
+				}
+			}
+			pPixels[y * w_ + x] = (((a + n/2) / n) << 24)
+				| (((r + n/2) / n) << 16)
+				| (((g + n/2) / n) << 8)
+				| ((b + n/2) / n);
+		}
+	}
+}
+
 cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuffer, int iBufferNbElements, int iWidth, int iHeight)
 {
 	//\____________________ On recupere la plus grosse des icones presentes dans le tampon (meilleur rendu).
@@ -285,29 +339,26 @@ cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuff
 	iBestIndex += 2;
 	//g_print ("%s (%dx%d)\n", __func__, w, h);
 	
-	int i, n = w * h;
+	int n = w * h;
 	if (iBestIndex + n > iBufferNbElements)  // precaution au cas ou le nombre d'elements dans le buffer serait incorrect.
 	{
 		cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
 		return NULL;
 	}
-	gint pixel, alpha, red, green, blue;
-	float fAlphaFactor;
 	gint *pPixelBuffer = (gint *) &pXIconBuffer[iBestIndex];  // on va ecrire le resultat du filtre directement dans le tableau fourni en entree. C'est ok car sizeof(gulong) >= sizeof(gint), donc le tableau de pixels est plus petit que le buffer fourni en entree. merci a Hannemann pour ses tests et ses screenshots ! :-)
-	for (i = 0; i < n; i ++)
+	_premultiply_xicon_buffer (&pXIconBuffer[iBestIndex], (guint32 *)pPixelBuffer, n);
+	
+	//\____________________ On reduit l'image d'un facteur entier si elle est beaucoup plus grande que la taille voulue (les applis fournissent souvent des icones en 256x256 ou plus), cairo n'a plus alors qu'a faire une petite mise a l'echelle.
+	int iFactor = MIN (w / MAX (iWidth, 1), h / MAX (iHeight, 1));
+	while (iFactor > 1 && (w % iFactor != 0 || h % iFactor != 0))  // only take a factor that divides the size, so that no pixel is lost on the edges.
+		iFactor --;
+	if (iFactor > 1)
 	{
-		pixel = (gint) pXIconBuffer[iBestIndex+i];
-		alpha = (pixel & 0xFF000000) >> 24;
-		red   = (pixel & 0x00FF0000) >> 16;
-		green = (pixel & 0x0000FF00) >> 8;
-		blue  = (pixel & 0x000000FF);
-		fAlphaFactor = (float) alpha / 255;
-		red *= fAlphaFactor;
-		green *= fAlphaFactor;
-		blue *= fAlphaFactor;
-		pPixelBuffer[i] = (pixel & 0xFF000000) + (red << 16) + (green << 8) + blue;
+		_reduce_xicon_buffer ((guint32 *)pPixelBuffer, w, h, iFactor);
+		w /= iFactor;
+		h /= iFactor;
 	}
-
+	
 	//\____________________ On cree la surface a partir du tampon.
 	int iStride = w * sizeof (gint);  // nbre d'octets entre le debut de 2 lignes.
 	cairo_surface_t *surface_ini = cairo_image_surface_create_for_data ((guchar *)pPixelBuffer,
@@ -428,7 +479,7 @@ cairo_surface_t *cairo_dock_create_surface_from_pixbuf (GdkPixbuf *pixbuf, doubl
 }
 
 
-cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+static cairo_surface_t *_create_surface_from_image (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
 {
 	//g_print ("%s (%s, %dx%dx%.2f, %d)\n", __func__, cImagePath, iWidthConstraint, iHeightConstraint, fMaxScale, iLoadingModifier);
 	g_return_val_if_fail (cImagePath != NULL, NULL);
@@ -441,6 +492,11 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 	double fIconWidthSaturationFactor = 1.;
 	double fIconHeightSaturationFactor = 1.;
 	
+	//\_______________ the image may have been loaded at this size before.
+	pNewSurface = cairo_dock_image_cache_lookup (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, fImageWidth, fImageHeight, fZoomX, fZoomY);
+	if (pNewSurface != NULL)
+		return pNewSurface;
+	
 	//\_______________ On cherche a determiner le type de l'image. En effet, les SVG et les PNG sont charges differemment des autres.
 	gboolean bIsSVG = FALSE, bIsPNG = FALSE, bIsXPM = FALSE;
 	FILE *fd = fopen (cImagePath, "r");
@@ -585,9 +641,47 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 	if (fZoomY != NULL)
 		*fZoomY = fIconHeightSaturationFactor;
 	
+	if (pNewSurface != NULL)
+		cairo_dock_image_cache_store (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, pNewSurface, *fImageWidth, *fImageHeight, fIconWidthSaturationFactor, fIconHeightSaturationFactor);
+	
 	return pNewSurface;
 }
 
+cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	gldi_trace_begin_with_arg ("load image", "image", cImagePath);
+	cairo_surface_t *pSurface = _create_surface_from_image (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, fImageWidth, fImageHeight, fZoomX, fZoomY);
+	gldi_trace_end ("load image", "image");
+	gldi_trace_count ("images loaded", 1);
+	return pSurface;
+}
+
+static gchar *s_cPreloadedImagePath = NULL;
+static int s_iPreloadedWidth = 0, s_iPreloadedHeight = 0;
+static cairo_surface_t *s_pPreloadedSurface = NULL;
+
+void cairo_dock_set_preloaded_surface (const gchar *cImagePath, int iWidth, int iHeight, cairo_surface_t *pSurface)
+{
+	if (s_pPreloadedSurface != NULL)
+		cairo_surface_destroy (s_pPreloadedSurface);
+	g_free (s_cPreloadedImagePath);
+	s_cPreloadedImagePath = (pSurface != NULL ? g_strdup (cImagePath) : NULL);
+	s_iPreloadedWidth = iWidth;
+	s_iPreloadedHeight = iHeight;
+	s_pPreloadedSurface = pSurface;
+}
+
+static cairo_surface_t *_take_preloaded_surface (const gchar *cImagePath, int iWidth, int iHeight)
+{
+	if (s_pPreloadedSurface == NULL
+	|| iWidth != s_iPreloadedWidth || iHeight != s_iPreloadedHeight
+	|| g_strcmp0 (cImagePath, s_cPreloadedImagePath) != 0)
+		return NULL;
+	cairo_surface_t *pSurface = s_pPreloadedSurface;
+	s_pPreloadedSurface = NULL;
+	return pSurface;
+}
+
 cairo_surface_t *cairo_dock_create_surface_from_image_simple (const gchar *cImageFile, double fImageWidth, double fImageHeight)
 {
 	g_return_val_if_fail (cImageFile != NULL, NULL);
@@ -597,8 +691,16 @@ cairo_surface_t *cairo_dock_create_surface_from_image_simple (const gchar *cImag
 		cImagePath = (gchar *)cImageFile;
 	else
 		cImagePath = cairo_dock_search_image_s_path (cImageFile);
-		
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_image (cImagePath,
+	
+	cairo_surface_t *pSurface = _take_preloaded_surface (cImagePath, fImageWidth, fImageHeight);  // the image may have been loaded already in a thread.
+	if (pSurface != NULL)
+	{
+		if (cImagePath != cImageFile)
+			g_free (cImagePath);
+		return pSurface;
+	}
+	
+	pSurface = cairo_dock_create_surface_from_image (cImagePath,
 		1.,
 		fImageWidth,
 		fImageHeight,
@@ -122,6 +122,14 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 */
 cairo_surface_t *cairo_dock_create_surface_from_image_simple (const gchar *cImageFile, double fImageWidth, double fImageHeight);
 
+/** Give a surface that has already been created from an image (for instance in a thread), so that the next call to \ref cairo_dock_create_surface_from_image_simple for the same image and size returns it instead of loading the image again. Only one surface is kept; it is meant to be set just before loading an icon, and reset just after.
+*@param cImagePath path of the image.
+*@param iWidth width of the surface.
+*@param iHeight height of the surface.
+*@param pSurface the surface, which is taken by the function; NULL to reset (any unused surface is then destroyed).
+*/
+void cairo_dock_set_preloaded_surface (const gchar *cImagePath, int iWidth, int iHeight, cairo_surface_t *pSurface);
+
 /** Create a surface from any image, at a given size. If the image is given by its sole name, it is searched inside the icons themes known by Cairo-Dock. 
 *@param cImagePath path or name of an image.
 *@param fImageWidth the desired surface width.
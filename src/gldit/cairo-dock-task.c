@@ -21,29 +21,33 @@
 #include <stdlib.h>
 
 #include "cairo-dock-log.h"
+#include "cairo-dock-timer.h"
 #include "cairo-dock-task.h"
 
-#ifndef GLIB_VERSION_2_32
-#define G_MUTEX_INIT(a)  a = g_mutex_new ()
-#define G_COND_INIT(a)   a = g_cond_new ()
-#define G_MUTEX_CLEAR(a) g_mutex_free (a)
-#define G_COND_CLEAR(a)  g_cond_free (a)
-#define G_THREAD_UNREF(t) g_free (t)
-#else
-#define G_MUTEX_INIT(a)  a = g_new (GMutex, 1); g_mutex_init (a)
-#define G_COND_INIT(a)   a = g_new (GCond, 1);  g_cond_init (a)
-#define G_MUTEX_CLEAR(a) g_mutex_clear (a); g_free (a)
-#define G_COND_CLEAR(a)  g_cond_clear (a);  g_free (a)
-#define G_THREAD_UNREF(t) if (t) g_thread_unref (t)
-#endif
+// maximum number of worker threads shared by all the tasks.
+#define GLDI_TASK_POOL_MAX_THREADS 8
+// a 'get_data' that lasts longer than this (in us) is considered blocking (like a download), and the next iterations of its task go in a separate pool, so that they don't starve the other tasks.
+#define GLDI_TASK_SLOW_JOB_TIME 500000
+// unused workers exit after this delay (ms), so that an idle dock doesn't keep any thread.
+#define GLDI_TASK_POOL_MAX_IDLE_TIME 15000
+
+static GThreadPool *s_pTaskPool = NULL;
+static GThreadPool *s_pSlowTaskPool = NULL;
+
+// a job is one iteration of a task, from the time it's pushed in a pool until the main loop has processed its result.
+typedef struct {
+	GldiTask *pTask;
+	gint iGeneration;  // generation of the task when the job was launched; if the task has been stopped since, the job is stale.
+	gboolean bSlow;  // TRUE if its 'get_data' took more than GLDI_TASK_SLOW_JOB_TIME.
+} GldiTaskJob;
 
 #define _schedule_next_iteration(pTask) do {\
 	if (pTask->iSidTimer == 0 && pTask->iPeriod)\
-		pTask->iSidTimer = g_timeout_add_seconds (pTask->iPeriod, (GSourceFunc) _launch_task_timer, pTask); } while (0)
+		pTask->iSidTimer = gldi_timer_add_seconds (pTask->iPeriod, (GSourceFunc) _launch_task_timer, pTask); } while (0)
 
 #define _cancel_next_iteration(pTask) do {\
 	if (pTask->iSidTimer != 0) {\
-		g_source_remove (pTask->iSidTimer);\
+		gldi_timer_remove (pTask->iSidTimer);\
 		pTask->iSidTimer = 0; } } while (0)
 
 #define _set_elapsed_time(pTask) do {\
@@ -54,106 +58,169 @@
 	if (pTask->free_data)\
 		pTask->free_data (pTask->pSharedMemory);\
 	g_timer_destroy (pTask->pClock);\
-	G_MUTEX_CLEAR (pTask->pMutex);\
-	if (pTask->pCond) {\
-		G_COND_CLEAR (pTask->pCond); }\
-	G_THREAD_UNREF (pTask->pThread);\
+	g_mutex_clear (pTask->pMutex);\
+	g_free (pTask->pMutex);\
 	g_free (pTask); } while (0)
 
+static void _wait_for_get_data (GldiTask *pTask)
+{
+	// the worker holds the mutex during the whole 'get_data', so this waits for it only if it has started; a job that is still waiting in the pool is stale now, the worker will skip it.
+	g_mutex_lock (pTask->pMutex);
+	g_mutex_unlock (pTask->pMutex);
+}
+
 static gboolean _launch_task_timer (GldiTask *pTask)
 {
 	gldi_task_launch (pTask);
 	return TRUE;
 }
-static gboolean _check_for_update_idle (GldiTask *pTask)
+
+  ////////////////////
+ /// UPDATE QUEUE ///
+////////////////////
+
+// the jobs whose 'get_data' is over are pushed by the workers into a single queue, which is watched by a source of the main loop. The main loop is woken up only when a job is pushed, instead of polling each task until its worker is done.
+static GAsyncQueue *s_pUpdateQueue = NULL;
+static GSource *s_pUpdateSource = NULL;
+static GldiTaskStats s_stats = {0, 0};
+
+static void _update_task (GldiTaskJob *pJob)
 {
-	// process the data (we don't need to wait that the thread is over, so do it now, it will let more time for the thread to finish, and therfore often save a 'usleep').
-	if (pTask->bNeedsUpdate)  // data are ready to be processed -> perform the update
+	// the main loop is the only one to change the generation and the number of jobs, and the worker doesn't touch the task any more once the job is pushed, so there is nothing to lock here.
+	GldiTask *pTask = pJob->pTask;
+	gboolean bStale = (pJob->iGeneration != g_atomic_int_get (&pTask->iGeneration));
+	if (! bStale)
+		pTask->bSlowJob = pJob->bSlow;
+	g_free (pJob);
+	pTask->iNbJobs --;
+	
+	if (bStale)  // the task has been stopped since the job was launched, skip its result; the task is not running any more, or runs a newer job.
 	{
-		if (! pTask->bDiscard)  // of course if the task has been discarded before, don't do anything.
-		{
-			pTask->bContinue = pTask->update (pTask->pSharedMemory);
-		}
-		pTask->bNeedsUpdate = FALSE;  // now update is done, we won't do it any more until the next iteration, even is we loop on this function.
+		if (pTask->bDiscard && pTask->iNbJobs == 0)  // it has been discarded in the meantime, and this was its last job.
+			_free_task (pTask);
+		return;
 	}
+	s_stats.iNbIterations ++;
 	
-	// finish the iteration, and possibly schedule the next one (the thread must be finished for this part).
-	if (g_mutex_trylock (pTask->pMutex))  // if the thread is over
+	// process the data
+	if (! pTask->bDiscard)  // of course if the task has been discarded before, don't do anything.
 	{
-		if (pTask->bDiscard)  // if the task has been discarded, it's the end of the journey for it.
-		{
-			if (pTask->pCond)
-			{
-				pTask->bRunThread = TRUE;
-				g_cond_signal (pTask->pCond);
-				g_mutex_unlock (pTask->pMutex);
-				g_thread_join (pTask->pThread); // unref the thread
-			}
-			else
-			{
-				g_mutex_unlock (pTask->pMutex);
-				G_THREAD_UNREF (pTask->pThread);
-			}
-			pTask->pThread = NULL;
+		pTask->bContinue = pTask->update (pTask->pSharedMemory);
+	}
+	
+	if (pTask->bDiscard)  // if the task has been discarded (possibly inside the 'update'), it's the end of the journey for it.
+	{
+		if (pTask->iNbJobs == 0)  // else a stale job is still in a pool, the task will be freed when it comes back.
 			_free_task (pTask);
-			return FALSE;
-		}
-		
-		if (! pTask->pCond)  // one-shot thread => the thread is over
-		{
-			G_THREAD_UNREF (pTask->pThread);
-			pTask->pThread = NULL;
-		}
-		
-		pTask->iSidUpdateIdle = 0;  // set it before the unlock, as it is accessed in the thread part
-		g_mutex_unlock (pTask->pMutex);
-		
-		// schedule the next iteration if necessary.
-		if (! pTask->bContinue)
-		{
-			_cancel_next_iteration (pTask);
-		}
-		else
-		{
-			pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
-			_schedule_next_iteration (pTask);
-		}
-		pTask->bIsRunning = FALSE;
-		return FALSE;  // the update is now finished, quit.
+		return;
 	}
 	
-	// if the thread is not yet over, come back in 1ms.
-	g_usleep (1);  // we don't want to block the main loop until the thread is over; so just sleep 1ms to give it a chance to terminate. so it's a kind of 'sched_yield()' wihout blocking the main loop.
-	return TRUE;
+	// schedule the next iteration if necessary.
+	if (! pTask->bContinue)
+	{
+		_cancel_next_iteration (pTask);
+	}
+	else
+	{
+		pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
+		_schedule_next_iteration (pTask);
+	}
+	pTask->bIsRunning = FALSE;
 }
-static gpointer _get_data_threaded (GldiTask *pTask)
+
+static gboolean _update_source_prepare (G_GNUC_UNUSED GSource *pSource, gint *iTimeout)
+{
+	*iTimeout = -1;  // no need to poll, the workers wake the main loop up.
+	return (g_async_queue_length (s_pUpdateQueue) > 0);
+}
+static gboolean _update_source_check (G_GNUC_UNUSED GSource *pSource)
 {
+	return (g_async_queue_length (s_pUpdateQueue) > 0);
+}
+static gboolean _update_source_dispatch (G_GNUC_UNUSED GSource *pSource, G_GNUC_UNUSED GSourceFunc callback, G_GNUC_UNUSED gpointer data)
+{
+	s_stats.iNbWakeups ++;
+	GldiTaskJob *pJob;
+	while ((pJob = g_async_queue_try_pop (s_pUpdateQueue)) != NULL)
+		_update_task (pJob);
+	return G_SOURCE_CONTINUE;
+}
+static GSourceFuncs s_updateSourceFuncs = {
+	_update_source_prepare,
+	_update_source_check,
+	_update_source_dispatch,
+	NULL, NULL, NULL
+};
+
+static void _init_update_queue (void)
+{
+	s_pUpdateQueue = g_async_queue_new ();
+	s_pUpdateSource = g_source_new (&s_updateSourceFuncs, sizeof (GSource));
+	g_source_set_priority (s_pUpdateSource, G_PRIORITY_DEFAULT_IDLE);  // same priority as the idle we used before; updates are not urgent.
+	g_source_attach (s_pUpdateSource, NULL);  // the main loop runs the default context.
+}
+
+static void _get_data_threaded (GldiTaskJob *pJob, G_GNUC_UNUSED gpointer data)
+{
+	GldiTask *pTask = pJob->pTask;
 	g_mutex_lock (pTask->pMutex);
-	_run_thread:  // at this point the mutex is locked, either by the first execution of this function, or by 'g_cond_wait'
-	
-	//\_______________________ get the data
-	_set_elapsed_time (pTask);
-	pTask->get_data (pTask->pSharedMemory);
+	if (pJob->iGeneration == g_atomic_int_get (&pTask->iGeneration))  // else the task has been stopped while the job was waiting in the pool, skip it.
+	{
+		//\_______________________ get the data
+		_set_elapsed_time (pTask);
+		if (g_atomic_int_get (&pTask->bDiscard) == 0)  // the task may have been discarded while it was waiting in the pool.
+		{
+			gint64 iStartTime = g_get_monotonic_time ();
+			pTask->get_data (pTask->pSharedMemory);
+			pJob->bSlow = (g_get_monotonic_time () - iStartTime > GLDI_TASK_SLOW_JOB_TIME);
+		}
+	}
+	g_mutex_unlock (pTask->pMutex);
 	
-	// and signal that data are ready to be processed.
-	pTask->bNeedsUpdate = TRUE;  // this is only accessed by the update fonction, which is triggered just after, so no need to protect this variable.
+	//\_______________________ let the main loop call the update function; a skipped job goes there too, since only the main loop can release the task.
+	g_async_queue_push (s_pUpdateQueue, pJob);
+	g_main_context_wakeup (NULL);  // the task can't be used any more at this point, it may have been freed already.
+}
+static GThreadPool *_new_pool (void)
+{
+	GError *erreur = NULL;
+	GThreadPool *pPool = g_thread_pool_new ((GFunc) _get_data_threaded, NULL, GLDI_TASK_POOL_MAX_THREADS, FALSE, &erreur);  // FALSE <=> threads are spawned on demand and can be shared with other pools.
+	if (erreur != NULL)
+	{
+		cd_warning (erreur->message);
+		g_error_free (erreur);
+		return NULL;
+	}
+	return pPool;
+}
+static gboolean _push_in_pool (GldiTask *pTask)
+{
+	if (s_pTaskPool == NULL)
+	{
+		s_pTaskPool = _new_pool ();
+		s_pSlowTaskPool = _new_pool ();
+		if (s_pTaskPool == NULL || s_pSlowTaskPool == NULL)
+			return FALSE;
+		g_thread_pool_set_max_idle_time (GLDI_TASK_POOL_MAX_IDLE_TIME);
+		_init_update_queue ();
+	}
 	
-	//\_______________________ call the update function from the main loop
-	if (pTask->iSidUpdateIdle == 0)
-		pTask->iSidUpdateIdle = g_idle_add ((GSourceFunc) _check_for_update_idle, pTask);  // note that 'iSidUpdateIdle' can actually be set after the 'update' is called. that's why the 'update' have to wait for the mutex to finish its job.
+	GldiTaskJob *pJob = g_new0 (GldiTaskJob, 1);
+	pJob->pTask = pTask;
+	pJob->iGeneration = g_atomic_int_get (&pTask->iGeneration);
+	pTask->iNbJobs ++;
 	
-	// sleep until the next iteration or just leave.
-	if (pTask->pCond)  // periodic task -> block until the condition becomes TRUE again.
+	GError *erreur = NULL;
+	g_thread_pool_push (pTask->bSlowJob ? s_pSlowTaskPool : s_pTaskPool, pJob, &erreur);
+	if (erreur != NULL)  // on n'a pas pu lancer le thread.
 	{
-		pTask->bRunThread = FALSE;
-		while (! pTask->bRunThread)
-			g_cond_wait (pTask->pCond, pTask->pMutex);  // releases the mutex, then takes it again when awakening.
-		if (g_atomic_int_get (&pTask->bDiscard) == 0)
-			goto _run_thread;
+		cd_warning (erreur->message);
+		g_error_free (erreur);
+		pTask->iNbJobs --;
+		g_free (pJob);
+		return FALSE;
 	}
-	g_mutex_unlock (pTask->pMutex);
-	g_thread_exit (NULL);
-	return NULL;
+	return TRUE;
 }
 void gldi_task_launch (GldiTask *pTask)
 {
@@ -172,36 +239,12 @@ void gldi_task_launch (GldiTask *pTask)
 			_schedule_next_iteration (pTask);
 		}
 	}
-	else  // launch the asynchronous work in a thread
+	else if (! pTask->bIsRunning)  // launch the asynchronous work in the pool
 	{
-		if (pTask->pThread == NULL)  // no thread yet -> create and launch it
-		{
-			pTask->bIsRunning = TRUE;
-			GError *erreur = NULL;
-			#ifndef GLIB_VERSION_2_32
-			pTask->pThread = g_thread_create ((GThreadFunc) _get_data_threaded, pTask, TRUE, &erreur);  // TRUE <=> joinable
-			#else
-			pTask->pThread = g_thread_try_new ("Cairo-Dock Task", (GThreadFunc) _get_data_threaded, pTask, &erreur);
-			#endif
-			if (erreur != NULL)  // on n'a pas pu lancer le thread.
-			{
-				cd_warning (erreur->message);
-				g_error_free (erreur);
-				pTask->bIsRunning = FALSE;
-			}
-		}
-		else  // thread already exists; it's either running or sleeping or finished with a pending update
-		if (pTask->pCond && g_mutex_trylock (pTask->pMutex))  // it's a periodic thread, and it's not currently running...
-		{
-			if (pTask->iSidUpdateIdle == 0)  // ...and it doesn't have a pending update -> awake it and run it again.
-			{
-				pTask->bRunThread = TRUE;
-				pTask->bIsRunning = TRUE;
-				g_cond_signal (pTask->pCond);
-			}
-			g_mutex_unlock (pTask->pMutex);
-		}  // else it's a one-shot thread or it's currently running or has a pending update -> don't launch it. so if the task is periodic, it will skip this iteration.
-	}
+		pTask->bIsRunning = TRUE;
+		if (! _push_in_pool (pTask))
+			pTask->bIsRunning = FALSE;
+	}  // else the previous iteration is still in the pool or has a pending update -> don't launch it. so if the task is periodic, it will skip this iteration.
 }
 
 
@@ -214,10 +257,7 @@ static gboolean _one_shot_timer (GldiTask *pTask)
 void gldi_task_launch_delayed (GldiTask *pTask, double fDelay)
 {
 	_cancel_next_iteration (pTask);
-	if (fDelay == 0)
-		pTask->iSidTimer = g_idle_add ((GSourceFunc) _one_shot_timer, pTask);
-	else
-		pTask->iSidTimer = g_timeout_add (fDelay, (GSourceFunc) _one_shot_timer, pTask);
+	pTask->iSidTimer = gldi_timer_add (fDelay, (GSourceFunc) _one_shot_timer, pTask);  // with a delay of 0, it will be launched on the next wakeup of the timers.
 }
 
 
@@ -230,11 +270,8 @@ GldiTask *gldi_task_new_full (int iPeriod, GldiGetDataAsyncFunc get_data, GldiUp
 	pTask->free_data = free_data;
 	pTask->pSharedMemory = pSharedMemory;
 	pTask->pClock = g_timer_new ();
-	G_MUTEX_INIT (pTask->pMutex);
-	if (iPeriod != 0)
-	{
-		G_COND_INIT (pTask->pCond);
-	}
+	pTask->pMutex = g_new (GMutex, 1);  // a pointer, to keep the size of the structure.
+	g_mutex_init (pTask->pMutex);
 	return pTask;
 }
 
@@ -248,42 +285,15 @@ void gldi_task_stop (GldiTask *pTask)
 	
 	if (gldi_task_is_running (pTask))
 	{
-		if (pTask->pThread)
+		g_atomic_int_inc (&pTask->iGeneration);  // the current job is stale now: if it's still in the pool, the worker will skip it, and its result won't be processed.
+		if (pTask->get_data != NULL)
 		{
 			g_atomic_int_set (&pTask->bDiscard, 1);  // set the discard flag to help the 'get_data' callback knows that it should stop.
-			if (pTask->pCond)  // the thread might be sleeping, awake it.
-			{
-				if (g_mutex_trylock (pTask->pMutex))
-				{
-					pTask->bRunThread = TRUE;
-					g_cond_signal (pTask->pCond);
-					g_mutex_unlock (pTask->pMutex);
-				}
-			}
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
+			_wait_for_get_data (pTask);
 			g_atomic_int_set (&pTask->bDiscard, 0);
 		}
-		if (pTask->iSidUpdateIdle != 0)  // do it after the thread has possibly scheduled the 'update'
-		{
-			g_source_remove (pTask->iSidUpdateIdle);
-			pTask->iSidUpdateIdle = 0;
-		}
 		pTask->bIsRunning = FALSE;  // since we didn't go through the 'update'
 	}
-	else
-	{
-		if (pTask->pThread && pTask->pCond && g_mutex_trylock (pTask->pMutex))  // the thread is sleeping, awake it and let it exit.
-		{
-			g_atomic_int_set (&pTask->bDiscard, 1);
-			pTask->bRunThread = TRUE;
-			g_cond_signal (pTask->pCond);
-			g_mutex_unlock (pTask->pMutex);
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-			g_atomic_int_set (&pTask->bDiscard, 0);
-		}
-	}
 }
 
 
@@ -293,23 +303,18 @@ void gldi_task_discard (GldiTask *pTask)
 		return ;
 	
 	_cancel_next_iteration (pTask);
-	// mark the task as 'discarded'
-	g_atomic_int_set (&pTask->bDiscard, 1);
 	
-	// if the task is running, there is nothing to do:
-	//   if we're inside the thread, it will trigger the 'update' anyway, which will destroy the task.
+	// if the task is running, just mark it as 'discarded':
+	//   if it's in the pool, it will trigger the 'update' anyway, which will destroy the task.
 	//   if we're waiting for the 'update', same as above
 	//   if we're inside the 'update' user callback, the task will be destroyed in the 2nd stage of the function (the user callback is called in the 1st stage).
-	if (! gldi_task_is_running (pTask))  // we can free the task immediately.
+	g_atomic_int_set (&pTask->bDiscard, 1);
+	if (gldi_task_is_running (pTask))
+		return;
+	
+	// else a stale job may still be in a pool or in the update queue, if the task was stopped in the meantime; the main loop will free the task when the last one comes back.
+	if (pTask->iNbJobs == 0)
 	{
-		if (pTask->pThread && pTask->pCond && g_mutex_trylock (pTask->pMutex))  // the thread is sleeping, awake it and let it exit before we can free everything
-		{
-			pTask->bRunThread = TRUE;
-			g_cond_signal (pTask->pCond);
-			g_mutex_unlock (pTask->pMutex);
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-		}
 		_free_task (pTask);
 	}
 }
@@ -320,7 +325,7 @@ void gldi_task_free (GldiTask *pTask)
 		return ;
 	
 	gldi_task_stop (pTask);
-	_free_task (pTask);
+	gldi_task_discard (pTask);  // the task is not running any more, so it's freed now, unless it's still waiting in the pool.
 }
 
 gboolean gldi_task_is_active (GldiTask *pTask)
@@ -339,7 +344,7 @@ static void _restart_timer_with_frequency (GldiTask *pTask, int iNewPeriod)
 	_cancel_next_iteration (pTask);
 	
 	if (bNeedsRestart && iNewPeriod != 0)
-		pTask->iSidTimer = g_timeout_add_seconds (iNewPeriod, (GSourceFunc) _launch_task_timer, pTask);
+		pTask->iSidTimer = gldi_timer_add_seconds (iNewPeriod, (GSourceFunc) _launch_task_timer, pTask);
 }
 
 void gldi_task_change_frequency (GldiTask *pTask, int iNewPeriod)
@@ -393,3 +398,9 @@ void gldi_task_set_normal_frequency (GldiTask *pTask)
 		_restart_timer_with_frequency (pTask, pTask->iPeriod);
 	}
 }
+
+void gldi_task_get_stats (GldiTaskStats *pStats)
+{
+	g_return_if_fail (pStats != NULL);
+	*pStats = s_stats;
+}
@@ -28,10 +28,11 @@ G_BEGIN_DECLS
  *
  *  A Task is divided in 2 phases : 
  * - the asynchronous phase will be executed in another thread, while the dock continues to run on its own thread, in parallel. During this phase you will do all the heavy job (like downloading a file or computing something) but you can't interact on the dock.
+ *   All the Tasks share a bounded pool of worker threads, so a periodic Task doesn't keep a thread for itself between 2 iterations. A Task whose asynchronous phase blocks for a long time (like a download) is moved to a second pool, so that it doesn't delay the other ones.
  * - the synchronous phase will be executed after the first one has finished. There you will update your applet with the result of the first phase.
  * 
  * \attention A data buffer is used to communicate between the 2 phases. It is important that these datas are never accessed outside the task, and vice versa that the asynchronous thread never accesses other data than this buffer.\n
- * If you want to access these datas outside the task, you have to copy them in a safe place during the 2nd phase, or to stop the task before (beware that stopping the task means waiting for the 1st phase to finish, which can take some time).
+ * If you want to access these datas outside the task, you have to copy them in a safe place during the 2nd phase, or to stop the task before (beware that stopping the task means waiting for the 1st phase to finish if it has already started, which can take some time).
  * 
  * You create a Task with \ref gldi_task_new, launch it with \ref gldi_task_launch, and destroy it with \ref gldi_task_free or \ref gldi_task_discard.
  *
@@ -53,9 +54,17 @@ typedef void (* GldiGetDataAsyncFunc ) (gpointer pSharedMemory);
 /// Definition of the synchronous job, that update the dock with the results of the previous job. Returns TRUE to continue, FALSE to stop
 typedef gboolean (* GldiUpdateSyncFunc ) (gpointer pSharedMemory);
 
+/// Counters of the Tasks, to measure how often the main loop is woken up to process their results.
+typedef struct {
+	/// number of 'update' processed after an asynchronous job.
+	guint iNbIterations;
+	/// number of times the main loop was woken up to process them; several Tasks finishing together share a single wakeup.
+	guint iNbWakeups;
+} GldiTaskStats;
+
 /// Definition of a periodic and/or asynchronous Task.
 struct _GldiTask {
-	// ID of the timer of the Task (if periodic)
+	// ID of the timer of the Task (if periodic). It's a timer of cairo-dock-timer.h, not a GSource: it's removed with gldi_timer_remove, not g_source_remove.
 	gint iSidTimer;
 	// TRUE if the thread is running or about to run or if the update is pending
 	gboolean bIsRunning;
@@ -76,16 +85,13 @@ struct _GldiTask {
 	// below are the parameters accessed inside the thread => only between mutex lock/unlock
 	/// structure passed as parameter of the 'get_data' and 'update' functions. Must not be accessed outside of these 2 functions !
 	gpointer pSharedMemory;
-	// ID of the idle source to perform the update.
-	gint iSidUpdateIdle;
 	/// TRUE when the task has been discarded.
 	gboolean bDiscard;
-	gboolean bNeedsUpdate;  // TRUE when new data are waiting to be processed.
+	gint iGeneration;  // incremented each time the task is stopped; a job launched before is stale, it's skipped by the worker and its result is ignored.
 	gboolean bContinue;  // result of the 'update' function (TRUE -> continue, FALSE -> stop, if the task is periodic).
-	GThread *pThread;  // the thread that execute the asynchronous 'get_data' callback
-	GCond *pCond;  // condition to awake the thread (if periodic).
-	gboolean bRunThread;  // condition value: whether to run the thread or exit.
-	GMutex *pMutex;  // mutex associated with the condition.
+	guint iNbJobs;  // number of jobs pushed in a pool and not yet processed by the main loop; the task can only be freed once it's 0.
+	gboolean bSlowJob;  // TRUE if the last 'get_data' has blocked for a long time; the next one goes in the pool of the slow jobs.
+	GMutex *pMutex;  // mutex held by the worker thread during the 'get_data' callback.
 } ;
 
 
@@ -94,7 +100,7 @@ struct _GldiTask {
 */
 void gldi_task_launch (GldiTask *pTask);
 
-/** Same as above but after a delay. If the delay is 0, the task will be launched as soon as the main loop becomes idle.
+/** Same as above but after a delay. If the delay is 0, the task will be launched on the next wakeup of the timers (see cairo-dock-timer.h).
 *@param pTask the periodic Task.
 *@param fDelay delay in ms.
 */
@@ -166,6 +172,11 @@ void gldi_task_downgrade_frequency (GldiTask *pTask);
 */
 void gldi_task_set_normal_frequency (GldiTask *pTask);
 
+/** Get the counters of all the Tasks since the start.
+*@param pStats a structure to fill with the counters.
+*/
+void gldi_task_get_stats (GldiTaskStats *pStats);
+
 /** Get the time elapsed since the last time the Task has run.
 *@param pTask the periodic Task.
 */
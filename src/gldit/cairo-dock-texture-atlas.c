@@ -0,0 +1,333 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <cairo.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-draw-opengl.h"  // cairo_dock_create_texture_from_surface
+#include "cairo-dock-image-buffer.h"
+#include "cairo-dock-texture-atlas.h"
+
+#define CD_ATLAS_SIZE 1024  // size of the textures; any OpenGL implementation supports it.
+#define CD_ATLAS_MAX_PAGES 4  // beyond that, images keep their own texture.
+#define CD_ATLAS_MAX_IMAGE_WIDTH 512  // bigger images are not worth it.
+#define CD_ATLAS_MAX_IMAGE_HEIGHT 128
+#define CD_ATLAS_SHELF_STEP 4  // the height of a shelf is rounded to this, so that images of similar heights share the same shelves.
+
+// each image is surrounded by a transparent border of 1 pixel, so that the linear filtering doesn't take the pixels of its neighbours.
+typedef struct {
+	gint y, h;  // position and height of the shelf
+	gint iNextX;  // position of the free space at the end of the shelf
+	gint iNbSlots;  // number of images on the shelf
+} CairoDockAtlasShelf;
+
+typedef struct {
+	GLuint iTexture;
+	GList *pShelves;  // from top to bottom
+	gint iUsedHeight;  // height taken by the shelves
+	GList *pSlots;  // the images stored in the page
+	gint iUsedArea;  // area taken by the images, with their border
+} CairoDockAtlasPage;
+
+struct _CairoDockAtlasSlot {
+	CairoDockAtlasPage *pPage;
+	CairoDockAtlasShelf *pShelf;
+	CairoDockImageBuffer *pImage;  // image stored in the slot, to copy it again if the slot is moved
+	gint x, y;  // position of the image in the page, without its border
+	gint w, h;  // size of the image, without its border
+};
+
+static GList *s_pAtlasPages = NULL;
+static GHashTable *s_pImageSlots = NULL;  // image buffer -> its slot; it's not stored in the image buffer, because this structure is part of the ABI (it's embedded in the icons, docks, desklets, overlays).
+static CairoDockTextureAtlasStats s_atlasStats;
+
+
+static void _upload_slot (CairoDockAtlasSlot *pSlot)
+{
+	cairo_surface_t *pSurface = pSlot->pImage->pSurface;
+	g_return_if_fail (pSurface != NULL);
+	cairo_surface_flush (pSurface);
+	
+	// copy the image with its transparent border, so that we don't have to clear the texture.
+	int w = pSlot->w + 2, h = pSlot->h + 2;
+	guint32 *pBuffer = g_new0 (guint32, w * h);
+	const guchar *pData = cairo_image_surface_get_data (pSurface);
+	int iStride = cairo_image_surface_get_stride (pSurface);
+	int j;
+	for (j = 0; j < pSlot->h; j ++)
+		memcpy (&pBuffer[(j+1) * w + 1], pData + j * iStride, pSlot->w * sizeof (guint32));
+	
+	glBindTexture (GL_TEXTURE_2D, pSlot->pPage->iTexture);
+	glTexSubImage2D (GL_TEXTURE_2D,
+		0,
+		pSlot->x - 1,
+		pSlot->y - 1,
+		w,
+		h,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		pBuffer);
+	g_free (pBuffer);
+}
+
+static CairoDockAtlasPage *_new_page (void)
+{
+	CairoDockAtlasPage *pPage = g_new0 (CairoDockAtlasPage, 1);
+	glGenTextures (1, &pPage->iTexture);
+	glBindTexture (GL_TEXTURE_2D, pPage->iTexture);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	guint32 *pBuffer = g_new0 (guint32, CD_ATLAS_SIZE * CD_ATLAS_SIZE);  // fully transparent, so that nothing undefined can ever be drawn, even if a texture coordinate slightly overflows the place of an image.
+	glTexImage2D (GL_TEXTURE_2D,
+		0,
+		4,
+		CD_ATLAS_SIZE,
+		CD_ATLAS_SIZE,
+		0,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		pBuffer);
+	g_free (pBuffer);
+	s_pAtlasPages = g_list_append (s_pAtlasPages, pPage);
+	s_atlasStats.iNbPages ++;
+	cd_debug ("new atlas page (%d)", pPage->iTexture);
+	return pPage;
+}
+
+static void _free_page (CairoDockAtlasPage *pPage)
+{
+	cd_debug ("free atlas page (%d)", pPage->iTexture);
+	_cairo_dock_delete_texture (pPage->iTexture);
+	g_list_free_full (pPage->pShelves, g_free);
+	s_pAtlasPages = g_list_remove (s_pAtlasPages, pPage);
+	s_atlasStats.iNbPages --;
+	g_free (pPage);
+}
+
+static gboolean _place_slot_in_page (CairoDockAtlasSlot *pSlot, CairoDockAtlasPage *pPage)
+{
+	int w = pSlot->w + 2, h = pSlot->h + 2;
+	
+	// look for a shelf of a similar height with enough space left.
+	CairoDockAtlasShelf *pShelf = NULL;
+	GList *s;
+	for (s = pPage->pShelves; s != NULL; s = s->next)
+	{
+		CairoDockAtlasShelf *pOneShelf = s->data;
+		if (pOneShelf->h >= h && pOneShelf->h <= h * 3 / 2 + CD_ATLAS_SHELF_STEP && pOneShelf->iNextX + w <= CD_ATLAS_SIZE)
+		{
+			pShelf = pOneShelf;
+			break;
+		}
+	}
+	
+	// otherwise open a new shelf below the others.
+	if (pShelf == NULL)
+	{
+		int iShelfHeight = (h + CD_ATLAS_SHELF_STEP - 1) / CD_ATLAS_SHELF_STEP * CD_ATLAS_SHELF_STEP;
+		if (pPage->iUsedHeight + iShelfHeight > CD_ATLAS_SIZE)
+			return FALSE;
+		pShelf = g_new0 (CairoDockAtlasShelf, 1);
+		pShelf->y = pPage->iUsedHeight;
+		pShelf->h = iShelfHeight;
+		pPage->iUsedHeight += iShelfHeight;
+		pPage->pShelves = g_list_append (pPage->pShelves, pShelf);
+	}
+	
+	pSlot->x = pShelf->iNextX + 1;
+	pSlot->y = pShelf->y + 1;
+	pShelf->iNextX += w;
+	pShelf->iNbSlots ++;
+	pSlot->pShelf = pShelf;
+	pSlot->pPage = pPage;
+	pPage->pSlots = g_list_prepend (pPage->pSlots, pSlot);
+	pPage->iUsedArea += w * h;
+	return TRUE;
+}
+
+static void _free_slot_place (CairoDockAtlasSlot *pSlot)
+{
+	CairoDockAtlasPage *pPage = pSlot->pPage;
+	CairoDockAtlasShelf *pShelf = pSlot->pShelf;
+	int w = pSlot->w + 2, h = pSlot->h + 2;
+	
+	// the space can be reused directly if the image was the last of its shelf, or if the shelf is now empty; otherwise it will be reclaimed by a defragmentation.
+	pShelf->iNbSlots --;
+	if (pShelf->iNbSlots == 0)
+		pShelf->iNextX = 0;
+	else if (pSlot->x - 1 + w == pShelf->iNextX)
+		pShelf->iNextX -= w;
+	
+	// remove the empty shelves at the bottom, so that their height can be used by any image.
+	GList *s;
+	while ((s = g_list_last (pPage->pShelves)) != NULL && ((CairoDockAtlasShelf*)s->data)->iNbSlots == 0)
+	{
+		pShelf = s->data;
+		pPage->iUsedHeight = pShelf->y;
+		pPage->pShelves = g_list_delete_link (pPage->pShelves, s);
+		g_free (pShelf);
+	}
+	
+	pPage->pSlots = g_list_remove (pPage->pSlots, pSlot);
+	pPage->iUsedArea -= w * h;
+	pSlot->pShelf = NULL;
+	pSlot->pPage = NULL;
+}
+
+static void _evict_slot (CairoDockAtlasSlot *pSlot)
+{
+	CairoDockImageBuffer *pImage = pSlot->pImage;
+	cd_debug ("evict an image from the atlas (%dx%d)", pSlot->w, pSlot->h);
+	g_hash_table_remove (s_pImageSlots, pImage);
+	pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
+	g_free (pSlot);
+	s_atlasStats.iNbImages --;
+	s_atlasStats.iNbEvictions ++;
+}
+
+static int _compare_slots_height (const CairoDockAtlasSlot *pSlot1, const CairoDockAtlasSlot *pSlot2)
+{
+	return pSlot2->h - pSlot1->h;
+}
+static void _defragment_page (CairoDockAtlasPage *pPage)
+{
+	cd_debug ("defragment atlas page (%d)", pPage->iTexture);
+	s_atlasStats.iNbDefragmentations ++;
+	
+	// empty the page
+	GList *pSlots = pPage->pSlots;
+	pPage->pSlots = NULL;
+	g_list_free_full (pPage->pShelves, g_free);
+	pPage->pShelves = NULL;
+	pPage->iUsedHeight = 0;
+	pPage->iUsedArea = 0;
+	
+	// and place again all its images, from the highest to the smallest, which packs them tightly.
+	pSlots = g_list_sort (pSlots, (GCompareFunc)_compare_slots_height);
+	GList *s;
+	CairoDockAtlasSlot *pSlot;
+	for (s = pSlots; s != NULL; s = s->next)
+	{
+		pSlot = s->data;
+		if (_place_slot_in_page (pSlot, pPage))
+			_upload_slot (pSlot);
+		else  // doesn't fit anymore (shouldn't happen often), let it have its own texture.
+			_evict_slot (pSlot);
+	}
+	g_list_free (pSlots);
+}
+
+static inline gboolean _page_is_fragmented (CairoDockAtlasPage *pPage, int iArea)
+{
+	// worth defragmenting if at least a quarter of the used space is lost and the image would fit in it.
+	int iLostArea = pPage->iUsedHeight * CD_ATLAS_SIZE - pPage->iUsedArea;
+	return (iLostArea > CD_ATLAS_SIZE * CD_ATLAS_SIZE / 4 && iLostArea > iArea);
+}
+
+CairoDockAtlasSlot *cairo_dock_atlas_add_image (CairoDockImageBuffer *pImage)
+{
+	if (pImage->pSurface == NULL || cairo_surface_get_type (pImage->pSurface) != CAIRO_SURFACE_TYPE_IMAGE)
+		return NULL;
+	int w = cairo_image_surface_get_width (pImage->pSurface);
+	int h = cairo_image_surface_get_height (pImage->pSurface);
+	if (w == 0 || h == 0 || w > CD_ATLAS_MAX_IMAGE_WIDTH || h > CD_ATLAS_MAX_IMAGE_HEIGHT)
+		return NULL;
+	
+	CairoDockAtlasSlot *pSlot = g_new0 (CairoDockAtlasSlot, 1);
+	pSlot->pImage = pImage;
+	pSlot->w = w;
+	pSlot->h = h;
+	
+	// try to place it in the current pages, then in a defragmented page, then in a new page.
+	gboolean bPlaced = FALSE;
+	GList *p;
+	for (p = s_pAtlasPages; p != NULL && ! bPlaced; p = p->next)
+	{
+		bPlaced = _place_slot_in_page (pSlot, p->data);
+	}
+	for (p = s_pAtlasPages; p != NULL && ! bPlaced; p = p->next)
+	{
+		if (_page_is_fragmented (p->data, (w+2) * (h+2)))
+		{
+			_defragment_page (p->data);
+			bPlaced = _place_slot_in_page (pSlot, p->data);
+		}
+	}
+	if (! bPlaced && g_list_length (s_pAtlasPages) < CD_ATLAS_MAX_PAGES)
+	{
+		bPlaced = _place_slot_in_page (pSlot, _new_page ());
+	}
+	if (! bPlaced)
+	{
+		g_free (pSlot);
+		return NULL;
+	}
+	
+	_upload_slot (pSlot);
+	if (s_pImageSlots == NULL)
+		s_pImageSlots = g_hash_table_new (g_direct_hash, g_direct_equal);
+	g_hash_table_insert (s_pImageSlots, pImage, pSlot);
+	s_atlasStats.iNbImages ++;
+	return pSlot;
+}
+
+void cairo_dock_atlas_remove_image (CairoDockAtlasSlot *pSlot)
+{
+	g_return_if_fail (pSlot != NULL);
+	CairoDockAtlasPage *pPage = pSlot->pPage;
+	_free_slot_place (pSlot);
+	g_hash_table_remove (s_pImageSlots, pSlot->pImage);
+	g_free (pSlot);
+	s_atlasStats.iNbImages --;
+	
+	if (pPage->pSlots == NULL)  // no more image in this page, free the texture.
+		_free_page (pPage);
+}
+
+void cairo_dock_atlas_update_image (CairoDockAtlasSlot *pSlot)
+{
+	g_return_if_fail (pSlot != NULL);
+	_upload_slot (pSlot);
+}
+
+CairoDockAtlasSlot *cairo_dock_atlas_get_image_slot (const CairoDockImageBuffer *pImage)
+{
+	if (s_pImageSlots == NULL)
+		return NULL;
+	return g_hash_table_lookup (s_pImageSlots, pImage);
+}
+
+GLuint cairo_dock_atlas_slot_get_texture (const CairoDockAtlasSlot *pSlot)
+{
+	return pSlot->pPage->iTexture;
+}
+
+void cairo_dock_atlas_slot_get_texture_coords (const CairoDockAtlasSlot *pSlot, double *u, double *v, double *du, double *dv)
+{
+	*u = (double) pSlot->x / CD_ATLAS_SIZE;
+	*v = (double) pSlot->y / CD_ATLAS_SIZE;
+	*du = (double) pSlot->w / CD_ATLAS_SIZE;
+	*dv = (double) pSlot->h / CD_ATLAS_SIZE;
+}
+
+void cairo_dock_atlas_get_stats (CairoDockTextureAtlasStats *pStats)
+{
+	*pStats = s_atlasStats;
+}
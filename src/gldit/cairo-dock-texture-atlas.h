@@ -0,0 +1,92 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_TEXTURE_ATLAS__
+#define  __CAIRO_DOCK_TEXTURE_ATLAS__
+
+#include <glib.h>
+#include <GL/gl.h>
+
+#include "cairo-dock-struct.h"
+
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-texture-atlas.h A texture atlas stores many small images into a few big textures, so that they don't need a texture each and can be drawn together without binding another texture.
+* Images are packed on shelves of similar heights; the space of removed images is reused, and a texture is defragmented when it's too fragmented to store a new image. If an image doesn't fit anywhere, it is simply not added, and its owner keeps its own texture.
+* It is used by the Image Buffers (see \ref cairo_dock_load_image_buffer_from_surface_in_atlas), which take care of the texture coordinates when they are drawn; you shouldn't have to use it directly.
+*/
+
+/// Counters of the texture atlas.
+typedef struct {
+	/// number of textures currently used by the atlas.
+	guint iNbPages;
+	/// number of images currently stored in the atlas.
+	guint iNbImages;
+	/// number of times a texture was defragmented.
+	guint iNbDefragmentations;
+	/// number of images that had to be taken out of the atlas, because they didn't fit anymore during a defragmentation.
+	guint iNbEvictions;
+} CairoDockTextureAtlasStats;
+
+/** Add an Image Buffer into the atlas. Its surface is copied into a texture of the atlas, which is the one returned by \ref cairo_dock_atlas_slot_get_texture. The image must not be animated, and must not be moved in memory while it's in the atlas.
+*@param pImage the image, with a surface.
+*@return the place of the image in the atlas, or NULL if it couldn't be added.
+*/
+CairoDockAtlasSlot *cairo_dock_atlas_add_image (CairoDockImageBuffer *pImage);
+
+/** Get the place of an Image Buffer in the atlas.
+*@param pImage the image.
+*@return the place of the image in the atlas, or NULL if it's not in the atlas.
+*/
+CairoDockAtlasSlot *cairo_dock_atlas_get_image_slot (const CairoDockImageBuffer *pImage);
+
+/** Remove an image from the atlas, freeing its place.
+*@param pSlot the place of the image.
+*/
+void cairo_dock_atlas_remove_image (CairoDockAtlasSlot *pSlot);
+
+/** Copy again the surface of an image into the atlas, after it has been modified (its size must not change).
+*@param pSlot the place of the image.
+*/
+void cairo_dock_atlas_update_image (CairoDockAtlasSlot *pSlot);
+
+/** Get the texture that contains an image of the atlas.
+*@param pSlot the place of the image.
+*@return the texture.
+*/
+GLuint cairo_dock_atlas_slot_get_texture (const CairoDockAtlasSlot *pSlot);
+
+/** Get the coordinates of an image inside its texture.
+*@param pSlot the place of the image.
+*@param u horizontal coordinate of the left side, between 0 and 1.
+*@param v vertical coordinate of the top side, between 0 and 1.
+*@param du width, between 0 and 1.
+*@param dv height, between 0 and 1.
+*/
+void cairo_dock_atlas_slot_get_texture_coords (const CairoDockAtlasSlot *pSlot, double *u, double *v, double *du, double *dv);
+
+/** Get the counters of the atlas.
+*@param pStats a structure to fill with the counters.
+*/
+void cairo_dock_atlas_get_stats (CairoDockTextureAtlasStats *pStats);
+
+G_END_DECLS
+#endif
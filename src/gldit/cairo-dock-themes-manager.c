@@ -136,6 +136,7 @@ gboolean cairo_dock_current_theme_need_save (void)
 
 void cairo_dock_delete_conf_file (const gchar *cConfFilePath)
 {
+	cairo_dock_discard_keyfile_updates (cConfFilePath);
 	g_remove (cConfFilePath);
 	cairo_dock_mark_current_theme_as_modified (TRUE);
 }
@@ -169,6 +170,7 @@ void cairo_dock_write_keys_to_conf_file (GKeyFile *pKeyFile, const gchar *cConfF
 gboolean cairo_dock_export_current_theme (const gchar *cNewThemeName, gboolean bSaveBehavior, gboolean bSaveLaunchers)
 {
 	g_return_val_if_fail (cNewThemeName != NULL, FALSE);
+	cairo_dock_flush_all_keyfiles ();  // the conf files are copied as they are.
 
 	gchar *cNewThemeNameWithoutSlashes = _replace_slash_by_underscore (g_strdup (cNewThemeName));
 	
@@ -296,6 +298,7 @@ gboolean cairo_dock_package_current_theme (const gchar *cThemeName, const gchar
 {
 	g_return_val_if_fail (cThemeName != NULL, FALSE);
 	gboolean bSuccess = FALSE;
+	cairo_dock_flush_all_keyfiles ();  // the conf files are copied as they are.
 
 	gchar *cNewThemeName = _escape_string_for_filename (cThemeName);
 	if (cDirPath == NULL || *cDirPath == '\0'
@@ -635,6 +638,7 @@ gboolean cairo_dock_import_theme (const gchar *cThemeName, gboolean bLoadBehavio
 	//\___________________ Get the local path of the theme (if necessary, it is downloaded and/or unzipped).
 	gchar *cNewThemePath = _cairo_dock_get_theme_path (cThemeName);
 	g_return_val_if_fail (cNewThemePath != NULL && g_file_test (cNewThemePath, G_FILE_TEST_EXISTS), FALSE);
+	cairo_dock_flush_all_keyfiles ();  // so that the old values are not written over the new theme.
 	
 	//\___________________ import the theme in the current theme.
 	gboolean bSuccess = _cairo_dock_import_local_theme (cNewThemePath, bLoadBehavior, bLoadLaunchers);
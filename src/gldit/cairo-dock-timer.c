@@ -0,0 +1,345 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include <stdlib.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-timer.h"
+
+// resolution of the wheel, in ms.
+#define GLDI_TIMER_TICK 4
+#define GLDI_TIMER_TICK_US (GLDI_TIMER_TICK * 1000)
+// default slack, in ms; it's small enough to not be noticeable on the delayed actions of the docks (which are >= 50ms).
+#define GLDI_TIMER_DEFAULT_SLACK 40
+
+// the root level has 256 slots of 1 tick; each upper level has 64 slots, each one covering a whole turn of the level below.
+#define WHEEL_ROOT_BITS 8
+#define WHEEL_LEVEL_BITS 6
+#define WHEEL_NB_LEVELS 3
+#define WHEEL_ROOT_SIZE (1 << WHEEL_ROOT_BITS)
+#define WHEEL_LEVEL_SIZE (1 << WHEEL_LEVEL_BITS)
+#define WHEEL_ROOT_MASK (WHEEL_ROOT_SIZE - 1)
+#define WHEEL_LEVEL_MASK (WHEEL_LEVEL_SIZE - 1)
+#define _level_shift(n) (WHEEL_ROOT_BITS + (n) * WHEEL_LEVEL_BITS)
+#define _level_index(iTick, n) (((iTick) >> _level_shift (n)) & WHEEL_LEVEL_MASK)
+// beyond this delay (2^26 ticks, ~3 days), timers are put in the last slot of the wheel and re-inserted when they come back.
+#define WHEEL_MAX_DELTA ((gint64)1 << _level_shift (WHEEL_NB_LEVELS))
+
+typedef struct {
+	guint iTimerID;
+	gint64 iExpire;  // in ticks
+	guint iInterval;  // in ms or in s
+	gboolean bSeconds;
+	GSourceFunc pFunc;
+	gpointer pData;
+	GList **pSlot;  // slot holding the timer, or NULL if the timer is being fired.
+	GList *pLink;  // link of the timer in its slot.
+	gboolean bRemoved;  // TRUE if the timer was removed while being fired; it will be freed once fired.
+} GldiTimer;
+
+static GList *s_pRootSlots[WHEEL_ROOT_SIZE];
+static GList *s_pLevelSlots[WHEEL_NB_LEVELS][WHEEL_LEVEL_SIZE];
+static guint s_iNbRootTimers = 0;
+static gint64 s_iTick = 0;  // next tick to be processed.
+static gint64 s_iOrigin = 0;  // monotonic time of the tick 0, in us.
+static GHashTable *s_hTimers = NULL;  // ID -> timer
+static guint s_iNextTimerID = 1;
+static guint s_iSlack = GLDI_TIMER_DEFAULT_SLACK;
+static GSource *s_pWheelSource = NULL;
+static gint64 s_iReadyTime = -1;  // when the wheel source will wake up, in us.
+static GldiTimerStats s_stats;
+
+static inline gint64 _get_current_tick (void)
+{
+	return (g_get_monotonic_time () - s_iOrigin) / GLDI_TIMER_TICK_US;
+}
+
+static gint64 _get_expire (guint iInterval, gboolean bSeconds)
+{
+	gint64 iExpire = g_get_monotonic_time () - s_iOrigin;  // in us
+	if (bSeconds)  // align on a whole second, so that all the timers in seconds expire together.
+	{
+		iExpire += (gint64)iInterval * 1000000;
+		iExpire = (iExpire + 999999) / 1000000 * 1000000;
+	}
+	else
+	{
+		iExpire += (gint64)iInterval * 1000;
+	}
+	return (iExpire + GLDI_TIMER_TICK_US - 1) / GLDI_TIMER_TICK_US;  // round up, we never fire a timer before it expires.
+}
+
+#define _is_root_slot(pSlot) ((pSlot) >= s_pRootSlots && (pSlot) < s_pRootSlots + WHEEL_ROOT_SIZE)
+
+static void _insert_timer (GldiTimer *pTimer)
+{
+	GList **pSlot;
+	gint64 iDelta = pTimer->iExpire - s_iTick;
+	if (iDelta < WHEEL_ROOT_SIZE)
+	{
+		pSlot = &s_pRootSlots[(iDelta < 0 ? s_iTick : pTimer->iExpire) & WHEEL_ROOT_MASK];  // already expired -> fire it on the next tick.
+		s_iNbRootTimers ++;
+	}
+	else
+	{
+		gint64 iExpire = (iDelta < WHEEL_MAX_DELTA ? pTimer->iExpire : s_iTick + WHEEL_MAX_DELTA - 1);
+		int n;
+		for (n = 0; n < WHEEL_NB_LEVELS - 1; n ++)
+		{
+			if (iDelta < ((gint64)1 << _level_shift (n + 1)))
+				break;
+		}
+		pSlot = &s_pLevelSlots[n][_level_index (iExpire, n)];
+	}
+	*pSlot = g_list_prepend (*pSlot, pTimer);
+	pTimer->pSlot = pSlot;
+	pTimer->pLink = *pSlot;
+}
+
+static void _unlink_timer (GldiTimer *pTimer)
+{
+	if (_is_root_slot (pTimer->pSlot))
+		s_iNbRootTimers --;
+	*pTimer->pSlot = g_list_delete_link (*pTimer->pSlot, pTimer->pLink);
+	pTimer->pSlot = NULL;
+	pTimer->pLink = NULL;
+}
+
+static int _cascade (int n)
+{
+	int iIndex = _level_index (s_iTick, n);
+	GList *pTimers = s_pLevelSlots[n][iIndex];
+	s_pLevelSlots[n][iIndex] = NULL;
+	GList *t;
+	for (t = pTimers; t != NULL; t = t->next)
+		_insert_timer (t->data);  // they now expire within the next turn of the level below.
+	g_list_free (pTimers);
+	return iIndex;
+}
+
+static void _fire_timer (GldiTimer *pTimer)
+{
+	if (! pTimer->bRemoved)
+	{
+		s_stats.iNbFired ++;
+		gboolean bContinue = pTimer->pFunc (pTimer->pData);
+		if (! pTimer->bRemoved)  // the timer may have been removed inside its callback.
+		{
+			if (bContinue)
+			{
+				pTimer->iExpire = _get_expire (pTimer->iInterval, pTimer->bSeconds);
+				_insert_timer (pTimer);
+				return;
+			}
+			g_hash_table_remove (s_hTimers, GUINT_TO_POINTER (pTimer->iTimerID));
+		}
+	}
+	g_free (pTimer);
+}
+
+static void _run_wheel (gint64 iTargetTick)
+{
+	while (s_iTick <= iTargetTick)
+	{
+		int iIndex = s_iTick & WHEEL_ROOT_MASK;
+		if (iIndex == 0 && _cascade (0) == 0 && _cascade (1) == 0)
+			_cascade (2);
+
+		GList *pExpired = s_pRootSlots[iIndex];
+		if (pExpired != NULL)
+		{
+			s_pRootSlots[iIndex] = NULL;
+			GList *t;
+			for (t = pExpired; t != NULL; t = t->next)
+			{
+				GldiTimer *pTimer = t->data;
+				pTimer->pSlot = NULL;
+				pTimer->pLink = NULL;
+				s_iNbRootTimers --;
+			}
+			for (t = pExpired; t != NULL; t = t->next)
+				_fire_timer (t->data);
+			g_list_free (pExpired);
+		}
+
+		if (s_iNbRootTimers == 0)  // nothing more in the root level, jump to its next turn.
+			s_iTick = MIN ((s_iTick | WHEEL_ROOT_MASK) + 1, iTargetTick + 1);
+		else
+			s_iTick ++;
+	}
+}
+
+static gint64 _get_min_expire_in_slot (GList *pSlot)
+{
+	gint64 iExpire = G_MAXINT64;
+	GList *t;
+	for (t = pSlot; t != NULL; t = t->next)
+	{
+		GldiTimer *pTimer = t->data;
+		iExpire = MIN (iExpire, pTimer->iExpire);
+	}
+	return iExpire;
+}
+
+static gint64 _get_next_expire (void)
+{
+	gint64 iExpire = G_MAXINT64;
+	int i, n;
+	// the root level holds the timers of the next 256 ticks, in order.
+	if (s_iNbRootTimers != 0)
+	{
+		for (i = 0; i < WHEEL_ROOT_SIZE; i ++)
+		{
+			GList *pSlot = s_pRootSlots[(s_iTick + i) & WHEEL_ROOT_MASK];
+			if (pSlot != NULL)
+			{
+				iExpire = _get_min_expire_in_slot (pSlot);
+				break;
+			}
+		}
+	}
+	// the slots of the upper levels are in order too, starting after the one cascaded at the beginning of the current turn.
+	for (n = 0; n < WHEEL_NB_LEVELS; n ++)
+	{
+		int iIndex = _level_index (s_iTick, n);
+		for (i = 1; i <= WHEEL_LEVEL_SIZE; i ++)
+		{
+			GList *pSlot = s_pLevelSlots[n][(iIndex + i) & WHEEL_LEVEL_MASK];
+			if (pSlot != NULL)
+			{
+				iExpire = MIN (iExpire, _get_min_expire_in_slot (pSlot));
+				break;
+			}
+		}
+	}
+	return iExpire;
+}
+
+static void _set_ready_time (gint64 iReadyTime)
+{
+	s_iReadyTime = iReadyTime;
+	g_source_set_ready_time (s_pWheelSource, iReadyTime);
+}
+
+static void _update_wakeup (void)
+{
+	gint64 iExpire = _get_next_expire ();
+	if (iExpire == G_MAXINT64)  // no more timer, sleep until a new one is added.
+		_set_ready_time (-1);
+	else  // wake up a bit after the first timer expires, to fire all the timers expiring in the meantime at once.
+		_set_ready_time (s_iOrigin + iExpire * GLDI_TIMER_TICK_US + (gint64)s_iSlack * 1000);
+}
+
+static gboolean _wheel_dispatch (G_GNUC_UNUSED GSource *pSource, G_GNUC_UNUSED GSourceFunc callback, G_GNUC_UNUSED gpointer data)
+{
+	s_stats.iNbWakeups ++;
+	_run_wheel (_get_current_tick ());
+	_update_wakeup ();
+	return G_SOURCE_CONTINUE;
+}
+static GSourceFuncs s_wheelSourceFuncs = {
+	NULL,  // the source only relies on its ready time.
+	NULL,
+	_wheel_dispatch,
+	NULL, NULL, NULL
+};
+
+static void _init_wheel (void)
+{
+	s_iOrigin = g_get_monotonic_time ();
+	s_hTimers = g_hash_table_new (g_direct_hash, g_direct_equal);
+	s_pWheelSource = g_source_new (&s_wheelSourceFuncs, sizeof (GSource));
+	g_source_set_ready_time (s_pWheelSource, -1);
+	g_source_attach (s_pWheelSource, NULL);  // the main loop runs the default context.
+}
+
+static guint _add_timer (guint iInterval, gboolean bSeconds, GSourceFunc pFunc, gpointer pData)
+{
+	g_return_val_if_fail (pFunc != NULL, 0);
+	if (s_pWheelSource == NULL)
+		_init_wheel ();
+
+	GldiTimer *pTimer = g_new0 (GldiTimer, 1);
+	pTimer->iTimerID = s_iNextTimerID ++;
+	if (s_iNextTimerID == 0)  // 0 is never a valid ID.
+		s_iNextTimerID = 1;
+	pTimer->iInterval = iInterval;
+	pTimer->bSeconds = bSeconds;
+	pTimer->pFunc = pFunc;
+	pTimer->pData = pData;
+	pTimer->iExpire = _get_expire (iInterval, bSeconds);
+	_insert_timer (pTimer);
+	g_hash_table_insert (s_hTimers, GUINT_TO_POINTER (pTimer->iTimerID), pTimer);
+
+	// wake up earlier if needed; if we're inside the dispatch, the wakeup will be updated at the end anyway.
+	gint64 iReadyTime = s_iOrigin + pTimer->iExpire * GLDI_TIMER_TICK_US + (gint64)s_iSlack * 1000;
+	if (s_iReadyTime < 0 || iReadyTime < s_iReadyTime)
+		_set_ready_time (iReadyTime);
+	return pTimer->iTimerID;
+}
+
+guint gldi_timer_add (guint iInterval, GSourceFunc pFunc, gpointer pData)
+{
+	return _add_timer (iInterval, FALSE, pFunc, pData);
+}
+
+guint gldi_timer_add_seconds (guint iInterval, GSourceFunc pFunc, gpointer pData)
+{
+	return _add_timer (iInterval, TRUE, pFunc, pData);
+}
+
+gboolean gldi_timer_remove (guint iTimerID)
+{
+	if (s_hTimers == NULL || iTimerID == 0)
+		return FALSE;
+	GldiTimer *pTimer = g_hash_table_lookup (s_hTimers, GUINT_TO_POINTER (iTimerID));
+	if (pTimer == NULL)
+	{
+		cd_warning ("no timer with ID %u", iTimerID);
+		return FALSE;
+	}
+	g_hash_table_remove (s_hTimers, GUINT_TO_POINTER (iTimerID));
+
+	if (pTimer->pSlot != NULL)
+	{
+		_unlink_timer (pTimer);
+		g_free (pTimer);
+	}
+	else  // it's being fired (or is about to be), it will be freed once done.
+	{
+		pTimer->bRemoved = TRUE;
+	}
+	// we don't update the wakeup here: at worst we'll wake up for nothing once.
+	return TRUE;
+}
+
+void gldi_timer_set_slack (guint iSlack)
+{
+	s_iSlack = iSlack;
+	if (s_pWheelSource != NULL)
+		_update_wakeup ();
+}
+
+void gldi_timer_get_stats (GldiTimerStats *pStats)
+{
+	g_return_if_fail (pStats != NULL);
+	*pStats = s_stats;
+	pStats->fElapsedTime = (s_pWheelSource != NULL ? (g_get_monotonic_time () - s_iOrigin) * 1e-6 : 0.);
+	pStats->fWakeupsPerMinute = (pStats->fElapsedTime > 0 ? 60. * pStats->iNbWakeups / pStats->fElapsedTime : 0.);
+}
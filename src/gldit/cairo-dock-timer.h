@@ -0,0 +1,80 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __CAIRO_DOCK_TIMER__
+#define  __CAIRO_DOCK_TIMER__
+
+#include "cairo-dock-struct.h"
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-timer.h Coalesced timers, to replace the many g_timeout_add used for periodic Tasks and delayed actions.
+ *
+ * All the timers are stored in a single hierarchical timer wheel, driven by a single source of the main loop. When the earliest timer expires, the main loop is woken up a little later (up to the slack, see \ref gldi_timer_set_slack), and all the timers expired by then are fired together, in a single wakeup.
+ * Timers in seconds are aligned on a whole second, so that they are all fired together.
+ *
+ * Timers are used like the GLib ones: the callback returns TRUE to be called again after the same interval, or FALSE to stop. The IDs are not GSource IDs, so they must be removed with \ref gldi_timer_remove and not with g_source_remove.
+ */
+
+/// Counters of the timers, to measure how often the main loop is woken up by them.
+typedef struct {
+	/// number of times the main loop was woken up to fire some timers.
+	guint iNbWakeups;
+	/// number of timers fired.
+	guint iNbFired;
+	/// time elapsed since the first timer was added, in s.
+	double fElapsedTime;
+	/// average number of wakeups per minute.
+	double fWakeupsPerMinute;
+} GldiTimerStats;
+
+/** Add a timer, that will be called after a given interval, until it returns FALSE.
+*@param iInterval the interval in ms.
+*@param pFunc the function to call.
+*@param pData data passed to the function.
+*@return the ID of the timer, > 0.
+*/
+guint gldi_timer_add (guint iInterval, GSourceFunc pFunc, gpointer pData);
+
+/** Same as above, but with an interval in seconds. The timer is aligned on a whole second, like with g_timeout_add_seconds.
+*@param iInterval the interval in s.
+*@param pFunc the function to call.
+*@param pData data passed to the function.
+*@return the ID of the timer, > 0.
+*/
+guint gldi_timer_add_seconds (guint iInterval, GSourceFunc pFunc, gpointer pData);
+
+/** Remove a timer. It can be called from inside the timer's callback.
+*@param iTimerID the ID of the timer.
+*@return TRUE if the timer has been found and removed.
+*/
+gboolean gldi_timer_remove (guint iTimerID);
+
+/** Set the slack of the timers, that is to say how late a timer may be fired to be fired with other timers in a single wakeup.
+*@param iSlack the slack in ms, 0 to fire each timer as soon as it expires.
+*/
+void gldi_timer_set_slack (guint iSlack);
+
+/** Get the counters of the timers since the first timer was added.
+*@param pStats a structure to fill with the counters.
+*/
+void gldi_timer_get_stats (GldiTimerStats *pStats);
+
+G_END_DECLS
+#endif
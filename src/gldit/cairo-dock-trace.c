@@ -0,0 +1,230 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <string.h>
+#include <unistd.h>  // getpid
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-trace.h"
+
+// beyond this number of events (~40MB), new events are dropped; the startup only produces a few thousands of them.
+#define GLDI_TRACE_MAX_EVENTS (1 << 20)
+
+typedef struct {
+	const gchar *cName;  // interned
+	const gchar *cCategory;  // interned
+	gint64 iTime;  // in us, since the start of the tracer
+	gint64 iValue;  // total of the counter
+	gchar *cArg;
+	guint iThread;
+	gchar iPhase;
+} GldiTraceEvent;
+
+gboolean g_bTraceEnabled = FALSE;
+
+static GMutex s_traceMutex;
+static GArray *s_pEvents = NULL;
+static GHashTable *s_hThreads = NULL;  // GThread -> thread number
+static GHashTable *s_hCounters = NULL;  // interned name -> total
+static gchar *s_cTraceFile = NULL;
+static gint64 s_iOrigin = 0;
+static guint s_iNbDropped = 0;
+
+void gldi_trace_start (const gchar *cFilePath)
+{
+	g_return_if_fail (cFilePath != NULL);
+	if (g_bTraceEnabled)
+		return;
+	g_mutex_lock (&s_traceMutex);
+	s_cTraceFile = g_strdup (cFilePath);
+	s_pEvents = g_array_sized_new (FALSE, FALSE, sizeof (GldiTraceEvent), 4096);
+	s_hThreads = g_hash_table_new (g_direct_hash, g_direct_equal);
+	s_hCounters = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+	s_iOrigin = g_get_monotonic_time ();
+	s_iNbDropped = 0;
+	g_mutex_unlock (&s_traceMutex);
+
+	g_bTraceEnabled = TRUE;
+	cd_message ("tracing into '%s'", cFilePath);
+}
+
+void gldi_trace_add_event (const gchar *cName, const gchar *cCategory, gchar iPhase, gint64 iValue, const gchar *cArg)
+{
+	gint64 iTime = g_get_monotonic_time ();
+	g_mutex_lock (&s_traceMutex);
+	if (s_pEvents == NULL)  // the tracer has been stopped in the meantime.
+	{
+		g_mutex_unlock (&s_traceMutex);
+		return;
+	}
+	if (s_pEvents->len >= GLDI_TRACE_MAX_EVENTS)
+	{
+		s_iNbDropped ++;
+		g_mutex_unlock (&s_traceMutex);
+		return;
+	}
+
+	GldiTraceEvent event;
+	event.cName = g_intern_string (cName);
+	event.cCategory = g_intern_string (cCategory);
+	event.iTime = iTime - s_iOrigin;
+	event.iPhase = iPhase;
+	event.cArg = g_strdup (cArg);
+
+	// number the threads in the order they appear, it's easier to read than their address.
+	GThread *pThread = g_thread_self ();
+	event.iThread = GPOINTER_TO_UINT (g_hash_table_lookup (s_hThreads, pThread));
+	if (event.iThread == 0)
+	{
+		event.iThread = g_hash_table_size (s_hThreads) + 1;
+		g_hash_table_insert (s_hThreads, pThread, GUINT_TO_POINTER (event.iThread));
+	}
+
+	// counters are shown with their total.
+	if (iPhase == 'C')
+	{
+		gint64 *pTotal = g_hash_table_lookup (s_hCounters, event.cName);
+		if (pTotal == NULL)
+		{
+			pTotal = g_new0 (gint64, 1);
+			g_hash_table_insert (s_hCounters, (gpointer)event.cName, pTotal);
+		}
+		*pTotal += iValue;
+		event.iValue = *pTotal;
+	}
+	else
+		event.iValue = 0;
+
+	g_array_append_val (s_pEvents, event);
+	g_mutex_unlock (&s_traceMutex);
+}
+
+
+  ////////////
+ /// JSON ///
+////////////
+
+static void _append_json_string (GString *pString, const gchar *str)
+{
+	g_string_append_c (pString, '"');
+	const guchar *c;
+	for (c = (const guchar *)(str ? str : ""); *c != '\0'; c ++)
+	{
+		switch (*c)
+		{
+			case '"': g_string_append (pString, "\\\""); break;
+			case '\\': g_string_append (pString, "\\\\"); break;
+			case '\n': g_string_append (pString, "\\n"); break;
+			case '\t': g_string_append (pString, "\\t"); break;
+			default:
+				if (*c < 0x20)
+					g_string_append_printf (pString, "\\u%04x", *c);
+				else  // UTF-8 is valid in JSON.
+					g_string_append_c (pString, *c);
+		}
+	}
+	g_string_append_c (pString, '"');
+}
+
+gboolean gldi_trace_write (void)
+{
+	if (! g_bTraceEnabled)
+		return FALSE;
+	int iPid = getpid ();
+	GString *pString = g_string_sized_new (4096);
+
+	g_mutex_lock (&s_traceMutex);
+	g_string_append (pString, "{\"traceEvents\":[\n");
+	g_string_append_printf (pString, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":1,\"args\":{\"name\":", iPid);
+	_append_json_string (pString, g_get_prgname () ? g_get_prgname () : "cairo-dock");
+	g_string_append (pString, "}}");
+
+	GldiTraceEvent *e;
+	guint i;
+	for (i = 0; i < s_pEvents->len; i ++)
+	{
+		e = &g_array_index (s_pEvents, GldiTraceEvent, i);
+		g_string_append (pString, ",\n{\"name\":");
+		_append_json_string (pString, e->cName);
+		g_string_append (pString, ",\"cat\":");
+		_append_json_string (pString, e->cCategory);
+		g_string_append_printf (pString, ",\"ph\":\"%c\",\"ts\":%" G_GINT64_FORMAT ",\"pid\":%d,\"tid\":%u", e->iPhase, e->iTime, iPid, e->iThread);
+		if (e->iPhase == 'C')
+		{
+			g_string_append_printf (pString, ",\"args\":{\"value\":%" G_GINT64_FORMAT "}", e->iValue);
+		}
+		else if (e->cArg != NULL)
+		{
+			g_string_append (pString, ",\"args\":{\"arg\":");
+			_append_json_string (pString, e->cArg);
+			g_string_append_c (pString, '}');
+		}
+		g_string_append_c (pString, '}');
+	}
+	g_string_append (pString, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	guint iNbEvents = s_pEvents->len, iNbDropped = s_iNbDropped;
+	gchar *cTraceFile = g_strdup (s_cTraceFile);
+	g_mutex_unlock (&s_traceMutex);
+
+	GError *erreur = NULL;
+	g_file_set_contents (cTraceFile, pString->str, pString->len, &erreur);
+	g_string_free (pString, TRUE);
+	gboolean bWritten = (erreur == NULL);
+	if (erreur != NULL)
+	{
+		cd_warning ("couldn't write the trace into '%s': %s", cTraceFile, erreur->message);
+		g_error_free (erreur);
+	}
+	else
+		cd_message ("%u events written into '%s' (%u dropped)", iNbEvents, cTraceFile, iNbDropped);
+	g_free (cTraceFile);
+	return bWritten;
+}
+
+void gldi_trace_stop (void)
+{
+	if (! g_bTraceEnabled)
+		return;
+	gldi_trace_write ();
+
+	g_bTraceEnabled = FALSE;
+	g_mutex_lock (&s_traceMutex);
+	guint i;
+	for (i = 0; i < s_pEvents->len; i ++)
+		g_free (g_array_index (s_pEvents, GldiTraceEvent, i).cArg);
+	g_array_free (s_pEvents, TRUE);
+	s_pEvents = NULL;
+	g_hash_table_destroy (s_hThreads);
+	s_hThreads = NULL;
+	g_hash_table_destroy (s_hCounters);
+	s_hCounters = NULL;
+	g_free (s_cTraceFile);
+	s_cTraceFile = NULL;
+	g_mutex_unlock (&s_traceMutex);
+}
+
+void gldi_trace_get_stats (GldiTraceStats *pStats)
+{
+	memset (pStats, 0, sizeof (GldiTraceStats));
+	pStats->bEnabled = g_bTraceEnabled;
+	g_mutex_lock (&s_traceMutex);
+	if (s_pEvents != NULL)
+		pStats->iNbEvents = s_pEvents->len;
+	pStats->iNbDropped = s_iNbDropped;
+	g_mutex_unlock (&s_traceMutex);
+}
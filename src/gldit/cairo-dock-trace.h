@@ -0,0 +1,103 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __CAIRO_DOCK_TRACE__
+#define  __CAIRO_DOCK_TRACE__
+
+#include <glib.h>
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-trace.h A lightweight tracer, to see where the time goes during the startup.
+ *
+ * The code is instrumented with spans (a begin and an end, that can be nested) and counters. They cost a single test of a global flag until the tracer is started, so they are always compiled in.
+ * The tracer is started with \ref gldi_trace_start, or by setting the GLDI_TRACE environment variable to the path of the file to write (it is checked by \ref gldi_init); the events are then recorded in memory, and written in the Chrome trace-event JSON format by \ref gldi_trace_write, so that they can be loaded in chrome://tracing or Perfetto.
+ * cairo-dock only traces its startup: it writes the file and stops the tracer with \ref gldi_trace_stop once it's idle after loading the theme, or when it quits if that happens first. The file is not written again at the end. Other programs using libgldi call \ref gldi_trace_write and \ref gldi_trace_stop themselves.
+ *
+ * The names and categories are interned, so they don't need to be static strings. A span must be ended in the same thread as it was begun.
+ */
+
+/// Counters of the tracer.
+typedef struct {
+	/// TRUE if the tracer is started.
+	gboolean bEnabled;
+	/// number of events recorded.
+	guint iNbEvents;
+	/// number of events dropped because the maximum number of events was reached.
+	guint iNbDropped;
+} GldiTraceStats;
+
+/// TRUE if the tracer is started; don't modify it directly.
+extern gboolean g_bTraceEnabled;
+
+/** Begin a span in the current thread.
+*@param cName name of the span.
+*@param cCategory category of the span (for instance "manager", "module", "image").
+*/
+#define gldi_trace_begin(cName, cCategory) (G_UNLIKELY (g_bTraceEnabled) ? gldi_trace_add_event (cName, cCategory, 'B', 0, NULL) : (void)0)
+
+/** Same as above, with an argument that will be shown with the span (for instance the file being loaded).
+*@param cName name of the span.
+*@param cCategory category of the span.
+*@param cArg the argument, copied.
+*/
+#define gldi_trace_begin_with_arg(cName, cCategory, cArg) (G_UNLIKELY (g_bTraceEnabled) ? gldi_trace_add_event (cName, cCategory, 'B', 0, cArg) : (void)0)
+
+/** End the last span begun in the current thread.
+*@param cName name of the span.
+*@param cCategory category of the span.
+*/
+#define gldi_trace_end(cName, cCategory) (G_UNLIKELY (g_bTraceEnabled) ? gldi_trace_add_event (cName, cCategory, 'E', 0, NULL) : (void)0)
+
+/** Add a value to a counter. The counter starts at 0 when the tracer is started.
+*@param cName name of the counter.
+*@param iDelta value to add.
+*/
+#define gldi_trace_count(cName, iDelta) (G_UNLIKELY (g_bTraceEnabled) ? gldi_trace_add_event (cName, "counter", 'C', iDelta, NULL) : (void)0)
+
+/** Start the tracer. Nothing is done if it's already started.
+*@param cFilePath path of the file where the events will be written.
+*/
+void gldi_trace_start (const gchar *cFilePath);
+
+/** Record an event. Use the macros above instead, they don't call it if the tracer is not started.
+*@param cName name of the event.
+*@param cCategory category of the event.
+*@param iPhase 'B' to begin a span, 'E' to end it, 'C' to add a value to a counter.
+*@param iValue the value to add, for a counter.
+*@param cArg an argument of the event, or NULL.
+*/
+void gldi_trace_add_event (const gchar *cName, const gchar *cCategory, gchar iPhase, gint64 iValue, const gchar *cArg);
+
+/** Write all the events recorded so far into the file given to \ref gldi_trace_start. The events are kept, so the file can be written again later with the new events.
+*@return TRUE if the file has been written.
+*/
+gboolean gldi_trace_write (void);
+
+/** Write the events, then stop the tracer and free them.
+*/
+void gldi_trace_stop (void);
+
+/** Get the counters of the tracer.
+*@param pStats a structure to fill with the counters.
+*/
+void gldi_trace_get_stats (GldiTraceStats *pStats);
+
+G_END_DECLS
+#endif
@@ -28,6 +28,7 @@
 #include "cairo-dock-launcher-manager.h"
 #include "cairo-dock-stack-icon-manager.h"
 #include "cairo-dock-separator-manager.h"
+#include "cairo-dock-icon-manager.h"  // cairo_dock_preload_icon_s_path
 #define _MANAGER_DEF_
 #include "cairo-dock-user-icon-manager.h"
 
@@ -111,40 +112,60 @@ Icon *gldi_user_icon_new (const gchar *cConfFile)
 }
 
 
+static void _preload_icon_path (GKeyFile *pKeyFile, G_GNUC_UNUSED const gchar *cConfFilePath)  // in a worker.
+{
+	gchar *cIcon = g_key_file_get_string (pKeyFile, "Desktop Entry", "Icon", NULL);
+	if (cIcon != NULL && *cIcon != '\0')
+		cairo_dock_preload_icon_s_path (cIcon);
+	g_free (cIcon);
+}
+
 void gldi_user_icons_new_from_directory (const gchar *cDirectory)
 {
 	cd_message ("%s (%s)", __func__, cDirectory);
 	GDir *dir = g_dir_open (cDirectory, 0, NULL);
 	g_return_if_fail (dir != NULL);
 	
-	Icon* icon;
+	//\__________________ parse all the .desktop files in parallel, and look for their icons.
+	GPtrArray *pFiles = g_ptr_array_new_with_free_func (g_free);  // paths, then file names
 	const gchar *cFileName;
-	CairoDock *pParentDock;
-
 	while ((cFileName = g_dir_read_name (dir)) != NULL)
 	{
 		if (g_str_has_suffix (cFileName, ".desktop"))
+			g_ptr_array_add (pFiles, g_strdup_printf ("%s/%s", cDirectory, cFileName));
+	}
+	g_dir_close (dir);
+	g_ptr_array_add (pFiles, NULL);
+	cairo_dock_preload_key_files ((gchar**)pFiles->pdata, _preload_icon_path);
+	g_ptr_array_remove_index (pFiles, pFiles->len - 1);
+	
+	//\__________________ create the icons and insert them in their dock.
+	Icon* icon;
+	CairoDock *pParentDock;
+	guint i;
+	for (i = 0; i < pFiles->len; i ++)
+	{
+		cFileName = strrchr (g_ptr_array_index (pFiles, i), '/') + 1;
+		icon = gldi_user_icon_new (cFileName);
+		if (icon == NULL || icon->cDesktopFileName == NULL)  // if the icon couldn't be loaded, remove it from the theme (it's useless to try and fail to load it each time).
 		{
-			icon = gldi_user_icon_new (cFileName);
-			if (icon == NULL || icon->cDesktopFileName == NULL)  // if the icon couldn't be loaded, remove it from the theme (it's useless to try and fail to load it each time).
-			{
-				if (icon)
-					gldi_object_unref (GLDI_OBJECT(icon));
-				cd_warning ("Unable to load a valid icon from '%s/%s'; the file is either unreadable, unvalid or does not correspond to any installed program, and will be deleted", g_cCurrentLaunchersPath, cFileName);
-				gchar *cDesktopFilePath = g_strdup_printf ("%s/%s", g_cCurrentLaunchersPath, cFileName);
-				cairo_dock_delete_conf_file (cDesktopFilePath);
-				g_free (cDesktopFilePath);
-				continue;
-			}
-			
-			pParentDock = gldi_dock_get (icon->cParentDockName);
-			if (pParentDock != NULL)  // a priori toujours vrai.
-			{
-				gldi_icon_insert_in_container (icon, CAIRO_CONTAINER(pParentDock), ! CAIRO_DOCK_ANIMATE_ICON);
-			}
+			if (icon)
+				gldi_object_unref (GLDI_OBJECT(icon));
+			cd_warning ("Unable to load a valid icon from '%s/%s'; the file is either unreadable, unvalid or does not correspond to any installed program, and will be deleted", g_cCurrentLaunchersPath, cFileName);
+			gchar *cDesktopFilePath = g_strdup_printf ("%s/%s", g_cCurrentLaunchersPath, cFileName);
+			cairo_dock_delete_conf_file (cDesktopFilePath);
+			g_free (cDesktopFilePath);
+			continue;
+		}
+		
+		pParentDock = gldi_dock_get (icon->cParentDockName);
+		if (pParentDock != NULL)  // a priori toujours vrai.
+		{
+			gldi_icon_insert_in_container (icon, CAIRO_CONTAINER(pParentDock), ! CAIRO_DOCK_ANIMATE_ICON);
 		}
 	}
-	g_dir_close (dir);
+	cairo_dock_clear_preloaded_key_files ();
+	g_ptr_array_free (pFiles, TRUE);
 }
 
 
@@ -283,61 +283,101 @@ gboolean cairo_dock_launch_command_printf (const gchar *cCommandFormat, const gc
 	return r;
 }
 
-static gpointer _cairo_dock_launch_threaded (gchar *cCommand)
+static CairoDockLaunchStats s_launchStats;
+
+typedef struct {
+	GChildWatchFunc pCallback;
+	gpointer data;
+} CDChildWatch;
+
+static gboolean _command_needs_shell (const gchar *cCommand)
 {
-	int r;
-	r = system (cCommand);
-	if (r != 0)
-		cd_warning ("couldn't launch this command (%s)", cCommand);
-	g_free (cCommand);
-	return NULL;
+	// quotes and backslashes are handled by g_shell_parse_argv, but redirections, pipes, variables, etc need a shell.
+	if (strpbrk (cCommand, "|&;<>()$`*?[]{}~#\n") != NULL)
+		return TRUE;
+	// so does an environment variable before the program ("VAR=value program").
+	const gchar *cEqual = strchr (cCommand, '=');
+	return (cEqual != NULL && cEqual < cCommand + strcspn (cCommand, " \t\"'"));
 }
-gboolean cairo_dock_launch_command_full (const gchar *cCommand, const gchar *cWorkingDirectory)
+
+static void _on_child_exit (GPid pid, gint iStatus, CDChildWatch *pWatch)
+{
+	if (pWatch->pCallback)
+		pWatch->pCallback (pid, iStatus, pWatch->data);
+	g_spawn_close_pid (pid);
+	g_free (pWatch);
+}
+
+gboolean cairo_dock_launch_command_full_with_callback (const gchar *cCommand, const gchar *cWorkingDirectory, GChildWatchFunc pCallback, gpointer data)
 {
 	g_return_val_if_fail (cCommand != NULL, FALSE);
 	cd_debug ("%s (%s , %s)", __func__, cCommand, cWorkingDirectory);
+	gint64 t0 = g_get_monotonic_time ();
 	
-	gchar *cBGCommand = NULL;
-	if (cCommand[strlen (cCommand)-1] != '&')
-		cBGCommand = g_strconcat (cCommand, " &", NULL);
-	
-	gchar *cCommandFull = NULL;
-	if (cWorkingDirectory != NULL)
+	// get the arguments of the command; the shell is only used if the command needs it.
+	gchar **argv = NULL;
+	GError *erreur = NULL;
+	gsize n = strlen (cCommand);
+	while (n > 0 && (cCommand[n-1] == '&' || cCommand[n-1] == ' '))  // the command is always launched in the background.
+		n --;
+	gchar *cCommandFg = g_strndup (cCommand, n);
+	if (_command_needs_shell (cCommandFg))
 	{
-		cCommandFull = g_strdup_printf ("cd \"%s\" && %s", cWorkingDirectory, cBGCommand ? cBGCommand : cCommand);
-		g_free (cBGCommand);
-		cBGCommand = NULL;
+		argv = g_new0 (gchar*, 4);
+		argv[0] = g_strdup ("/bin/sh");
+		argv[1] = g_strdup ("-c");
+		argv[2] = cCommandFg;
+		cCommandFg = NULL;
+		s_launchStats.iNbShellLaunches ++;
 	}
-	else if (cBGCommand != NULL)
+	else if (! g_shell_parse_argv (cCommandFg, NULL, &argv, &erreur))
 	{
-		cCommandFull = cBGCommand;
-		cBGCommand = NULL;
+		cd_warning ("couldn't launch this command (%s : %s)", cCommand, erreur->message);
+		g_error_free (erreur);
+		g_free (cCommandFg);
+		s_launchStats.iNbFailures ++;
+		return FALSE;
 	}
+	g_free (cCommandFg);
 	
-	if (cCommandFull == NULL)
-		cCommandFull = g_strdup (cCommand);
-
-	GError *erreur = NULL;
-	#if (GLIB_MAJOR_VERSION == 2 && GLIB_MINOR_VERSION < 32)
-	GThread* pThread = g_thread_create ((GThreadFunc) _cairo_dock_launch_threaded, cCommandFull, FALSE, &erreur);
-	#else
-	// The name can be useful for discriminating threads in a debugger.
-	// Some systems restrict the length of name to 16 bytes. 
-	gchar *cThreadName = g_strndup (cCommand, 15);
-	GThread* pThread = g_thread_try_new (cThreadName, (GThreadFunc) _cairo_dock_launch_threaded, cCommandFull, &erreur);
-	g_thread_unref (pThread);
-	g_free (cThreadName);
-	#endif
-	if (erreur != NULL)
+	// spawn the process directly (GLib uses posix_spawn or vfork, and changes the directory in the child); it is reaped by a child watch, that also tells when it's finished.
+	GPid pid;
+	gboolean r = g_spawn_async (cWorkingDirectory,
+		argv,
+		NULL,  // inherit the environment
+		G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD,
+		NULL, NULL,
+		&pid,
+		&erreur);
+	g_strfreev (argv);
+	if (! r)
 	{
-		cd_warning ("couldn't launch this command (%s : %s)", cCommandFull, erreur->message);
+		cd_warning ("couldn't launch this command (%s : %s)", cCommand, erreur->message);
 		g_error_free (erreur);
-		g_free (cCommandFull);
+		s_launchStats.iNbFailures ++;
 		return FALSE;
 	}
+	CDChildWatch *pWatch = g_new0 (CDChildWatch, 1);
+	pWatch->pCallback = pCallback;
+	pWatch->data = data;
+	g_child_watch_add (pid, (GChildWatchFunc) _on_child_exit, pWatch);
+	
+	s_launchStats.iNbLaunches ++;
+	s_launchStats.fLastLaunchTime = (double)(g_get_monotonic_time () - t0) / 1e3;
+	s_launchStats.fTotalLaunchTime += s_launchStats.fLastLaunchTime;
 	return TRUE;
 }
 
+gboolean cairo_dock_launch_command_full (const gchar *cCommand, const gchar *cWorkingDirectory)
+{
+	return cairo_dock_launch_command_full_with_callback (cCommand, cWorkingDirectory, NULL, NULL);
+}
+
+void cairo_dock_get_launch_stats (CairoDockLaunchStats *pStats)
+{
+	*pStats = s_launchStats;
+}
+
 const gchar * cairo_dock_get_default_terminal (void)
 {
 	const gchar *cTerm = g_getenv ("COLORTERM");
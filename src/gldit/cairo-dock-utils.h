@@ -63,9 +63,37 @@ gchar *cairo_dock_launch_command_sync_with_stderr (const gchar *cCommand, gboole
 #define cairo_dock_launch_command_sync(cCommand) cairo_dock_launch_command_sync_with_stderr (cCommand, TRUE)
 
 gboolean cairo_dock_launch_command_printf (const gchar *cCommandFormat, const gchar *cWorkingDirectory, ...) G_GNUC_PRINTF (1, 3);
+
+/// Counters of the commands launched.
+typedef struct {
+	/// number of commands launched.
+	guint iNbLaunches;
+	/// number of commands that needed a shell.
+	guint iNbShellLaunches;
+	/// number of commands that couldn't be launched.
+	guint iNbFailures;
+	/// time taken to launch the last command, in ms.
+	double fLastLaunchTime;
+	/// time taken to launch all the commands, in ms.
+	double fTotalLaunchTime;
+} CairoDockLaunchStats;
+
+/** Launch a command in the background. The command is split into arguments and the program is spawned directly; a shell is only used if the command needs one (pipes, redirections, variables, etc). The process is reaped when it terminates.
+*@param cCommand the command, for instance from the Exec line of a .desktop file.
+*@param cWorkingDirectory the directory where to launch it, or NULL for the current one.
+*@param pCallback function called when the process terminates, with its exit status, or NULL.
+*@param data data passed to the callback.
+*@return TRUE if the command has been launched; if not, the callback will not be called.
+*/
+gboolean cairo_dock_launch_command_full_with_callback (const gchar *cCommand, const gchar *cWorkingDirectory, GChildWatchFunc pCallback, gpointer data);
 gboolean cairo_dock_launch_command_full (const gchar *cCommand, const gchar *cWorkingDirectory);
 #define cairo_dock_launch_command(cCommand) cairo_dock_launch_command_full (cCommand, NULL)
 
+/** Get the counters of the commands launched.
+*@param pStats a structure to fill with the counters.
+*/
+void cairo_dock_get_launch_stats (CairoDockLaunchStats *pStats);
+
 /** Get the command to launch the default terminal
  */
 const gchar * cairo_dock_get_default_terminal (void);
@@ -48,6 +48,8 @@ typedef enum {
 	NOTIFICATION_WINDOW_Z_ORDER_CHANGED,
 	NOTIFICATION_WINDOW_ACTIVATED,
 	NOTIFICATION_WINDOW_DESKTOP_CHANGED,
+	/// notification called when a window has moved in the stack of windows, before NOTIFICATION_WINDOW_Z_ORDER_CHANGED is sent for the whole stack. data: the actor, with its new iStackOrder.
+	NOTIFICATION_WINDOW_RESTACKED,
 	NB_NOTIFICATIONS_WINDOWS
 	} GldiWindowNotifications;
 
@@ -71,6 +71,9 @@
 #include <gldit/cairo-dock-draw-opengl.h>
 #include <gldit/cairo-dock-draw.h>
 #include <gldit/cairo-dock-overlay.h>
+#include <gldit/cairo-dock-render-batch.h>
+#include <gldit/cairo-dock-texture-atlas.h>
+#include <gldit/cairo-dock-image-cache.h>
 #include <gldit/cairo-dock-dock-facility.h>
 #include <gldit/cairo-dock-animations.h>
 // GUI
@@ -90,6 +93,8 @@
 #include <gldit/cairo-dock-keyfile-utilities.h>
 #include <gldit/cairo-dock-keybinder.h>
 #include <gldit/cairo-dock-task.h>
+#include <gldit/cairo-dock-timer.h>
+#include <gldit/cairo-dock-trace.h>
 #include <gldit/cairo-dock-particle-system.h>
 #include <gldit/cairo-dock-packages.h>
 #include <gldit/cairo-dock-surface-factory.h>
@@ -85,12 +85,17 @@ static Atom s_aWmHints;
 static Atom s_aNetStartupInfoBegin;
 static Atom s_aNetStartupInfo;
 static GHashTable *s_hXWindowTable = NULL;  // table of (Xid,actor)
+static GList *s_pEdgeTriggers = NULL;  // list of GldiXEdgeTrigger
 static GHashTable *s_hXClientMessageTable = NULL;  // table of (Xid,client-message)
 static int s_iTime = 1;  // on peut aller jusqu'a 2^31, soit 17 ans a 4Hz.
 static int s_iNumWindow = 1;  // used to order appli icons by age (=creation date).
 static Window s_iCurrentActiveWindow = 0;
 static guint num_lock_mask=0, caps_lock_mask=0, scroll_lock_mask=0;
 static GPollFD s_poll_fd;
+static Window *s_pStackedWindows = NULL;  // the stack of windows at the last update
+static gulong s_iNbStackedWindows = 0;
+static gboolean s_bStackOutdated = FALSE;  // TRUE if a window has been removed from the table and must be detected again on the next update
+static GldiXStackStats s_stackStats;
 
 typedef enum {
 	X_DEMANDS_ATTENTION = (1<<0),
@@ -116,8 +121,10 @@ struct _GldiXWindowActor {
 	};
 
 
-static GldiXWindowActor *_make_new_actor (Window Xid)
+// pProps: the properties of the window, fetched beforehand with the ones of the other new windows; the actor takes the ones it needs.
+static GldiXWindowActor *_make_new_actor (CairoDockXWindowProperties *pProps)
 {
+	Window Xid = pProps->Xid;
 	GldiXWindowActor *xactor;
 	gboolean bShowInTaskbar = FALSE;
 	gboolean bNormalWindow = FALSE;
@@ -127,22 +134,20 @@ static GldiXWindowActor *_make_new_actor (Window Xid)
 	
 	//\__________________ see if we should skip it
 	// check its 'skip taskbar' property
-	bShowInTaskbar = cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Xid, &bIsFullScreen, &bIsHidden, &bIsMaximized, &bDemandsAttention, &bIsSticky);
+	bShowInTaskbar = cairo_dock_xwindow_properties_get_state (pProps, &bIsFullScreen, &bIsHidden, &bIsMaximized, &bDemandsAttention, &bIsSticky);
 	
 	if (bShowInTaskbar)
 	{
 		// check its type
-		bNormalWindow = cairo_dock_get_xwindow_type (Xid, &iTransientFor);
+		bNormalWindow = cairo_dock_xwindow_properties_get_type (pProps, &iTransientFor);
 		if (bNormalWindow || iTransientFor != None)
 		{
 			// check get its class
-			cClass = cairo_dock_get_xwindow_class (Xid, &cWmClass);
+			cClass = cairo_dock_xwindow_properties_get_class (pProps, &cWmClass);
 			if (cClass == NULL)
 			{
-				gchar *cName = cairo_dock_get_xwindow_name (Xid, TRUE);
 				cd_warning ("this window (%s, %ld) doesn't belong to any class, skip it.\n"
-					"Please report this bug to the application's devs.", cName, Xid);
-				g_free (cName);
+					"Please report this bug to the application's devs.", pProps->cName, Xid);
 				bShowInTaskbar = FALSE;
 			}
 		}
@@ -154,13 +159,13 @@ static GldiXWindowActor *_make_new_actor (Window Xid)
 	}
 	else
 	{
-		XGetTransientForHint (s_XDisplay, Xid, &iTransientFor);
+		iTransientFor = pProps->XTransientFor;
 	}
 	
 	//\__________________ if the window passed all the tests, make a new actor
 	if (bShowInTaskbar)  // make a new actor and fill the properties we got before
 	{
-		xactor = (GldiXWindowActor*)gldi_object_new (&myXObjectMgr, &Xid);
+		xactor = (GldiXWindowActor*)gldi_object_new (&myXObjectMgr, pProps);
 		GldiWindowActor *actor = (GldiWindowActor*)xactor;
 		actor->bDisplayed = bNormalWindow;
 		actor->cClass = cClass;
@@ -261,64 +266,128 @@ static void _update_backing_pixmap (GldiXWindowActor *actor)
 #endif
 }
 
-static gboolean _remove_old_applis (Window *Xid, GldiXWindowActor *actor, gpointer iTimePtr)
+static void _remove_old_appli (GldiXWindowActor *actor)
 {
-	gint iTime = GPOINTER_TO_INT (iTimePtr);
-	if (actor->iLastCheckTime >= 0 && actor->iLastCheckTime < iTime)
-	{
-		cd_message ("cette fenetre (%ld, %p, %s) est trop vieille (%d / %d)", *Xid, actor, actor->actor.cName, actor->iLastCheckTime, iTime);
-		// notify everybody
-		if (! actor->bIgnored)
-			gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_DESTROYED, actor);
-		
-		actor->iLastCheckTime = -1;  // to not remove it from the table during the free
-		_delete_actor (actor);
-		return TRUE;  // remove it from the table
-	}
-	return FALSE;
+	cd_message ("cette fenetre (%ld, %p, %s) est trop vieille (%d / %d)", actor->Xid, actor, actor->actor.cName, actor->iLastCheckTime, s_iTime);
+	s_stackStats.iNbDestroyed ++;
+	// notify everybody
+	if (! actor->bIgnored)
+		gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_DESTROYED, actor);
+	
+	g_hash_table_remove (s_hXWindowTable, &actor->Xid);
+	actor->iLastCheckTime = -1;  // to not remove it from the table during the free
+	_delete_actor (actor);
 }
 static void _on_update_applis_list (void)
 {
-	s_iTime ++;
+	s_stackStats.iNbUpdates ++;
 	// get all windows sorted by z-order
 	gulong i, iNbWindows = 0;
 	Window *pXWindowsList = cairo_dock_get_windows_list (&iNbWindows, TRUE);  // TRUE => ordered by z-stack.
 	
-	// set the z-order of existing windows, and create actors for new windows
+	// if the stack is the same as before (it happens, for instance when a window is raised while already on top), there is nothing to do.
+	if (! s_bStackOutdated
+	&& iNbWindows == s_iNbStackedWindows
+	&& (iNbWindows == 0 || memcmp (pXWindowsList, s_pStackedWindows, iNbWindows * sizeof (Window)) == 0))
+	{
+		s_stackStats.iNbUnchanged ++;
+		if (pXWindowsList != NULL)
+			XFree (pXWindowsList);
+		return;
+	}
+	s_bStackOutdated = FALSE;
+	s_iTime ++;
+	
+	// get the known windows, and the properties of all the new windows at once
 	Window Xid;
 	GldiXWindowActor *actor;
+	GldiXWindowActor **pActors = g_new (GldiXWindowActor*, iNbWindows);
+	CairoDockXWindowProperties *pNewWindows = NULL;
+	guint iNbNewWindows = 0;
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		Xid = pXWindowsList[i];
+		pActors[i] = g_hash_table_lookup (s_hXWindowTable, &Xid);
+		if (pActors[i] == NULL)
+		{
+			if (pNewWindows == NULL)
+				pNewWindows = g_new0 (CairoDockXWindowProperties, iNbWindows - i);
+			pNewWindows[iNbNewWindows++].Xid = Xid;
+		}
+	}
+	s_stackStats.iNbLookups += iNbWindows;
+	cairo_dock_get_xwindows_properties (pNewWindows, iNbNewWindows);
+	
+	// create actors for new windows, and set the z-order of all windows
+	GPtrArray *pRestackedActors = g_ptr_array_new ();
+	guint n = 0;  // index of the next new window
 	int iStackOrder = 0;
 	for (i = 0; i < iNbWindows; i ++)
 	{
 		Xid = pXWindowsList[i];
-		
-		// check if the window is already known
-		actor = g_hash_table_lookup (s_hXWindowTable, &Xid);
-		if (actor == NULL)
+		actor = pActors[i];
+		if (actor == NULL)  // new window, its properties are the next ones.
 		{
-			// create a window actor
-			cd_message (" cette fenetre (%ld) de la pile n'est pas dans la liste", Xid);
-			actor = _make_new_actor (Xid);
-			
-			// notify everybody
-			if (! actor->bIgnored)
-				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_CREATED, actor);
+			actor = g_hash_table_lookup (s_hXWindowTable, &Xid);  // in case the window is twice in the list
+			s_stackStats.iNbLookups ++;
+			if (actor == NULL)
+			{
+				// create a window actor
+				cd_message (" cette fenetre (%ld) de la pile n'est pas dans la liste", Xid);
+				actor = _make_new_actor (&pNewWindows[n]);
+				s_stackStats.iNbCreated ++;
+				
+				// notify everybody
+				if (! actor->bIgnored)
+					gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_CREATED, actor);
+			}
+			cairo_dock_free_xwindow_properties (&pNewWindows[n]);
+			n ++;
 		}
-		else  // just update its check-time
-			actor->iLastCheckTime = s_iTime;
+		actor->iLastCheckTime = s_iTime;
 		
 		// update the z-order
 		if (! actor->bIgnored)
+		{
+			if (actor->actor.iStackOrder != iStackOrder && pActors[i] != NULL)  // a new window is not restacked, it's created.
+				g_ptr_array_add (pRestackedActors, actor);
 			actor->actor.iStackOrder = iStackOrder ++;
+		}
 	}
+	g_free (pNewWindows);
+	g_free (pActors);
 	
-	// remove old actors for windows that disappeared
-	g_hash_table_foreach_remove (s_hXWindowTable, (GHRFunc) _remove_old_applis, GINT_TO_POINTER (s_iTime));
+	// remove old actors for windows that disappeared; they were in the previous stack, so no need to look at all the windows.
+	for (i = 0; i < s_iNbStackedWindows; i ++)
+	{
+		Xid = s_pStackedWindows[i];
+		actor = g_hash_table_lookup (s_hXWindowTable, &Xid);
+		if (actor != NULL && actor->iLastCheckTime >= 0 && actor->iLastCheckTime < s_iTime)
+			_remove_old_appli (actor);
+	}
+	s_stackStats.iNbLookups += s_iNbStackedWindows;
 	
-	// notify everybody that the stack order has changed
-	gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_Z_ORDER_CHANGED, NULL);
+	// remember the stack for the next time
+	if (s_pStackedWindows != NULL)
+		XFree (s_pStackedWindows);
+	s_pStackedWindows = pXWindowsList;
+	s_iNbStackedWindows = iNbWindows;
 	
-	XFree (pXWindowsList);
+	// notify everybody that the stack order has changed, window by window and then globally
+	for (i = 0; i < pRestackedActors->len; i ++)
+	{
+		actor = g_ptr_array_index (pRestackedActors, i);
+		gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_RESTACKED, actor);
+	}
+	s_stackStats.iNbRestacked += pRestackedActors->len;
+	g_ptr_array_free (pRestackedActors, TRUE);
+	
+	gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_Z_ORDER_CHANGED, NULL);
+}
+
+void gldi_X_manager_get_stack_stats (GldiXStackStats *pStats)
+{
+	*pStats = s_stackStats;
 }
 
 static void _set_demand_attention (GldiXWindowActor *actor, XAttentionFlag flag)
@@ -356,6 +425,146 @@ static void lookup_ignorable_modifiers (void)
 	scroll_lock_mask = XkbKeysymToModifiers (s_XDisplay, GDK_KEY_Scroll_Lock);
 }
 
+#ifdef GDK_WINDOWING_X11
+#define _gldi_container_get_Xid(pContainer) GDK_WINDOW_XID (gldi_container_get_gdk_window(pContainer))
+#else
+_gldi_container_get_Xid(pContainer) 0
+#endif
+
+  ///////////////////////////
+ /// SCREEN EDGE TRIGGERS ///
+///////////////////////////
+
+// a trigger is a thin input-only window; it doesn't draw anything, and the X server tells us when the pointer enters it.
+// it is stacked just above the window of its container (a hidden dock, which is in the docks layer), so that it's above the normal windows, but doesn't cover the windows that are above the dock (menus, other panels, notifications) and would lose their clicks on the edge.
+// it must not stay above a fullscreen window either (a game or a video player would not get the clicks on the edge), so it's unmapped while the active window is fullscreen over it.
+typedef struct {
+	Window Xid;
+	Window XSibling;  // the top-level window of the container (its frame, if the WM reparents it), that the trigger is stacked above.
+	GdkRectangle area;
+	gboolean bMapped;
+	GldiScreenEdgeFunc pCallback;
+	gpointer data;
+} GldiXEdgeTrigger;
+
+static Window _get_top_level_window (Window Xid)
+{
+	Window root, parent = None, *children = NULL;
+	unsigned int iNbChildren;
+	while (Xid != None)
+	{
+		_count_x_round_trip ();
+		if (! XQueryTree (s_XDisplay, Xid, &root, &parent, &children, &iNbChildren))
+			return None;
+		if (children != NULL)
+			XFree (children);
+		if (parent == root)
+			break;
+		Xid = parent;
+	}
+	return Xid;
+}
+
+static gboolean _screen_edge_trigger_is_under_fullscreen_window (GldiXEdgeTrigger *pTrigger)
+{
+	GldiXWindowActor *xactor = (s_iCurrentActiveWindow != 0 ? g_hash_table_lookup (s_hXWindowTable, &s_iCurrentActiveWindow) : NULL);
+	if (xactor == NULL || xactor->bIgnored)  // the state of an ignored window is not followed.
+		return FALSE;
+	GldiWindowActor *actor = (GldiWindowActor*)xactor;
+	if (! actor->bIsFullScreen || actor->bIsHidden)
+		return FALSE;
+	GdkRectangle window = {actor->windowGeometry.x, actor->windowGeometry.y, actor->windowGeometry.width, actor->windowGeometry.height};
+	return gdk_rectangle_intersect (&pTrigger->area, &window, NULL);
+}
+
+static void _update_screen_edge_trigger (GldiXEdgeTrigger *pTrigger)
+{
+	if (_screen_edge_trigger_is_under_fullscreen_window (pTrigger))
+	{
+		if (pTrigger->bMapped)
+		{
+			XUnmapWindow (s_XDisplay, pTrigger->Xid);
+			pTrigger->bMapped = FALSE;
+		}
+	}
+	else
+	{
+		if (! pTrigger->bMapped)
+		{
+			XMapWindow (s_XDisplay, pTrigger->Xid);
+			pTrigger->bMapped = TRUE;
+		}
+		if (pTrigger->XSibling != None)  // the container may have been restacked, follow it; without a sibling, the trigger stays where it has been mapped, on top.
+		{
+			XWindowChanges changes;
+			changes.sibling = pTrigger->XSibling;
+			changes.stack_mode = Above;
+			XConfigureWindow (s_XDisplay, pTrigger->Xid, CWSibling | CWStackMode, &changes);
+		}
+	}
+}
+
+static gpointer _add_screen_edge_trigger (int x, int y, int w, int h, GldiContainer *pContainer, GldiScreenEdgeFunc pCallback, gpointer data)
+{
+	XSetWindowAttributes attr;
+	attr.override_redirect = True;  // not managed by the WM, so it stays where it is and doesn't appear in any taskbar.
+	attr.event_mask = EnterWindowMask | LeaveWindowMask | PointerMotionMask;
+	Window Xid = XCreateWindow (s_XDisplay,
+		DefaultRootWindow (s_XDisplay),
+		x, y, MAX (w, 1), MAX (h, 1),
+		0,  // border
+		0,  // depth (must be 0 for InputOnly)
+		InputOnly,
+		CopyFromParent,
+		CWOverrideRedirect | CWEventMask,
+		&attr);
+	if (Xid == 0)
+		return NULL;
+	
+	GldiXEdgeTrigger *pTrigger = g_new0 (GldiXEdgeTrigger, 1);
+	pTrigger->Xid = Xid;
+	pTrigger->XSibling = (pContainer != NULL ? _get_top_level_window (_gldi_container_get_Xid (pContainer)) : None);
+	pTrigger->area.x = x;
+	pTrigger->area.y = y;
+	pTrigger->area.width = MAX (w, 1);
+	pTrigger->area.height = MAX (h, 1);
+	pTrigger->pCallback = pCallback;
+	pTrigger->data = data;
+	s_pEdgeTriggers = g_list_prepend (s_pEdgeTriggers, pTrigger);
+	_update_screen_edge_trigger (pTrigger);
+	XFlush (s_XDisplay);
+	return pTrigger;
+}
+
+static void _remove_screen_edge_trigger (GldiXEdgeTrigger *pTrigger)
+{
+	s_pEdgeTriggers = g_list_remove (s_pEdgeTriggers, pTrigger);
+	XDestroyWindow (s_XDisplay, pTrigger->Xid);
+	XFlush (s_XDisplay);
+	g_free (pTrigger);
+}
+
+static void _update_screen_edge_triggers (void)  // the stack, the active window or its state has changed.
+{
+	GList *t;
+	for (t = s_pEdgeTriggers; t != NULL; t = t->next)
+	{
+		_update_screen_edge_trigger (t->data);
+	}
+}
+
+static GldiXEdgeTrigger *_get_screen_edge_trigger (Window Xid)
+{
+	GList *t;
+	for (t = s_pEdgeTriggers; t != NULL; t = t->next)
+	{
+		GldiXEdgeTrigger *pTrigger = t->data;
+		if (pTrigger->Xid == Xid)
+			return pTrigger;
+	}
+	return NULL;
+}
+
 static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 {
 	static XEvent event;
@@ -365,6 +574,7 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 	
 	Window Xid;
 	Window root = DefaultRootWindow (s_XDisplay);
+	GldiXEdgeTrigger *pTrigger;
 	
 	// read the messages on the fd, and put them in the event queue
 	int i, nb_msg = XEventsQueued (s_XDisplay, QueuedAfterReading);
@@ -492,6 +702,13 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 			lookup_ignorable_modifiers ();
 			gldi_object_notify (&myDesktopMgr, NOTIFICATION_KEYMAP_CHANGED, TRUE);
 		}
+		else if ((event.type == EnterNotify || event.type == LeaveNotify || event.type == MotionNotify) && (pTrigger = _get_screen_edge_trigger (Xid)) != NULL)  // the pointer reached or left a screen edge
+		{
+			if (event.type == MotionNotify)
+				pTrigger->pCallback (TRUE, event.xmotion.x_root, event.xmotion.y_root, pTrigger->data);
+			else
+				pTrigger->pCallback (event.type == EnterNotify, event.xcrossing.x_root, event.xcrossing.y_root, pTrigger->data);  // the trigger may be removed by the callback.
+		}
 		else if (Xid == root)  // event on the desktop
 		{
 			if (event.type == PropertyNotify)
@@ -499,6 +716,7 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 				if (event.xproperty.atom == s_aNetClientList)  // the stack order has changed: it's either because a window z-order has changed, or  a window disappeared (destroyed or hidden), or a window appeared.
 				{
 					_on_update_applis_list ();
+					_update_screen_edge_triggers ();
 				}
 				else if (event.xproperty.atom == s_aNetActiveWindow)
 				{
@@ -510,6 +728,7 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 						if (s_iCurrentActiveWindow == None)
 							bForceKbdStateRefresh = TRUE;
 						s_iCurrentActiveWindow = XActiveWindow;
+						_update_screen_edge_triggers ();
 						GldiXWindowActor *xactor = g_hash_table_lookup (s_hXWindowTable, &XActiveWindow);
 						gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ACTIVATED, xactor && ! xactor->bIgnored ? xactor : NULL);
 						if (bForceKbdStateRefresh)
@@ -581,6 +800,7 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 							// remove it from the table, so that the XEvent loop detects it again
 							g_hash_table_remove (s_hXWindowTable, &Xid);  // remove it explicitely, because the 'unref' might not free it
 							xactor->iLastCheckTime = -1;
+							s_bStackOutdated = TRUE;  // the stack may not change, but the window must be detected again
 							_delete_actor (xactor);  // unref it since we don't need it anymore
 						}
 						else  // is now ignored
@@ -600,6 +820,8 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 					actor->bIsHidden     = bIsHidden;
 					actor->bIsMaximized  = bIsMaximized;
 					actor->bIsFullScreen = bIsFullScreen;
+					if ((bFullScreenChanged || bHiddenChanged) && Xid == s_iCurrentActiveWindow)
+						_update_screen_edge_triggers ();
 					if (bHiddenChanged && ! bIsHidden)  // the window is now mapped => BackingPixmap is available.
 						_update_backing_pixmap (xactor);
 					
@@ -709,6 +931,8 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 				{
 					_update_backing_pixmap (xactor);
 				}
+				if (actor->bIsFullScreen && Xid == s_iCurrentActiveWindow)  // it may have moved to another screen.
+					_update_screen_edge_triggers ();
 				
 				// notify everybody
 				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_SIZE_POSITION_CHANGED, actor);
@@ -901,6 +1125,7 @@ static gboolean _grab_shortkey (guint keycode, guint modifiers, gboolean grab)
 	
 	// sync with the server to get any error feedback
 	XSync (s_XDisplay, False);
+	_count_x_round_trip ();
 	int error = cairo_dock_get_X_error_code ();
 	
 	return (error == 0);
@@ -1062,12 +1287,6 @@ static GldiWindowActor *_pick_window (void)
  /// CONTAINER MANAGER BACKEND ///
 /////////////////////////////////
 
-#ifdef GDK_WINDOWING_X11
-#define _gldi_container_get_Xid(pContainer) GDK_WINDOW_XID (gldi_container_get_gdk_window(pContainer))
-#else
-_gldi_container_get_Xid(pContainer) 0
-#endif
-
 static void _reserve_space (GldiContainer *pContainer, int left, int right, int top, int bottom, int left_start_y, int left_end_y, int right_start_y, int right_end_y, int top_start_x, int top_end_x, int bottom_start_x, int bottom_end_x)
 {
 	Window Xid = _gldi_container_get_Xid (pContainer);
@@ -1190,14 +1409,18 @@ static void init (void)
 	Window *pXWindowsList = cairo_dock_get_windows_list (&iNbWindows, FALSE);  // ordered by creation date; this allows us to set the correct age to the icon, which is constant. On the next updates, the z-order (which is dynamic) will be set.
 	cd_debug ("got %d X windows", iNbWindows);
 	
-	Window Xid;
+	CairoDockXWindowProperties *pWindows = g_new0 (CairoDockXWindowProperties, iNbWindows);
+	for (i = 0; i < iNbWindows; i ++)
+		pWindows[i].Xid = pXWindowsList[i];
+	cairo_dock_get_xwindows_properties (pWindows, iNbWindows);  // all at once
 	for (i = 0; i < iNbWindows; i ++)
 	{
-		Xid = pXWindowsList[i];
-		(void)_make_new_actor (Xid);
+		(void)_make_new_actor (&pWindows[i]);
+		cairo_dock_free_xwindow_properties (&pWindows[i]);
 	}
-	if (pXWindowsList != NULL)
-		XFree (pXWindowsList);
+	g_free (pWindows);
+	s_pStackedWindows = pXWindowsList;  // ordered by age, but it doesn't matter, it's only used to know which windows are present.
+	s_iNbStackedWindows = iNbWindows;
 	
 	//\__________________ get the current active window
 	if (s_iCurrentActiveWindow == 0)
@@ -1238,6 +1461,8 @@ static void init (void)
 	dmb.refresh                = _refresh;
 	dmb.notify_startup         = _notify_startup;
 	dmb.grab_shortkey          = _grab_shortkey;
+	dmb.add_screen_edge_trigger    = _add_screen_edge_trigger;
+	dmb.remove_screen_edge_trigger = (void (*) (gpointer)) _remove_screen_edge_trigger;
 	gldi_desktop_manager_register_backend (&dmb);
 	
 	GldiWindowManagerBackend wmb;
@@ -1291,17 +1516,17 @@ static void init_object (GldiObject *obj, gpointer attr)
 {
 	GldiXWindowActor *xactor = (GldiXWindowActor*)obj;
 	GldiWindowActor *actor = (GldiWindowActor*)xactor;
-	Window *xid = (Window*)attr;
-	Window Xid = *xid;
+	CairoDockXWindowProperties *pProps = (CairoDockXWindowProperties*)attr;
+	Window Xid = pProps->Xid;
 	
 	xactor->Xid = Xid;
 	
 	// get additional properties
-	actor->cName = cairo_dock_get_xwindow_name (Xid, TRUE);
-	actor->iNumDesktop = cairo_dock_get_xwindow_desktop (Xid);
+	actor->cName = pProps->cName;
+	pProps->cName = NULL;  // we take it
+	actor->iNumDesktop = pProps->iNumDesktop;
 	
-	int iLocalPositionX=0, iLocalPositionY=0, iWidthExtent=0, iHeightExtent=0;
-	cairo_dock_get_xwindow_geometry (Xid, &iLocalPositionX, &iLocalPositionY, &iWidthExtent, &iHeightExtent);
+	int iLocalPositionX = pProps->iLocalPositionX, iLocalPositionY = pProps->iLocalPositionY, iWidthExtent = pProps->iWidthExtent, iHeightExtent = pProps->iHeightExtent;
 	
 	actor->iViewPortX = iLocalPositionX / g_desktopGeometry.Xscreen.width + g_desktopGeometry.iCurrentViewportX;
 	actor->iViewPortY = iLocalPositionY / g_desktopGeometry.Xscreen.height + g_desktopGeometry.iCurrentViewportY;
@@ -30,6 +30,23 @@ G_BEGIN_DECLS
 */
 
 
+/// Counters of the updates of the stack of windows, to measure the work done on each change of the stack notified by X.
+typedef struct {
+	/// number of changes of the stack notified by X.
+	guint iNbUpdates;
+	/// number of them where the stack didn't actually change.
+	guint iNbUnchanged;
+	/// number of windows looked up in the table of windows.
+	guint iNbLookups;
+	/// number of windows created, destroyed, and moved in the stack.
+	guint iNbCreated, iNbDestroyed, iNbRestacked;
+} GldiXStackStats;
+
+/** Get the counters of the updates of the stack of windows since the beginning.
+*@param pStats a structure to fill with the counters.
+*/
+void gldi_X_manager_get_stack_stats (GldiXStackStats *pStats);
+
 void gldi_register_X_manager (void);
 
 G_END_DECLS
@@ -32,6 +32,10 @@
 #include <X11/extensions/Xrandr.h>
 #endif
 
+#ifdef HAVE_XCB
+#include <X11/Xlib-xcb.h>  // XGetXCBConnection
+#include <xcb/xcb.h>
+#endif
 #include "cairo-dock-log.h"
 #include "cairo-dock-utils.h"  // cairo_dock_remove_version_from_string, cairo_dock_check_xrandr
 #include "cairo-dock-surface-factory.h"  // cairo_dock_create_surface_from_xicon_buffer
@@ -87,6 +91,7 @@ static Atom s_aNetWmName;
 static Atom s_aWmName;
 static Atom s_aUtf8String;
 static Atom s_aString;
+static Atom s_aNetFrameExtents;
 static unsigned char error_code = Success;
 
 static GtkAllocation *_get_screens_geometry (int *pNbScreens);
@@ -158,6 +163,7 @@ Display *cairo_dock_initialize_X_desktop_support (void)
     s_aWmName                   = XInternAtom (s_XDisplay, "WM_NAME", False);
     s_aUtf8String               = XInternAtom (s_XDisplay, "UTF8_STRING", False);
     s_aString                   = XInternAtom (s_XDisplay, "STRING", False);
+    s_aNetFrameExtents          = XInternAtom (s_XDisplay, "_NET_FRAME_EXTENTS", False);
 	
 	Screen *XScreen = XDefaultScreenOfDisplay (s_XDisplay);
 	
@@ -300,6 +306,7 @@ static GtkAllocation *_get_screens_geometry (int *pNbScreens)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXWorkArea = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, root, aNetWorkArea, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXWorkArea);
 	int i;
 	for (i = 0; i < iBufferNbElements/4; i ++)
@@ -319,6 +326,7 @@ gboolean cairo_dock_update_screen_geometry (void)
 	Window root_return;
 	int x_return=1, y_return=1;
 	unsigned int width_return, height_return, border_width_return, depth_return;
+	_count_x_round_trip ();
 	XGetGeometry (s_XDisplay, root,
 		&root_return,
 		&x_return, &y_return,
@@ -369,6 +377,7 @@ gchar **cairo_dock_get_desktops_names (void)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gchar *names = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, root, s_aNetDesktopNames, 0, G_MAXULONG, False, s_aUtf8String, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&names);
 	
 	if (iBufferNbElements > 0)
@@ -429,6 +438,7 @@ int cairo_dock_get_current_desktop (void)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXDesktopNumberBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, root, s_aNetCurrentDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXDesktopNumberBuffer);
 
 	int iDesktopNumber;
@@ -448,6 +458,7 @@ void cairo_dock_get_current_viewport (int *iCurrentViewPortX, int *iCurrentViewP
 	Window root_return;
 	int x_return=1, y_return=1;
 	unsigned int width_return, height_return, border_width_return, depth_return;
+	_count_x_round_trip ();
 	XGetGeometry (s_XDisplay, root,
 		&root_return,
 		&x_return, &y_return,
@@ -460,6 +471,7 @@ void cairo_dock_get_current_viewport (int *iCurrentViewPortX, int *iCurrentViewP
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pViewportsXY = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, root, s_aNetDesktopViewport, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pViewportsXY);
 	if (iBufferNbElements > 0)
 	{
@@ -477,6 +489,7 @@ int cairo_dock_get_nb_desktops (void)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXDesktopNumberBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, root, s_aNetNbDesktops, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXDesktopNumberBuffer);
 	
 	int iNumberOfDesktops;
@@ -495,6 +508,7 @@ void cairo_dock_get_nb_viewports (int *iNbViewportX, int *iNbViewportY)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pVirtualScreenSizeBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, root, s_aNetDesktopGeometry, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pVirtualScreenSizeBuffer);
 	if (iBufferNbElements > 0)
 	{
@@ -515,6 +529,7 @@ gboolean cairo_dock_desktop_is_visible (void)
 	int aReturnedFormat = 0;
 	gulong *pXBuffer = NULL;
 	Window root = DefaultRootWindow (s_XDisplay);
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, root, aNetShowingDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXBuffer);
 
 	gboolean bDesktopIsShown = (iBufferNbElements > 0 && pXBuffer != NULL ? *pXBuffer : FALSE);
@@ -615,6 +630,7 @@ Pixmap cairo_dock_get_window_background_pixmap (Window Xid)
 	unsigned long iLeftBytes, iBufferNbElements;
 	Pixmap *pPixmapIdBuffer = NULL;
 	Pixmap iBgPixmapID = 0;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, s_aRootMapID, 0, G_MAXULONG, False, XA_PIXMAP, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pPixmapIdBuffer);
 	if (iBufferNbElements != 0)
 	{
@@ -634,6 +650,7 @@ GdkPixbuf *cairo_dock_get_pixbuf_from_pixmap (int XPixmapID, gboolean bAddAlpha)
 	int x, y;  // inutile.
 	guint border_width;  // inutile.
 	guint iWidth, iHeight, iDepth;
+	_count_x_round_trip ();
 	if (! XGetGeometry (s_XDisplay,
 		XPixmapID, &root, &x, &y,
 		&iWidth, &iHeight, &border_width, &iDepth))
@@ -1081,6 +1098,7 @@ gulong cairo_dock_get_xwindow_timestamp (Window Xid)
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
 	gulong *pTimeBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, aNetWmUserTime, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTimeBuffer);
 	gulong iTimeStamp = 0;
 	if (iBufferNbElements > 0)
@@ -1095,9 +1113,13 @@ gchar *cairo_dock_get_xwindow_name (Window Xid, gboolean bSearchWmName)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements=0;
 	guchar *pNameBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmName, 0, G_MAXULONG, False, s_aUtf8String, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, &pNameBuffer);  // on cherche en priorite le nom en UTF8, car on est notifie des 2, mais il vaut mieux eviter le WM_NAME qui, ne l'etant pas, contient des caracteres bizarres qu'on ne peut pas convertir avec g_locale_to_utf8, puisque notre locale _est_ UTF8.
 	if (iBufferNbElements == 0 && bSearchWmName)
+	{
+		_count_x_round_trip ();
 		XGetWindowProperty (s_XDisplay, Xid, s_aWmName, 0, G_MAXULONG, False, s_aString, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, &pNameBuffer);
+	}
 	
 	gchar *cName = NULL;
 	if (iBufferNbElements > 0)
@@ -1108,11 +1130,10 @@ gchar *cairo_dock_get_xwindow_name (Window Xid, gboolean bSearchWmName)
 	return cName;
 }
 
-gchar *cairo_dock_get_xwindow_class (Window Xid, gchar **cWMClass)
+static gchar *_make_xwindow_class (XClassHint *pClassHint, gchar **cWMClass)
 {
-	XClassHint *pClassHint = XAllocClassHint ();
 	gchar *cClass = NULL, *cWmClass = NULL;
-	if (XGetClassHint (s_XDisplay, Xid, pClassHint) != 0 && pClassHint->res_class)
+	if (pClassHint->res_class)
 	{
 		cWmClass = g_strdup (pClassHint->res_class);
 		
@@ -1171,10 +1192,6 @@ gchar *cairo_dock_get_xwindow_class (Window Xid, gchar **cWMClass)
 		if (str != NULL)
 			*str = '\0';
 		cd_debug ("got an application with class '%s'", cClass);
-		
-		XFree (pClassHint->res_name);
-		XFree (pClassHint->res_class);
-		XFree (pClassHint);
 	}
 	if (cWMClass)
 		*cWMClass = cWmClass;
@@ -1183,6 +1200,23 @@ gchar *cairo_dock_get_xwindow_class (Window Xid, gchar **cWMClass)
 	return cClass;
 }
 
+gchar *cairo_dock_get_xwindow_class (Window Xid, gchar **cWMClass)
+{
+	XClassHint *pClassHint = XAllocClassHint ();
+	gchar *cClass = NULL;
+	_count_x_round_trip ();
+	if (XGetClassHint (s_XDisplay, Xid, pClassHint) != 0)
+	{
+		cClass = _make_xwindow_class (pClassHint, cWMClass);
+		XFree (pClassHint->res_name);
+		XFree (pClassHint->res_class);
+	}
+	else if (cWMClass)
+		*cWMClass = NULL;
+	XFree (pClassHint);
+	return cClass;
+}
+
 gboolean cairo_dock_xwindow_is_maximized (Window Xid)
 {
 	g_return_val_if_fail (Xid > 0, FALSE);
@@ -1191,6 +1225,7 @@ gboolean cairo_dock_xwindow_is_maximized (Window Xid)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
 	int iIsMaximized = 0;
 	if (iBufferNbElements > 0)
@@ -1216,6 +1251,7 @@ static gboolean _cairo_dock_window_is_in_state (Window Xid, Atom iState)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
 
 	gboolean bIsInState = FALSE;
@@ -1258,6 +1294,7 @@ void cairo_dock_xwindow_is_above_or_below (Window Xid, gboolean *bIsAbove, gbool
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
 
 	if (iBufferNbElements > 0)
@@ -1285,16 +1322,8 @@ void cairo_dock_xwindow_is_above_or_below (Window Xid, gboolean *bIsAbove, gbool
 	XFree (pXStateBuffer);
 }
 
-gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
+static gboolean _parse_xwindow_state (gulong *pXStateBuffer, gulong iBufferNbElements, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
 {
-	g_return_val_if_fail (Xid > 0, FALSE);
-	//cd_debug ("%s (%d)", __func__, Xid);
-	Atom aReturnedType = 0;
-	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements = 0;
-	gulong *pXStateBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
-	
 	gboolean bValid = TRUE;
 	*bIsFullScreen = FALSE;
 	*bIsHidden = FALSE;
@@ -1344,6 +1373,21 @@ gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gb
 			}
 		}
 	}
+	return bValid;
+}
+
+gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
+{
+	g_return_val_if_fail (Xid > 0, FALSE);
+	//cd_debug ("%s (%d)", __func__, Xid);
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iLeftBytes, iBufferNbElements = 0;
+	gulong *pXStateBuffer = NULL;
+	_count_x_round_trip ();
+	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
+	
+	gboolean bValid = _parse_xwindow_state (pXStateBuffer, iBufferNbElements, bIsFullScreen, bIsHidden, bIsMaximized, bDemandsAttention, bIsSticky);
 	
 	XFree (pXStateBuffer);
 	return bValid;
@@ -1358,6 +1402,7 @@ void cairo_dock_xwindow_can_minimize_maximized_close (Window Xid, gboolean *bCan
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
 	
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay,
 		Xid, s_aNetWMAllowedActions, 0, G_MAXULONG, False, XA_ATOM,
 		&aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
@@ -1397,6 +1442,7 @@ int cairo_dock_get_xwindow_desktop (Window Xid)
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
 	gulong *pBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pBuffer);
 	if (iBufferNbElements > 0)
 		iDesktopNumber = *pBuffer;
@@ -1416,6 +1462,7 @@ void cairo_dock_get_xwindow_geometry (Window Xid, int *iLocalPositionX, int *iLo
 		Window root_return;
 		int x_return=1, y_return=1;
 		unsigned int border_width_return, depth_return;
+		_count_x_round_trip ();
 		XGetGeometry (s_XDisplay, Xid,
 			&root_return,
 			&x_return, &y_return,
@@ -1429,6 +1476,7 @@ void cairo_dock_get_xwindow_geometry (Window Xid, int *iLocalPositionX, int *iLo
 	Window root = DefaultRootWindow (s_XDisplay);
 	int dest_x_return, dest_y_return;
 	Window child_return;
+	_count_x_round_trip ();
 	XTranslateCoordinates (s_XDisplay, Xid, root, 0, 0, &dest_x_return, &dest_y_return, &child_return);  // translate into the coordinate space of the root window. we need to do this, because (x_return,;y_return) is always (0;0)
 	
 	// take into account the window borders
@@ -1437,6 +1485,7 @@ void cairo_dock_get_xwindow_geometry (Window Xid, int *iLocalPositionX, int *iLo
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
 	gulong *pBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, XInternAtom (s_XDisplay, "_NET_FRAME_EXTENTS", False), 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pBuffer);
 	if (iBufferNbElements > 3)
 	{
@@ -1460,6 +1509,7 @@ Window *cairo_dock_get_windows_list (gulong *iNbWindows, gboolean bStackOrder)
 
 	Window root = DefaultRootWindow (s_XDisplay);
 	gulong iLeftBytes;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, root, (bStackOrder ? s_aNetClientListStacking : s_aNetClientList), 0, G_MAXLONG, False, XA_WINDOW, &aReturnedType, &aReturnedFormat, iNbWindows, &iLeftBytes, (guchar **)&XidList);
 	return XidList;
 }
@@ -1471,6 +1521,7 @@ Window cairo_dock_get_active_xwindow (void)
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	Window *pXBuffer = NULL;
 	Window root = DefaultRootWindow (s_XDisplay);
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, root, s_aNetActiveWindow, 0, G_MAXULONG, False, XA_WINDOW, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXBuffer);
 
 	Window xActiveWindow = (iBufferNbElements > 0 && pXBuffer != NULL ? pXBuffer[0] : 0);
@@ -1486,6 +1537,7 @@ cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth,
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXIconBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmIcon, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXIconBuffer);
 
 	if (iBufferNbElements > 2)
@@ -1499,6 +1551,7 @@ cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth,
 	}
 	else  // sinon on tente avec l'icone eventuellement presente dans les WMHints.
 	{
+		_count_x_round_trip ();
 		XWMHints *pWMHints = XGetWMHints (s_XDisplay, Xid);
 		if (pWMHints == NULL)
 		{
@@ -1612,6 +1665,7 @@ GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap)
 	
 	Display *display = s_XDisplay;
 	XWindowAttributes attrib;
+	_count_x_round_trip ();
 	XGetWindowAttributes (display, Xid, &attrib);
 	
 	VisualID visualid = XVisualIDFromVisual (attrib.visual);
@@ -1732,6 +1786,7 @@ GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pPidBuffer = NULL;
+	_count_x_round_trip ();
 	XGetWindowProperty (s_XDisplay, Xid, XInternAtom (s_XDisplay, "_NET_WM_PID", False), 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pPidBuffer);
 	
 	gchar *cCommand = NULL;
@@ -1752,14 +1807,10 @@ GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap)
 	return cCommand;
 }*/
 
-gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
+// pKnownTransientFor: the WM_TRANSIENT_FOR of the window if we already have it, or NULL to get it only when needed.
+static gboolean _parse_xwindow_type (Window Xid, gulong *pTypeBuffer, gulong iBufferNbElements, const Window *pKnownTransientFor, Window *pTransientFor)
 {
 	gboolean bKeep = FALSE;  // we only want to know if we can display this window in the dock or not, so a boolean is enough.
-	Atom aReturnedType = 0;
-	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements;
-	gulong *pTypeBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmWindowType, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTypeBuffer);
 	if (iBufferNbElements != 0)
 	{
 		guint i;
@@ -1772,7 +1823,13 @@ gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 			}
 			if (pTypeBuffer[i] == s_aNetWmWindowTypeDialog)  // dialog -> skip modal dialog, because we can't act on it independantly from the parent window (it's most probably a dialog box like an open/save dialog)
 			{
-				XGetTransientForHint (s_XDisplay, Xid, pTransientFor);  // maybe we should also get the _NET_WM_STATE_MODAL property, although if a dialog is set modal but not transient, that would probably be an error from the application.
+				if (pKnownTransientFor != NULL)
+					*pTransientFor = *pKnownTransientFor;
+				else
+				{
+					_count_x_round_trip ();
+					XGetTransientForHint (s_XDisplay, Xid, pTransientFor);  // maybe we should also get the _NET_WM_STATE_MODAL property, although if a dialog is set modal but not transient, that would probably be an error from the application.
+				}
 				if (*pTransientFor == None)
 				{
 					bKeep = TRUE;
@@ -1784,14 +1841,270 @@ gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 				break;
 			}
 		}
-		XFree (pTypeBuffer);
 	}
 	else  // no type, take it by default, unless it's transient.
 	{
-		XGetTransientForHint (s_XDisplay, Xid, pTransientFor);
+		if (pKnownTransientFor != NULL)
+			*pTransientFor = *pKnownTransientFor;
+		else
+		{
+			_count_x_round_trip ();
+			XGetTransientForHint (s_XDisplay, Xid, pTransientFor);
+		}
 		bKeep = (*pTransientFor == None);
 	}
 	return bKeep;
 }
 
+gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
+{
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iLeftBytes, iBufferNbElements = 0;
+	gulong *pTypeBuffer = NULL;
+	_count_x_round_trip ();
+	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmWindowType, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTypeBuffer);
+	gboolean bKeep = _parse_xwindow_type (Xid, pTypeBuffer, iBufferNbElements, NULL, pTransientFor);
+	if (pTypeBuffer != NULL)
+		XFree (pTypeBuffer);
+	return bKeep;
+}
+
+  /////////////////////////////////
+ /// PROPERTIES OF NEW WINDOWS ///
+/////////////////////////////////
+
+gboolean cairo_dock_xwindow_properties_get_state (const CairoDockXWindowProperties *pProps, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
+{
+	return _parse_xwindow_state (pProps->pStates, pProps->iNbStates, bIsFullScreen, bIsHidden, bIsMaximized, bDemandsAttention, bIsSticky);
+}
+
+gboolean cairo_dock_xwindow_properties_get_type (const CairoDockXWindowProperties *pProps, Window *pTransientFor)
+{
+	return _parse_xwindow_type (pProps->Xid, pProps->pTypes, pProps->iNbTypes, &pProps->XTransientFor, pTransientFor);
+}
+
+gchar *cairo_dock_xwindow_properties_get_class (const CairoDockXWindowProperties *pProps, gchar **cWMClass)
+{
+	XClassHint classHint = {pProps->cResName, pProps->cResClass};
+	return _make_xwindow_class (&classHint, cWMClass);
+}
+
+void cairo_dock_free_xwindow_properties (CairoDockXWindowProperties *pProps)
+{
+	g_free (pProps->pStates);
+	g_free (pProps->pTypes);
+	g_free (pProps->cResName);
+	g_free (pProps->cResClass);
+	g_free (pProps->cName);
+	memset (pProps, 0, sizeof (CairoDockXWindowProperties));
+}
+
+static void _set_xwindow_geometry (CairoDockXWindowProperties *pProps, int iWidth, int iHeight, int iRootX, int iRootY, gulong *pExtents, gulong iNbExtents)
+{
+	// same as 'cairo_dock_get_xwindow_geometry'
+	int left=0, right=0, top=0, bottom=0;
+	if (iNbExtents > 3)
+	{
+		left=pExtents[0], right=pExtents[1], top=pExtents[2], bottom=pExtents[3];
+	}
+	pProps->iLocalPositionX = iRootX - left;
+	pProps->iLocalPositionY = iRootY - top;
+	pProps->iWidthExtent = iWidth + left + right;
+	pProps->iHeightExtent = iHeight + top + bottom;
+}
+
+#ifdef HAVE_XCB
+typedef struct {
+	xcb_get_property_cookie_t state, type, transient, class, net_name, name, desktop, extents;
+	xcb_get_geometry_cookie_t geometry;
+	xcb_translate_coordinates_cookie_t position;
+} CairoDockXWindowCookies;
+
+static xcb_get_property_reply_t *_get_property_reply (xcb_connection_t *c, xcb_get_property_cookie_t cookie, guint iFormat)
+{
+	xcb_generic_error_t *error = NULL;
+	xcb_get_property_reply_t *reply = xcb_get_property_reply (c, cookie, &error);
+	free (error);  // the window may have been destroyed in the meantime, this is not an error.
+	if (reply != NULL && (reply->format != iFormat || xcb_get_property_value_length (reply) == 0))
+	{
+		free (reply);
+		reply = NULL;
+	}
+	return reply;
+}
+
+static gulong *_get_property_longs (xcb_connection_t *c, xcb_get_property_cookie_t cookie, gulong *iNbElements)
+{
+	*iNbElements = 0;
+	xcb_get_property_reply_t *reply = _get_property_reply (c, cookie, 32);
+	if (reply == NULL)
+		return NULL;
+	// Xlib gives the 32 bits properties as longs, so do the same to parse them the same way.
+	int i, n = xcb_get_property_value_length (reply) / 4;
+	uint32_t *pValues = xcb_get_property_value (reply);
+	gulong *pBuffer = g_new (gulong, n);
+	for (i = 0; i < n; i ++)
+		pBuffer[i] = pValues[i];
+	free (reply);
+	*iNbElements = n;
+	return pBuffer;
+}
+
+static gchar *_get_property_string (xcb_connection_t *c, xcb_get_property_cookie_t cookie, gchar **cSecondString)
+{
+	xcb_get_property_reply_t *reply = _get_property_reply (c, cookie, 8);
+	if (reply == NULL)
+		return NULL;
+	int n = xcb_get_property_value_length (reply);
+	const gchar *pValue = xcb_get_property_value (reply);
+	gchar *cString = g_strndup (pValue, n);
+	if (cSecondString != NULL)  // WM_CLASS is made of 2 consecutive strings.
+	{
+		int n1 = strlen (cString) + 1;
+		*cSecondString = (n1 < n ? g_strndup (pValue + n1, n - n1) : NULL);
+	}
+	free (reply);
+	return cString;
+}
+
+void cairo_dock_get_xwindows_properties (CairoDockXWindowProperties *pProps, guint iNbWindows)
+{
+	if (iNbWindows == 0)
+		return;
+	xcb_connection_t *c = XGetXCBConnection (s_XDisplay);
+	xcb_window_t root = DefaultRootWindow (s_XDisplay);
+	CairoDockXWindowCookies *pCookies = g_new (CairoDockXWindowCookies, iNbWindows);
+	CairoDockXWindowCookies *k;
+	xcb_window_t Xid;
+	guint i;
+	
+	//\__________________ send all the requests of all the windows first...
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		Xid = pProps[i].Xid;
+		k = &pCookies[i];
+		k->state = xcb_get_property (c, 0, Xid, s_aNetWmState, XA_ATOM, 0, G_MAXUINT32);
+		k->type = xcb_get_property (c, 0, Xid, s_aNetWmWindowType, XA_ATOM, 0, G_MAXUINT32);
+		k->transient = xcb_get_property (c, 0, Xid, XA_WM_TRANSIENT_FOR, XA_WINDOW, 0, 1);
+		k->class = xcb_get_property (c, 0, Xid, XA_WM_CLASS, XA_STRING, 0, G_MAXUINT32);
+		k->net_name = xcb_get_property (c, 0, Xid, s_aNetWmName, s_aUtf8String, 0, G_MAXUINT32);
+		k->name = xcb_get_property (c, 0, Xid, s_aWmName, s_aString, 0, G_MAXUINT32);
+		k->desktop = xcb_get_property (c, 0, Xid, s_aNetWmDesktop, XA_CARDINAL, 0, 1);
+		k->extents = xcb_get_property (c, 0, Xid, s_aNetFrameExtents, XA_CARDINAL, 0, 4);
+		k->geometry = xcb_get_geometry (c, Xid);
+		k->position = xcb_translate_coordinates (c, Xid, root, 0, 0);
+	}
+	
+	//\__________________ ... then collect the replies, so that we wait for the server only once.
+	_count_x_round_trip ();
+	CairoDockXWindowProperties *p;
+	gulong *pBuffer, n;
+	xcb_generic_error_t *error;
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		p = &pProps[i];
+		k = &pCookies[i];
+		p->pStates = _get_property_longs (c, k->state, &p->iNbStates);
+		p->pTypes = _get_property_longs (c, k->type, &p->iNbTypes);
+		
+		pBuffer = _get_property_longs (c, k->transient, &n);
+		p->XTransientFor = (n > 0 ? pBuffer[0] : None);
+		g_free (pBuffer);
+		
+		p->cResName = _get_property_string (c, k->class, &p->cResClass);
+		
+		p->cName = _get_property_string (c, k->net_name, NULL);
+		if (p->cName == NULL)
+			p->cName = _get_property_string (c, k->name, NULL);
+		else
+			xcb_discard_reply (c, k->name.sequence);
+		
+		pBuffer = _get_property_longs (c, k->desktop, &n);
+		p->iNumDesktop = (n > 0 ? pBuffer[0] : 0);
+		g_free (pBuffer);
+		
+		pBuffer = _get_property_longs (c, k->extents, &n);
+		error = NULL;
+		xcb_get_geometry_reply_t *geometry = xcb_get_geometry_reply (c, k->geometry, &error);
+		free (error);
+		error = NULL;
+		xcb_translate_coordinates_reply_t *position = xcb_translate_coordinates_reply (c, k->position, &error);
+		free (error);
+		_set_xwindow_geometry (p,
+			geometry ? geometry->width : 0, geometry ? geometry->height : 0,
+			position ? position->dst_x : 0, position ? position->dst_y : 0,
+			pBuffer, n);
+		free (geometry);
+		free (position);
+		g_free (pBuffer);
+	}
+	g_free (pCookies);
+}
+
+#else
+
+static gulong *_get_property_longs (Window Xid, Atom aProperty, Atom aType, gulong *iNbElements)
+{
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iLeftBytes, iBufferNbElements = 0;
+	gulong *pXBuffer = NULL;
+	_count_x_round_trip ();
+	XGetWindowProperty (s_XDisplay, Xid, aProperty, 0, G_MAXULONG, False, aType, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXBuffer);
+	gulong *pBuffer = NULL;
+	if (iBufferNbElements > 0)
+	{
+		pBuffer = g_new (gulong, iBufferNbElements);
+		memcpy (pBuffer, pXBuffer, iBufferNbElements * sizeof (gulong));
+	}
+	if (pXBuffer != NULL)
+		XFree (pXBuffer);
+	*iNbElements = iBufferNbElements;
+	return pBuffer;
+}
+
+void cairo_dock_get_xwindows_properties (CairoDockXWindowProperties *pProps, guint iNbWindows)
+{
+	// without XCB, we can't pipeline the requests, so just get the properties one by one.
+	CairoDockXWindowProperties *p;
+	gulong *pBuffer, n;
+	guint i;
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		p = &pProps[i];
+		p->pStates = _get_property_longs (p->Xid, s_aNetWmState, XA_ATOM, &p->iNbStates);
+		p->pTypes = _get_property_longs (p->Xid, s_aNetWmWindowType, XA_ATOM, &p->iNbTypes);
+		p->XTransientFor = None;
+		_count_x_round_trip ();
+		XGetTransientForHint (s_XDisplay, p->Xid, &p->XTransientFor);
+		XClassHint *pClassHint = XAllocClassHint ();
+		_count_x_round_trip ();
+		if (XGetClassHint (s_XDisplay, p->Xid, pClassHint) != 0)
+		{
+			p->cResName = g_strdup (pClassHint->res_name);
+			p->cResClass = g_strdup (pClassHint->res_class);
+			XFree (pClassHint->res_name);
+			XFree (pClassHint->res_class);
+		}
+		XFree (pClassHint);
+		p->cName = cairo_dock_get_xwindow_name (p->Xid, TRUE);
+		p->iNumDesktop = cairo_dock_get_xwindow_desktop (p->Xid);
+		
+		Window root_return;
+		int x_return=1, y_return=1;
+		unsigned int width_return=0, height_return=0, border_width_return, depth_return;
+		_count_x_round_trip ();
+		XGetGeometry (s_XDisplay, p->Xid, &root_return, &x_return, &y_return, &width_return, &height_return, &border_width_return, &depth_return);
+		int dest_x_return=0, dest_y_return=0;
+		Window child_return;
+		_count_x_round_trip ();
+		XTranslateCoordinates (s_XDisplay, p->Xid, DefaultRootWindow (s_XDisplay), 0, 0, &dest_x_return, &dest_y_return, &child_return);
+		pBuffer = _get_property_longs (p->Xid, s_aNetFrameExtents, XA_CARDINAL, &n);
+		_set_xwindow_geometry (p, width_return, height_return, dest_x_return, dest_y_return, pBuffer, n);
+		g_free (pBuffer);
+	}
+}
+#endif
+
 #endif
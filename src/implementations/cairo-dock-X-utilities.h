@@ -26,12 +26,17 @@
 #include <X11/Xlib.h>
 #include <glib.h>
 #include "cairo-dock-struct.h"
+#include "cairo-dock-trace.h"
 G_BEGIN_DECLS
 
 /*
 *@file cairo-dock-X-utilities.h Some utilities functions to interact very specifically on X.
 */
 
+/* Count a call that waits for the X server (a round-trip), in the trace. Put it just before each blocking call, so that the counter shows where the startup waits for X.
+ */
+#define _count_x_round_trip() gldi_trace_count ("X round-trips", 1)
+
 Display *cairo_dock_initialize_X_desktop_support (void);
 
 /* Get the X Display used by the X manager. This is useful to ignore any X error silently (without having to call gdk_error_trap_push/pop each time).
@@ -123,6 +128,27 @@ GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap);
 
 gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor);
 
+// GET THE PROPERTIES OF SEVERAL WINDOWS AT ONCE //
+typedef struct {
+	Window Xid;  // to be set before fetching the properties
+	gulong *pStates;  // _NET_WM_STATE
+	gulong iNbStates;
+	gulong *pTypes;  // _NET_WM_WINDOW_TYPE
+	gulong iNbTypes;
+	Window XTransientFor;
+	gchar *cResName;  // WM_CLASS
+	gchar *cResClass;
+	gchar *cName;  // _NET_WM_NAME, or WM_NAME
+	gint iNumDesktop;
+	gint iLocalPositionX, iLocalPositionY, iWidthExtent, iHeightExtent;  // same as cairo_dock_get_xwindow_geometry
+} CairoDockXWindowProperties;
+
+void cairo_dock_get_xwindows_properties (CairoDockXWindowProperties *pProps, guint iNbWindows);  // all the requests are sent before waiting for any reply (if XCB is available)
+void cairo_dock_free_xwindow_properties (CairoDockXWindowProperties *pProps);  // frees the content only
+gboolean cairo_dock_xwindow_properties_get_state (const CairoDockXWindowProperties *pProps, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky);
+gboolean cairo_dock_xwindow_properties_get_type (const CairoDockXWindowProperties *pProps, Window *pTransientFor);
+gchar *cairo_dock_xwindow_properties_get_class (const CairoDockXWindowProperties *pProps, gchar **cWMClass);
+
 gboolean cairo_dock_xcomposite_is_available (void);
 
 
@@ -39,6 +39,10 @@ extern GldiContainer *g_pPrimaryContainer;
 static EGLDisplay *s_eglDisplay = NULL;
 static EGLContext s_eglContext = 0;
 static EGLConfig s_eglConfig = 0;
+static gboolean s_bBufferAgeAvailable = FALSE;
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D  // EGL_EXT_buffer_age
+#endif
 
 static gboolean _check_client_egl_extension (const char *extName)
 {
@@ -133,6 +137,10 @@ static gboolean _initialize_opengl_backend (gboolean bForceOpenGL)
 		g_openglConfig.bTextureFromPixmapAvailable = (g_openglConfig.bindTexImage && g_openglConfig.releaseTexImage);
 	}
 	
+	// check whether we can know what the back buffer contains, to redraw only what has changed.
+	s_bBufferAgeAvailable = _check_client_egl_extension ("EGL_EXT_buffer_age");
+	cd_debug ("bBufferAgeAvailable: %d", s_bBufferAgeAvailable);
+	
 	return TRUE;
 }
 
@@ -153,6 +161,18 @@ static gboolean _container_make_current (GldiContainer *pContainer)
 	return eglMakeCurrent (dpy, surface, surface, pContainer->glContext);
 }
 
+static int _container_get_buffer_age (GldiContainer *pContainer)
+{
+	if (! s_bBufferAgeAvailable)
+		return 0;
+	EGLint iAge = 0;
+	EGLSurface surface = pContainer->eglSurface;
+	EGLDisplay *dpy = s_eglDisplay;
+	if (! eglQuerySurface (dpy, surface, EGL_BUFFER_AGE_EXT, &iAge))
+		return 0;
+	return iAge;
+}
+
 static void _container_end_draw (GldiContainer *pContainer)
 {
 	EGLSurface surface = pContainer->eglSurface;
@@ -222,6 +242,7 @@ void gldi_register_egl_backend (void)
 	gmb.container_end_draw = _container_end_draw;
 	gmb.container_init = _container_init;
 	gmb.container_finish = _container_finish;
+	gmb.container_get_buffer_age = _container_get_buffer_age;
 	gldi_gl_manager_register_backend (&gmb);
 }
 
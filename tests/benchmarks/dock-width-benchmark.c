@@ -0,0 +1,173 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Measure cairo_dock_calculate_max_dock_width for 10 to 500 icons, against the previous computation that simulated the wave for each icon.
+ * Usage: dock-width-benchmark
+ * Fails if the extreme positions of an icon or the width of the dock differ from the ones of the simulation.
+ */
+#include <math.h>
+
+#include "cairo-dock-icon-factory.h"
+#include "cairo-dock-icon-manager.h"  // myIconsParam
+#include "cairo-dock-dock-factory.h"
+#include "cairo-dock-dock-manager.h"  // myDocksParam
+#include "cairo-dock-dock-facility.h"
+
+#define MIN_TIME 200000  // minimum time (us) spent on each measure, to have a stable result.
+
+static GList *_make_icons (int n)
+{
+	GList *pIconList = NULL;
+	int i;
+	for (i = 0; i < n; i ++)
+	{
+		Icon *icon = g_new0 (Icon, 1);
+		icon->fWidth = (i % 10 == 9 ? 12 : 48 + (i % 3) * 4);  // mostly icons of slightly different sizes, and a few separators.
+		icon->fHeight = 48;
+		icon->fScale = 1.;
+		pIconList = g_list_append (pIconList, icon);
+	}
+	return pIconList;
+}
+
+static double _get_flat_width (GList *pIconList)
+{
+	double fFlatDockWidth = - myIconsParam.iIconGap;
+	GList *ic;
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+		fFlatDockWidth += ((Icon*)ic->data)->fWidth + myIconsParam.iIconGap;
+	return fFlatDockWidth;
+}
+
+// the computation done before, by simulating the move of the cursor over each icon.
+static double _calculate_max_dock_width_by_simulation (CairoDock *pDock, double fFlatDockWidth)
+{
+	GList *pIconList = pDock->icons;
+	GList *ic, *ic2;
+	Icon *icon;
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		icon->fXMax = -1e4;
+		icon->fXMin = 1e4;
+	}
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		cairo_dock_calculate_wave_with_position_linear (pIconList, icon->fXAtRest, pDock->fMagnitudeMax, fFlatDockWidth, 0, 0, 0.5, 0, pDock->container.bDirectionUp);
+		for (ic2 = pIconList; ic2 != NULL; ic2 = ic2->next)
+		{
+			icon = ic2->data;
+			if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax)
+				icon->fXMax = icon->fX + icon->fWidth * icon->fScale;
+			if (icon->fX < icon->fXMin)
+				icon->fXMin = icon->fX;
+		}
+	}
+	cairo_dock_calculate_wave_with_position_linear (pIconList, fFlatDockWidth - 1, pDock->fMagnitudeMax, fFlatDockWidth, 0, 0, pDock->fAlign, 0, pDock->container.bDirectionUp);
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax)
+			icon->fXMax = icon->fX + icon->fWidth * icon->fScale;
+		if (icon->fX < icon->fXMin)
+			icon->fXMin = icon->fX;
+	}
+	double fMaxDockWidth = ceil (icon->fXMax - ((Icon *) pIconList->data)->fXMin) + 1;
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		icon->fXMin += fMaxDockWidth / 2;
+		icon->fXMax += fMaxDockWidth / 2;
+		icon->fX = icon->fXAtRest;
+		icon->fScale = 1;
+	}
+	return fMaxDockWidth;
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	// the default parameters of the icons and the docks.
+	myIconsParam.iIconGap = 2;
+	myIconsParam.iSinusoidWidth = 250;
+	myIconsParam.fAmplitude = .75;
+	myDocksParam.iDockRadius = 12;
+	myDocksParam.iDockLineWidth = 1;
+	myDocksParam.iFrameMargin = 4;
+
+	int iSizes[] = {10, 20, 50, 100, 200, 500};
+	int iResult = 0;
+	guint s;
+	g_print ("%6s %14s %14s %10s\n", "icons", "linear (us)", "simulation (us)", "max diff");
+	for (s = 0; s < G_N_ELEMENTS (iSizes); s ++)
+	{
+		int n = iSizes[s];
+		CairoDock *pDock = g_new0 (CairoDock, 1);
+		pDock->icons = _make_icons (n);
+		pDock->fMagnitudeMax = 1.;
+		pDock->fAlign = .5;
+		pDock->container.bDirectionUp = TRUE;
+		double fFlatDockWidth = _get_flat_width (pDock->icons);
+		cairo_dock_calculate_icons_positions_at_rest_linear (pDock->icons, fFlatDockWidth);
+
+		// reference
+		double fRefWidth = _calculate_max_dock_width_by_simulation (pDock, fFlatDockWidth);
+		double *fRefXMin = g_new (double, 2 * n);
+		double *fRefXMax = fRefXMin + n;
+		GList *ic;
+		int i;
+		for (ic = pDock->icons, i = 0; ic != NULL; ic = ic->next, i ++)
+		{
+			fRefXMin[i] = ((Icon*)ic->data)->fXMin;
+			fRefXMax[i] = ((Icon*)ic->data)->fXMax;
+		}
+
+		// check
+		double fWidth = cairo_dock_calculate_max_dock_width (pDock, fFlatDockWidth, 1., 0.);
+		double fMaxDiff = 0.;
+		for (ic = pDock->icons, i = 0; ic != NULL; ic = ic->next, i ++)
+		{
+			fMaxDiff = MAX (fMaxDiff, fabs (((Icon*)ic->data)->fXMin - fRefXMin[i]));
+			fMaxDiff = MAX (fMaxDiff, fabs (((Icon*)ic->data)->fXMax - fRefXMax[i]));
+		}
+		if (fWidth != fRefWidth || fMaxDiff > 1e-6)
+		{
+			g_print ("%d icons: width %.2f instead of %.2f, extreme positions differ by %g\n", n, fWidth, fRefWidth, fMaxDiff);
+			iResult = 1;
+		}
+
+		// measures
+		int iNbCalls;
+		gint64 t0 = g_get_monotonic_time (), t;
+		for (iNbCalls = 0; (t = g_get_monotonic_time ()) - t0 < MIN_TIME; iNbCalls ++)
+			cairo_dock_calculate_max_dock_width (pDock, fFlatDockWidth, 1., 0.);
+		double fLinearTime = (double)(t - t0) / iNbCalls;
+		t0 = g_get_monotonic_time ();
+		for (iNbCalls = 0; (t = g_get_monotonic_time ()) - t0 < MIN_TIME; iNbCalls ++)
+			_calculate_max_dock_width_by_simulation (pDock, fFlatDockWidth);
+		double fSimulationTime = (double)(t - t0) / iNbCalls;
+		g_print ("%6d %14.2f %14.2f %10.2g\n", n, fLinearTime, fSimulationTime, fMaxDiff);
+
+		cairo_dock_free_icons_layout (pDock);
+		g_list_free_full (pDock->icons, g_free);
+		g_free (fRefXMin);
+		g_free (pDock);
+	}
+	return iResult;
+}
@@ -0,0 +1,184 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Check the launching of commands, and measure its latency against the former way (a thread calling system() on "cd dir && command &").
+ * Usage: launch-benchmark [nb launches]
+ * First checks that the commands are run in their directory, with their quoted arguments, through a shell only when needed, and that the callback gets their exit status;
+ * then measures the time spent in the caller, and the time until the launched program has actually run (it creates a file).
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-utils.h"
+
+#define MAX_WAIT 5000000  // us
+
+static int s_iNbExits = 0;
+static int s_iLastStatus = -1;
+
+static void _on_exit (G_GNUC_UNUSED GPid pid, gint iStatus, G_GNUC_UNUSED gpointer data)
+{
+	s_iNbExits ++;
+	s_iLastStatus = iStatus;
+}
+
+// run the main loop until the launched processes are reaped, or the file exists if given.
+static gboolean _wait_for (int iNbExits, const gchar *cFilePath)
+{
+	gint64 t0 = g_get_monotonic_time ();
+	while (cFilePath ? ! g_file_test (cFilePath, G_FILE_TEST_EXISTS) : s_iNbExits < iNbExits)
+	{
+		if (g_get_monotonic_time () - t0 > MAX_WAIT)
+			return FALSE;
+		if (! g_main_context_iteration (NULL, FALSE))
+			g_usleep (20);
+	}
+	return TRUE;
+}
+
+static gboolean _check (gboolean bCondition, const gchar *cMessage)
+{
+	if (! bCondition)
+		g_print ("%s\n", cMessage);
+	return bCondition;
+}
+
+static gboolean _check_launches (const gchar *cDir)
+{
+	gboolean bOk = TRUE;
+	CairoDockLaunchStats stats0, stats;
+	cairo_dock_get_launch_stats (&stats0);
+	gchar *cFile = g_build_filename (cDir, "a file", NULL);
+
+	// a simple command with a quoted argument, in a given directory: no shell.
+	int n = s_iNbExits;
+	bOk &= _check (cairo_dock_launch_command_full_with_callback ("touch \"a file\" &", cDir, _on_exit, NULL), "the command couldn't be launched");
+	bOk &= _check (_wait_for (n + 1, NULL), "the callback wasn't called");
+	bOk &= _check (s_iLastStatus == 0, "the command failed");
+	bOk &= _check (g_file_test (cFile, G_FILE_TEST_EXISTS), "the command didn't run in its directory with its argument");
+	cairo_dock_get_launch_stats (&stats);
+	bOk &= _check (stats.iNbShellLaunches == stats0.iNbShellLaunches, "a shell was used for a simple command");
+	g_remove (cFile);
+
+	// a redirection needs a shell.
+	n = s_iNbExits;
+	bOk &= _check (cairo_dock_launch_command_full_with_callback ("echo ok > \"a file\"", cDir, _on_exit, NULL), "the command with a redirection couldn't be launched");
+	bOk &= _check (_wait_for (n + 1, NULL), "the callback wasn't called");
+	bOk &= _check (g_file_test (cFile, G_FILE_TEST_EXISTS), "the redirection wasn't done");
+	cairo_dock_get_launch_stats (&stats);
+	bOk &= _check (stats.iNbShellLaunches == stats0.iNbShellLaunches + 1, "no shell was used for a redirection");
+	g_remove (cFile);
+
+	// the exit status is given to the callback.
+	n = s_iNbExits;
+	bOk &= _check (cairo_dock_launch_command_full_with_callback ("false", NULL, _on_exit, NULL), "'false' couldn't be launched");
+	bOk &= _check (_wait_for (n + 1, NULL), "the callback wasn't called");
+	bOk &= _check (s_iLastStatus != 0, "the failure of the command wasn't reported");
+
+	// a missing program fails at once, without calling the callback.
+	n = s_iNbExits;
+	bOk &= _check (! cairo_dock_launch_command_full_with_callback ("no-such-program-for-cairo-dock", NULL, _on_exit, NULL), "a missing program was launched");
+	cairo_dock_get_launch_stats (&stats);
+	bOk &= _check (stats.iNbFailures == stats0.iNbFailures + 1, "the failure wasn't counted");
+	bOk &= _check (s_iNbExits == n, "the callback was called for a missing program");
+
+	g_free (cFile);
+	return bOk;
+}
+
+// the former way.
+static gpointer _launch_threaded (gchar *cCommand)
+{
+	int r = system (cCommand);
+	if (r != 0)
+		cd_warning ("couldn't launch this command (%s)", cCommand);
+	g_free (cCommand);
+	return NULL;
+}
+
+static void _launch_with_thread_and_shell (const gchar *cCommand, const gchar *cWorkingDirectory)
+{
+	gchar *cCommandFull = g_strdup_printf ("cd \"%s\" && %s &", cWorkingDirectory, cCommand);
+	GThread *pThread = g_thread_new ("launch", (GThreadFunc) _launch_threaded, cCommandFull);
+	g_thread_unref (pThread);
+}
+
+int main (int argc, char **argv)
+{
+	int iNbLaunches = (argc > 1 ? atoi (argv[1]) : 50);
+	cd_log_init (FALSE);
+	cd_log_set_level (G_LOG_LEVEL_WARNING);
+	gchar *cDir = g_dir_make_tmp ("launch-benchmark-XXXXXX", NULL);
+	g_return_val_if_fail (cDir != NULL, 1);
+	gchar *cFile = g_build_filename (cDir, "launched", NULL);
+
+	int iResult = 0;
+	if (! _check_launches (cDir))
+		iResult = 1;
+
+	// measures
+	double fCallTime = 0, fRunTime = 0, fFormerCallTime = 0, fFormerRunTime = 0;
+	gint64 t0, t1;
+	int i, n = s_iNbExits;
+	for (i = 0; i < iNbLaunches; i ++)
+	{
+		t0 = g_get_monotonic_time ();
+		cairo_dock_launch_command_full_with_callback ("touch launched", cDir, _on_exit, NULL);
+		t1 = g_get_monotonic_time ();
+		if (! _wait_for (0, cFile))
+		{
+			g_print ("the command didn't run\n");
+			iResult = 1;
+			break;
+		}
+		fCallTime += t1 - t0;
+		fRunTime += g_get_monotonic_time () - t0;
+		g_remove (cFile);
+	}
+	_wait_for (n + i, NULL);  // reap the processes.
+
+	for (i = 0; i < iNbLaunches; i ++)
+	{
+		t0 = g_get_monotonic_time ();
+		_launch_with_thread_and_shell ("touch launched", cDir);
+		t1 = g_get_monotonic_time ();
+		if (! _wait_for (0, cFile))
+		{
+			g_print ("the former command didn't run\n");
+			iResult = 1;
+			break;
+		}
+		fFormerCallTime += t1 - t0;
+		fFormerRunTime += g_get_monotonic_time () - t0;
+		g_remove (cFile);
+	}
+	if (iNbLaunches > 0)
+	{
+		g_print ("%10s %14s %14s\n", "", "caller (ms)", "run (ms)");
+		g_print ("%10s %14.3f %14.3f\n", "spawn", fCallTime / iNbLaunches / 1000., fRunTime / iNbLaunches / 1000.);
+		g_print ("%10s %14.3f %14.3f\n", "former", fFormerCallTime / iNbLaunches / 1000., fFormerRunTime / iNbLaunches / 1000.);
+	}
+
+	g_rmdir (cDir);
+	g_free (cFile);
+	g_free (cDir);
+	return iResult;
+}
@@ -0,0 +1,166 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Measure the update of a particle system of 1k to 50k particles, against the former update (in double, with sin()).
+ * Usage: particles-benchmark
+ * Both updates are run on the same particles, with the same rewinds, for STEPS steps; fails if the particles drift apart by more than the error of the fast sine.
+ * The drawing needs an OpenGL context, so it's not measured here; cairo_dock_get_particles_stats() gives its cost in the dock.
+ */
+#include <math.h>
+#include <string.h>
+
+#include "cairo-dock-struct.h"  // GL types
+#include "cairo-dock-particle-system.h"
+
+#define MIN_TIME 200000  // minimum time (us) spent on each measure, to have a stable result.
+#define STEPS 200  // steps of the check, more than a life, so that all the particles are rewound at least once.
+#define MAX_X_DIFF 5e-3  // the oscillation is at most 2% of the width, and the fast sine is within 0.0011, so the error stays far below this over a life.
+#define MAX_DIFF 1e-5  // the other values only differ by the float computation.
+
+static GRand *s_pRand = NULL;
+
+// like the plug-ins do: a new particle at the bottom, going up with a random speed and oscillation.
+static void _rewind_particle (CairoParticle *p, double dt)
+{
+	p->x = 2 * g_rand_double (s_pRand) - 1;
+	p->y = 0;
+	p->z = 2 * g_rand_double (s_pRand) - 1;
+	p->vx = 0;
+	p->vy = (.5 + g_rand_double (s_pRand)) * dt / 1000.;
+	p->fWidth = p->fHeight = 8;
+	p->color[0] = g_rand_double (s_pRand);
+	p->color[1] = g_rand_double (s_pRand);
+	p->color[2] = g_rand_double (s_pRand);
+	p->color[3] = 1.;
+	p->fOscillation = G_PI * g_rand_double (s_pRand);
+	p->fOmega = 2 * G_PI / (20 + g_rand_int_range (s_pRand, 0, 20));
+	p->fSizeFactor = 1.;
+	p->fResizeSpeed = -.5 / 100;
+	p->iInitialLife = p->iLife = g_rand_int_range (s_pRand, 50, 150);
+}
+
+// the former update.
+static gboolean _update_with_doubles (CairoParticleSystem *pParticleSystem, CairoDockRewindParticleFunc pRewindParticle)
+{
+	gboolean bAllParticlesEnded = TRUE;
+	CairoParticle *p;
+	int i;
+	for (i = 0; i < pParticleSystem->iNbParticles; i ++)
+	{
+		p = &(pParticleSystem->pParticles[i]);
+
+		p->fOscillation += p->fOmega;
+		p->x += p->vx + (p->z + 2)/3. * .02 * sin (p->fOscillation);  // 3%
+		p->y += p->vy;
+		p->color[3] = 1.*p->iLife / p->iInitialLife;
+		p->fSizeFactor += p->fResizeSpeed;
+		if (p->iLife > 0)
+		{
+			p->iLife --;
+			if (pRewindParticle && p->iLife == 0)
+			{
+				pRewindParticle (p, pParticleSystem->dt);
+			}
+			if (bAllParticlesEnded && p->iLife != 0)
+				bAllParticlesEnded = FALSE;
+		}
+		else if (pRewindParticle)
+			pRewindParticle (p, pParticleSystem->dt);
+	}
+	return ! bAllParticlesEnded;
+}
+
+static CairoParticleSystem *_make_particle_system (int n)
+{
+	CairoParticleSystem *pParticleSystem = cairo_dock_create_particle_system (n, 0, 48, 96);
+	pParticleSystem->dt = 25;
+	g_rand_set_seed (s_pRand, n);
+	int i;
+	for (i = 0; i < n; i ++)
+		_rewind_particle (&pParticleSystem->pParticles[i], pParticleSystem->dt);
+	return pParticleSystem;
+}
+
+static gboolean _check_update (int n)
+{
+	CairoParticleSystem *pRefSystem = _make_particle_system (n);
+	CairoParticleSystem *pParticleSystem = _make_particle_system (n);
+	double fMaxXDiff = 0., fMaxDiff = 0.;
+	int iNbLifeErrors = 0;
+	int s, i;
+	for (s = 0; s < STEPS; s ++)
+	{
+		// both updates rewind the same particles at the same step, so they must get the same random values.
+		g_rand_set_seed (s_pRand, s);
+		_update_with_doubles (pRefSystem, _rewind_particle);
+		g_rand_set_seed (s_pRand, s);
+		cairo_dock_update_default_particle_system (pParticleSystem, _rewind_particle);
+
+		for (i = 0; i < n; i ++)
+		{
+			CairoParticle *p = &pParticleSystem->pParticles[i], *q = &pRefSystem->pParticles[i];
+			if (p->iLife != q->iLife)
+				iNbLifeErrors ++;
+			fMaxXDiff = MAX (fMaxXDiff, fabs (p->x - q->x));
+			fMaxDiff = MAX (fMaxDiff, fabs (p->y - q->y));
+			fMaxDiff = MAX (fMaxDiff, fabs (p->color[3] - q->color[3]));
+			fMaxDiff = MAX (fMaxDiff, fabs (p->fSizeFactor - q->fSizeFactor));
+		}
+	}
+	cairo_dock_free_particle_system (pParticleSystem);
+	cairo_dock_free_particle_system (pRefSystem);
+	if (iNbLifeErrors != 0 || fMaxXDiff > MAX_X_DIFF || fMaxDiff > MAX_DIFF)
+	{
+		g_print ("%d particles: %d lives differ, the positions differ by %g, the other values by %g\n", n, iNbLifeErrors, fMaxXDiff, fMaxDiff);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	s_pRand = g_rand_new ();
+	int iSizes[] = {1000, 10000, 50000};
+	int iResult = 0;
+	guint s;
+	g_print ("%10s %14s %14s\n", "particles", "update (ms)", "former (ms)");
+	for (s = 0; s < G_N_ELEMENTS (iSizes); s ++)
+	{
+		int n = iSizes[s];
+		if (! _check_update (n))
+			iResult = 1;
+
+		// measures; the particles are rewound as in the dock, so that the update does the same work at each frame.
+		CairoParticleSystem *pParticleSystem = _make_particle_system (n);
+		int iNbCalls;
+		gint64 t0 = g_get_monotonic_time (), t;
+		for (iNbCalls = 0; (t = g_get_monotonic_time ()) - t0 < MIN_TIME; iNbCalls ++)
+			cairo_dock_update_default_particle_system (pParticleSystem, _rewind_particle);
+		double fUpdateTime = (double)(t - t0) / iNbCalls / 1000.;
+		t0 = g_get_monotonic_time ();
+		for (iNbCalls = 0; (t = g_get_monotonic_time ()) - t0 < MIN_TIME; iNbCalls ++)
+			_update_with_doubles (pParticleSystem, _rewind_particle);
+		double fFormerTime = (double)(t - t0) / iNbCalls / 1000.;
+		g_print ("%10d %14.3f %14.3f\n", n, fUpdateTime, fFormerTime);
+
+		cairo_dock_free_particle_system (pParticleSystem);
+	}
+	g_rand_free (s_pRand);
+	return iResult;
+}
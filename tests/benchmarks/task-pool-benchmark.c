@@ -0,0 +1,177 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Stress the pool of workers of the Tasks.
+ * Usage: task-pool-benchmark [nb tasks] [nb blocking tasks] [duration in s]
+ * Runs many periodic Tasks (1s period) with a short 'get_data', plus a few ones that block for 2s like a download,
+ * and reports the number of threads, the RSS, and the spread between the scheduled and the actual start of the short 'get_data'.
+ * Fails if a short Task is delayed by the blocking ones for more than a period, once they are known to block (their first iteration goes in the same pool as the other Tasks).
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-task.h"
+
+#define PERIOD 1  // s
+#define SHORT_JOB_TIME 1000  // us
+#define BLOCKING_JOB_TIME 2000000  // us
+
+typedef struct {
+	gboolean bBlocking;
+	gint64 iLastStart;  // us
+	GArray *pDelays;  // actual - scheduled start, in us
+} TaskData;
+
+static GMainLoop *s_pLoop = NULL;
+static gint64 s_iMeasureStart = 0;  // us
+static guint s_iMaxThreads = 0;
+static gulong s_iMaxRss = 0;  // kB
+
+static guint _count_threads (void)
+{
+	GDir *dir = g_dir_open ("/proc/self/task", 0, NULL);
+	if (dir == NULL)
+		return 0;
+	guint n = 0;
+	while (g_dir_read_name (dir) != NULL)
+		n ++;
+	g_dir_close (dir);
+	return n;
+}
+
+static gulong _get_rss (void)
+{
+	gchar *cContent = NULL;
+	if (! g_file_get_contents ("/proc/self/status", &cContent, NULL, NULL))
+		return 0;
+	gulong iRss = 0;
+	gchar *str = strstr (cContent, "VmRSS:");
+	if (str)
+		iRss = strtoul (str + 6, NULL, 10);
+	g_free (cContent);
+	return iRss;
+}
+
+static gboolean _sample (G_GNUC_UNUSED gpointer data)
+{
+	s_iMaxThreads = MAX (s_iMaxThreads, _count_threads ());
+	s_iMaxRss = MAX (s_iMaxRss, _get_rss ());
+	return TRUE;
+}
+
+static void _get_data (TaskData *pData)
+{
+	gint64 t = g_get_monotonic_time ();
+	if (pData->iLastStart > s_iMeasureStart && ! pData->bBlocking)
+	{
+		gint64 iDelay = t - pData->iLastStart - PERIOD * G_USEC_PER_SEC;  // the next iteration is scheduled one period after the previous one.
+		g_array_append_val (pData->pDelays, iDelay);
+	}
+	pData->iLastStart = t;
+	g_usleep (pData->bBlocking ? BLOCKING_JOB_TIME : SHORT_JOB_TIME);
+}
+
+static gboolean _update (G_GNUC_UNUSED TaskData *pData)
+{
+	return TRUE;
+}
+
+static gboolean _quit (G_GNUC_UNUSED gpointer data)
+{
+	g_main_loop_quit (s_pLoop);
+	return FALSE;
+}
+
+static int _compare_delays (const gint64 *a, const gint64 *b)
+{
+	return (*a < *b ? -1 : *a > *b ? 1 : 0);
+}
+
+int main (int argc, char **argv)
+{
+	int iNbTasks = (argc > 1 ? atoi (argv[1]) : 300);
+	int iNbBlockingTasks = (argc > 2 ? atoi (argv[2]) : 16);
+	int iDuration = (argc > 3 ? atoi (argv[3]) : 15);
+	cd_log_init (FALSE);
+	cd_log_set_level (G_LOG_LEVEL_WARNING);
+
+	guint iInitialThreads = _count_threads ();
+	gulong iInitialRss = _get_rss ();
+
+	GldiTask **pTasks = g_new0 (GldiTask*, iNbTasks + iNbBlockingTasks);
+	TaskData *pDatas = g_new0 (TaskData, iNbTasks + iNbBlockingTasks);
+	int i;
+	for (i = 0; i < iNbTasks + iNbBlockingTasks; i ++)
+	{
+		pDatas[i].bBlocking = (i >= iNbTasks);
+		pDatas[i].pDelays = g_array_new (FALSE, FALSE, sizeof (gint64));
+		pTasks[i] = gldi_task_new_full (PERIOD, (GldiGetDataAsyncFunc) _get_data, (GldiUpdateSyncFunc) _update, NULL, &pDatas[i]);
+	}
+	s_iMeasureStart = g_get_monotonic_time () + (iNbBlockingTasks / 8 + 1) * BLOCKING_JOB_TIME;  // wait until the first iteration of each blocking task is over.
+	for (i = 0; i < iNbTasks + iNbBlockingTasks; i ++)
+		gldi_task_launch (pTasks[i]);
+
+	s_pLoop = g_main_loop_new (NULL, FALSE);
+	g_timeout_add (100, _sample, NULL);
+	g_timeout_add_seconds (iDuration, _quit, NULL);
+	g_main_loop_run (s_pLoop);
+
+	for (i = 0; i < iNbTasks + iNbBlockingTasks; i ++)
+		gldi_task_free (pTasks[i]);  // waits for the blocking ones.
+
+	GArray *pAllDelays = g_array_new (FALSE, FALSE, sizeof (gint64));
+	for (i = 0; i < iNbTasks; i ++)
+	{
+		g_array_append_vals (pAllDelays, pDatas[i].pDelays->data, pDatas[i].pDelays->len);
+		g_array_free (pDatas[i].pDelays, TRUE);
+	}
+	g_array_sort (pAllDelays, (GCompareFunc) _compare_delays);
+
+	GldiTaskStats stats;
+	gldi_task_get_stats (&stats);
+	g_print ("%d tasks + %d blocking ones during %ds\n", iNbTasks, iNbBlockingTasks, iDuration);
+	g_print ("threads: %u at start, %u at most\n", iInitialThreads, s_iMaxThreads);
+	g_print ("RSS: %lu kB at start, %lu kB at most\n", iInitialRss, s_iMaxRss);
+	g_print ("iterations: %u, main loop wakeups: %u\n", stats.iNbIterations, stats.iNbWakeups);
+	int iResult = 0;
+	if (pAllDelays->len != 0)
+	{
+		gint64 *d = (gint64*) pAllDelays->data;
+		guint n = pAllDelays->len;
+		g_print ("start delay of the short tasks (ms): min %.2f, median %.2f, p99 %.2f, max %.2f (%u iterations)\n",
+			d[0] / 1000., d[n/2] / 1000., d[MIN (n-1, n*99/100)] / 1000., d[n-1] / 1000., n);
+		if (d[n-1] > PERIOD * G_USEC_PER_SEC)
+		{
+			g_print ("the short tasks have been delayed by the blocking ones\n");
+			iResult = 1;
+		}
+	}
+	else
+	{
+		g_print ("no iteration\n");
+		iResult = 1;
+	}
+
+	g_array_free (pAllDelays, TRUE);
+	g_free (pDatas);
+	g_free (pTasks);
+	g_main_loop_unref (s_pLoop);
+	return iResult;
+}
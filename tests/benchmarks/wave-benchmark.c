@@ -0,0 +1,155 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Measure the wave effect computed on each motion of the pointer over a dock of 20 to 500 icons.
+ * Usage: wave-benchmark
+ * The pointer is moved over the whole width of the dock; cairo_dock_apply_wave_effect_linear (on the packed layout of the dock) is timed against cairo_dock_calculate_wave_with_position_linear (on the list of icons).
+ * Fails if they don't give the same pointed icon, or if the scale or the position of an icon differ.
+ */
+#include <math.h>
+
+#include "cairo-dock-struct.h"  // CAIRO_DOCK_NB_MAX_ITERATIONS
+#include "cairo-dock-icon-factory.h"
+#include "cairo-dock-icon-manager.h"  // myIconsParam
+#include "cairo-dock-dock-factory.h"
+#include "cairo-dock-dock-manager.h"  // myDocksParam
+#include "cairo-dock-dock-facility.h"
+#include "cairo-dock-animations.h"  // cairo_dock_calculate_magnitude
+
+#define MIN_TIME 200000  // minimum time (us) spent on each measure, to have a stable result.
+#define MAX_SCALE_DIFF 1e-6  // the sin is approximated on the packed layout.
+#define MAX_POSITION_DIFF 1e-2  // px
+
+static CairoDock *_make_dock (int n)
+{
+	CairoDock *pDock = g_new0 (CairoDock, 1);
+	int i;
+	for (i = 0; i < n; i ++)
+	{
+		Icon *icon = g_new0 (Icon, 1);
+		icon->fWidth = (i % 10 == 9 ? 12 : 48 + (i % 3) * 4);  // mostly icons of slightly different sizes, and a few separators.
+		icon->fHeight = 48;
+		icon->fScale = 1.;
+		pDock->icons = g_list_append (pDock->icons, icon);
+	}
+	pDock->fMagnitudeMax = 1.;
+	pDock->iMagnitudeIndex = CAIRO_DOCK_NB_MAX_ITERATIONS;
+	pDock->fAlign = .5;
+	pDock->container.bDirectionUp = TRUE;
+
+	// same as the default view.
+	pDock->fFlatDockWidth = - myIconsParam.iIconGap;
+	GList *ic;
+	for (ic = pDock->icons; ic != NULL; ic = ic->next)
+		pDock->fFlatDockWidth += ((Icon*)ic->data)->fWidth + myIconsParam.iIconGap;
+	cairo_dock_calculate_icons_positions_at_rest_linear (pDock->icons, pDock->fFlatDockWidth);
+	pDock->container.iWidth = pDock->iActiveWidth = cairo_dock_calculate_max_dock_width (pDock, pDock->fFlatDockWidth, 1., 0.);
+	pDock->container.iHeight = 2 * 48 + myDocksParam.iDockLineWidth + myDocksParam.iFrameMargin;
+	return pDock;
+}
+
+static Icon *_calculate_wave_on_list (CairoDock *pDock)
+{
+	double offset = (pDock->container.iWidth - pDock->iActiveWidth) * pDock->fAlign + (pDock->iActiveWidth - pDock->fFlatDockWidth) / 2;
+	int x_abs = pDock->container.iMouseX - offset;
+	double fMagnitude = cairo_dock_calculate_magnitude (pDock->iMagnitudeIndex);
+	return cairo_dock_calculate_wave_with_position_linear (pDock->icons, x_abs, fMagnitude, pDock->fFlatDockWidth, pDock->container.iWidth, pDock->container.iHeight, pDock->fAlign, pDock->fFoldingFactor, pDock->container.bDirectionUp);
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	// the default parameters of the icons and the docks.
+	myIconsParam.iIconGap = 2;
+	myIconsParam.iSinusoidWidth = 250;
+	myIconsParam.fAmplitude = .75;
+	myDocksParam.iDockRadius = 12;
+	myDocksParam.iDockLineWidth = 1;
+	myDocksParam.iFrameMargin = 4;
+
+	int iSizes[] = {20, 50, 100, 200, 500};
+	int iResult = 0;
+	guint s;
+	g_print ("%6s %14s %14s %12s %12s\n", "icons", "layout (us)", "list (us)", "scale diff", "x/y diff");
+	for (s = 0; s < G_N_ELEMENTS (iSizes); s ++)
+	{
+		int n = iSizes[s];
+		CairoDock *pDock = _make_dock (n);
+		double *fRef = g_new (double, 3 * n);
+		GList *ic;
+		Icon *icon;
+		int i, x;
+
+		// check over the whole width of the dock.
+		double fMaxScaleDiff = 0., fMaxPositionDiff = 0.;
+		for (x = 0; x < pDock->container.iWidth; x ++)
+		{
+			pDock->container.iMouseX = x;
+			Icon *pRefPointedIcon = _calculate_wave_on_list (pDock);
+			for (ic = pDock->icons, i = 0; ic != NULL; ic = ic->next, i ++)
+			{
+				icon = ic->data;
+				fRef[3*i] = icon->fScale;
+				fRef[3*i+1] = icon->fX;
+				fRef[3*i+2] = icon->fY;
+			}
+			Icon *pPointedIcon = cairo_dock_apply_wave_effect_linear (pDock);
+			if (pPointedIcon != pRefPointedIcon)
+			{
+				g_print ("%d icons, x=%d: the pointed icon differs\n", n, x);
+				iResult = 1;
+			}
+			for (ic = pDock->icons, i = 0; ic != NULL; ic = ic->next, i ++)
+			{
+				icon = ic->data;
+				fMaxScaleDiff = MAX (fMaxScaleDiff, fabs (icon->fScale - fRef[3*i]));
+				fMaxPositionDiff = MAX (fMaxPositionDiff, fabs (icon->fX - fRef[3*i+1]));
+				fMaxPositionDiff = MAX (fMaxPositionDiff, fabs (icon->fY - fRef[3*i+2]));
+			}
+		}
+		if (fMaxScaleDiff > MAX_SCALE_DIFF || fMaxPositionDiff > MAX_POSITION_DIFF)
+		{
+			g_print ("%d icons: the scales differ by %g, the positions by %g px\n", n, fMaxScaleDiff, fMaxPositionDiff);
+			iResult = 1;
+		}
+
+		// measures; the pointer goes back and forth over the dock, as on a motion event.
+		int iNbCalls;
+		gint64 t0 = g_get_monotonic_time (), t;
+		for (iNbCalls = 0; (t = g_get_monotonic_time ()) - t0 < MIN_TIME; iNbCalls ++)
+		{
+			pDock->container.iMouseX = (iNbCalls * 7) % pDock->container.iWidth;
+			cairo_dock_apply_wave_effect_linear (pDock);
+		}
+		double fLayoutTime = (double)(t - t0) / iNbCalls;
+		t0 = g_get_monotonic_time ();
+		for (iNbCalls = 0; (t = g_get_monotonic_time ()) - t0 < MIN_TIME; iNbCalls ++)
+		{
+			pDock->container.iMouseX = (iNbCalls * 7) % pDock->container.iWidth;
+			_calculate_wave_on_list (pDock);
+		}
+		double fListTime = (double)(t - t0) / iNbCalls;
+		g_print ("%6d %14.2f %14.2f %12.2g %12.2g\n", n, fLayoutTime, fListTime, fMaxScaleDiff, fMaxPositionDiff);
+
+		cairo_dock_free_icons_layout (pDock);
+		g_list_free_full (pDock->icons, g_free);
+		g_free (fRef);
+		g_free (pDock);
+	}
+	return iResult;
+}
@@ -0,0 +1,138 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Measure the time to get the properties of many new windows, as when the dock starts with a restored session.
+ * Usage: x-properties-benchmark [nb windows]
+ * Needs an X server; to run it on a headless machine: xvfb-run ./x-properties-benchmark 200
+ * Creates the windows, then gets their properties one window after the other (as for a single new window) and all at once with cairo_dock_get_xwindows_properties.
+ * Fails if both ways don't give the same properties.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-X-utilities.h"
+
+static Window *_create_windows (Display *dpy, int n)
+{
+	Window root = DefaultRootWindow (dpy);
+	Atom aNetWmWindowType = XInternAtom (dpy, "_NET_WM_WINDOW_TYPE", False);
+	Atom aNetWmWindowTypeNormal = XInternAtom (dpy, "_NET_WM_WINDOW_TYPE_NORMAL", False);
+	Window *pWindows = g_new (Window, n);
+	XClassHint *pClassHint = XAllocClassHint ();
+	gchar *cName;
+	int i;
+	for (i = 0; i < n; i ++)
+	{
+		pWindows[i] = XCreateSimpleWindow (dpy, root, 10 * (i % 50), 10 * (i % 30), 200 + i % 7, 100 + i % 5, 0, 0, 0);
+		cName = g_strdup_printf ("window %d", i);
+		XStoreName (dpy, pWindows[i], cName);
+		pClassHint->res_name = cName;
+		pClassHint->res_class = (char*)(i % 2 ? "Benchmark" : "Other-benchmark");
+		XSetClassHint (dpy, pWindows[i], pClassHint);
+		XChangeProperty (dpy, pWindows[i], aNetWmWindowType, XA_ATOM, 32, PropModeReplace, (guchar*)&aNetWmWindowTypeNormal, 1);
+		g_free (cName);
+	}
+	XFree (pClassHint);
+	XSync (dpy, False);
+	return pWindows;
+}
+
+// what is done for each new window, when it appears alone.
+static void _get_xwindow_properties_one_by_one (Window Xid, CairoDockXWindowProperties *p)
+{
+	gboolean bIsFullScreen, bIsHidden, bIsMaximized, bDemandsAttention, bIsSticky;
+	p->Xid = Xid;
+	cairo_dock_get_xwindow_type (Xid, &p->XTransientFor);
+	cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Xid, &bIsFullScreen, &bIsHidden, &bIsMaximized, &bDemandsAttention, &bIsSticky);
+	p->cResClass = cairo_dock_get_xwindow_class (Xid, &p->cResName);
+	p->cName = cairo_dock_get_xwindow_name (Xid, TRUE);
+	p->iNumDesktop = cairo_dock_get_xwindow_desktop (Xid);
+	p->iWidthExtent = p->iHeightExtent = 0;
+	cairo_dock_get_xwindow_geometry (Xid, &p->iLocalPositionX, &p->iLocalPositionY, &p->iWidthExtent, &p->iHeightExtent);
+}
+
+int main (int argc, char **argv)
+{
+	int n = (argc > 1 ? atoi (argv[1]) : 200);
+	cd_log_init (FALSE);
+	cd_log_set_level (G_LOG_LEVEL_WARNING);
+	if (g_getenv ("DISPLAY") == NULL)
+	{
+		g_print ("no X display, run it with xvfb-run\n");
+		return 1;
+	}
+	Display *dpy = cairo_dock_initialize_X_desktop_support ();
+	if (dpy == NULL)
+		return 1;
+	Window *pWindows = _create_windows (dpy, n);
+	CairoDockXWindowProperties *pRefProps = g_new0 (CairoDockXWindowProperties, n);
+	CairoDockXWindowProperties *pProps = g_new0 (CairoDockXWindowProperties, n);
+	int i;
+
+	gint64 t0 = g_get_monotonic_time ();
+	for (i = 0; i < n; i ++)
+		_get_xwindow_properties_one_by_one (pWindows[i], &pRefProps[i]);
+	gint64 t1 = g_get_monotonic_time ();
+	for (i = 0; i < n; i ++)
+		pProps[i].Xid = pWindows[i];
+	cairo_dock_get_xwindows_properties (pProps, n);
+	gint64 t2 = g_get_monotonic_time ();
+
+	int iResult = 0;
+	for (i = 0; i < n; i ++)
+	{
+		CairoDockXWindowProperties *p = &pProps[i], *q = &pRefProps[i];
+		gchar *cResName = NULL;
+		gchar *cResClass = cairo_dock_xwindow_properties_get_class (p, &cResName);
+		Window XTransientFor = None;
+		cairo_dock_xwindow_properties_get_type (p, &XTransientFor);
+		if (g_strcmp0 (cResClass, q->cResClass) != 0
+		|| g_strcmp0 (cResName, q->cResName) != 0
+		|| g_strcmp0 (p->cName, q->cName) != 0
+		|| XTransientFor != q->XTransientFor
+		|| p->iNumDesktop != q->iNumDesktop
+		|| p->iLocalPositionX != q->iLocalPositionX || p->iLocalPositionY != q->iLocalPositionY
+		|| p->iWidthExtent != q->iWidthExtent || p->iHeightExtent != q->iHeightExtent)
+		{
+			g_print ("the properties of the window %d differ ('%s'/'%s' instead of '%s'/'%s', %dx%d instead of %dx%d)\n", i,
+				cResClass, p->cName, q->cResClass, q->cName,
+				p->iWidthExtent, p->iHeightExtent, q->iWidthExtent, q->iHeightExtent);
+			iResult = 1;
+		}
+		g_free (cResClass);
+		g_free (cResName);
+		cairo_dock_free_xwindow_properties (p);
+		g_free (q->cResClass);
+		g_free (q->cResName);
+		g_free (q->cName);
+	}
+	g_print ("%d windows: one by one %.2f ms, all at once %.2f ms\n", n, (t1 - t0) / 1000., (t2 - t1) / 1000.);
+
+	for (i = 0; i < n; i ++)
+		XDestroyWindow (dpy, pWindows[i]);
+	XSync (dpy, False);
+	g_free (pWindows);
+	g_free (pProps);
+	g_free (pRefProps);
+	return iResult;
+}
@@ -0,0 +1,148 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Check and measure the loading of the icons that the applications give to X (_NET_WM_ICON).
+ * Usage: xicon-benchmark
+ * First checks that the premultiplication gives the same pixels as the former float computation, for all the alpha and color values;
+ * then measures cairo_dock_create_surface_from_xicon_buffer for icons of 16 to 512 pixels loaded at 48 pixels, against the former float premultiplication alone.
+ */
+#include <string.h>
+
+#include "cairo-dock-surface-factory.h"
+
+#define MIN_TIME 200000  // minimum time (us) spent on each measure, to have a stable result.
+
+// the former premultiplication.
+static void _premultiply_with_floats (const gulong *pXPixels, guint32 *pPixels, int n)
+{
+	int i;
+	gint pixel, alpha, red, green, blue;
+	float fAlphaFactor;
+	for (i = 0; i < n; i ++)
+	{
+		pixel = (gint) pXPixels[i];
+		alpha = (pixel & 0xFF000000) >> 24;
+		red   = (pixel & 0x00FF0000) >> 16;
+		green = (pixel & 0x0000FF00) >> 8;
+		blue  = (pixel & 0x000000FF);
+		fAlphaFactor = (float) alpha / 255;
+		red *= fAlphaFactor;
+		green *= fAlphaFactor;
+		blue *= fAlphaFactor;
+		pPixels[i] = (pixel & 0xFF000000) + (red << 16) + (green << 8) + blue;
+	}
+}
+
+// a buffer as given by X: width, height, then the ARGB pixels (not premultiplied), each in a long.
+static gulong *_make_xicon_buffer (int w, int h, int *iNbElements)
+{
+	*iNbElements = 2 + w * h;
+	gulong *pBuffer = g_new (gulong, *iNbElements);
+	pBuffer[0] = w;
+	pBuffer[1] = h;
+	int x, y;
+	guint32 alpha, c;
+	for (y = 0; y < h; y ++)
+	{
+		for (x = 0; x < w; x ++)
+		{
+			alpha = x * 256 / w;
+			c = y * 256 / h;
+			pBuffer[2 + y * w + x] = (alpha << 24) | (c << 16) | ((255 - c) << 8) | ((c * 7) & 0xFF);
+		}
+	}
+	return pBuffer;
+}
+
+// with an icon of the requested size, there is no scale, so the surface holds exactly the premultiplied pixels.
+static gboolean _check_premultiplication (void)
+{
+	int iNbElements;
+	gulong *pBuffer = _make_xicon_buffer (256, 256, &iNbElements);  // each alpha value with each value of each color.
+	guint32 *pRef = g_new (guint32, 256 * 256);
+	_premultiply_with_floats (pBuffer + 2, pRef, 256 * 256);
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_xicon_buffer (pBuffer, iNbElements, 256, 256);
+	g_return_val_if_fail (pSurface != NULL, FALSE);
+	cairo_surface_flush (pSurface);
+	const guchar *pData = cairo_image_surface_get_data (pSurface);
+	int iStride = cairo_image_surface_get_stride (pSurface);
+	int x, y, iNbErrors = 0;
+	guint32 pixel;
+	for (y = 0; y < 256; y ++)
+	{
+		for (x = 0; x < 256; x ++)
+		{
+			pixel = ((const guint32 *)(pData + y * iStride))[x];
+			if (pixel != pRef[y * 256 + x])
+			{
+				if (iNbErrors ++ < 10)
+					g_print ("pixel %d;%d: %08x instead of %08x\n", x, y, pixel, pRef[y * 256 + x]);
+			}
+		}
+	}
+	cairo_surface_destroy (pSurface);
+	g_free (pRef);
+	g_free (pBuffer);
+	return (iNbErrors == 0);
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	int iResult = 0;
+	if (! _check_premultiplication ())
+	{
+		g_print ("the premultiplication differs from the float one\n");
+		iResult = 1;
+	}
+
+	int iSizes[] = {16, 32, 48, 64, 96, 128, 256, 512};
+	int iIconSize = 48;
+	guint s;
+	g_print ("%6s %16s %20s\n", "size", "surface (us)", "float premult (us)");
+	for (s = 0; s < G_N_ELEMENTS (iSizes); s ++)
+	{
+		int w = iSizes[s], iNbElements;
+		gulong *pXIconBuffer = _make_xicon_buffer (w, w, &iNbElements);
+		gulong *pBuffer = g_new (gulong, iNbElements);  // the buffer is modified by the loading, so each one works on a copy.
+		int iNbCalls;
+		gint64 t0, t;
+
+		t0 = g_get_monotonic_time ();
+		for (iNbCalls = 0; (t = g_get_monotonic_time ()) - t0 < MIN_TIME; iNbCalls ++)
+		{
+			memcpy (pBuffer, pXIconBuffer, iNbElements * sizeof (gulong));
+			cairo_surface_t *pSurface = cairo_dock_create_surface_from_xicon_buffer (pBuffer, iNbElements, iIconSize, iIconSize);
+			cairo_surface_destroy (pSurface);
+		}
+		double fSurfaceTime = (double)(t - t0) / iNbCalls;
+
+		t0 = g_get_monotonic_time ();
+		for (iNbCalls = 0; (t = g_get_monotonic_time ()) - t0 < MIN_TIME; iNbCalls ++)
+		{
+			memcpy (pBuffer, pXIconBuffer, iNbElements * sizeof (gulong));
+			_premultiply_with_floats (pBuffer + 2, (guint32 *)(pBuffer + 2), w * w);
+		}
+		double fFloatTime = (double)(t - t0) / iNbCalls;
+		g_print ("%6d %16.2f %20.2f\n", w, fSurfaceTime, fFloatTime);
+
+		g_free (pBuffer);
+		g_free (pXIconBuffer);
+	}
+	return iResult;
+}